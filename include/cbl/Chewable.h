@@ -74,6 +74,13 @@ namespace cbl
 	_TPL class Vector3;
 	_TPL class Vector4;
 
+	// Memory //
+	class Allocator;
+	class FrameArena;
+	class MemBudget;
+	class MemTracker;
+	class PageArena;
+
 	// Reflection //
 	class CblRegistrar;
 	class Deserialiser;
@@ -81,6 +88,7 @@ namespace cbl
 	class EntityManager;
 	class FieldAttr;
 	class Field;
+	class Patch;
 	class Serialiser;
 	class Type;
 	class TypeDB;
@@ -90,6 +98,7 @@ namespace cbl
 	class Runnable;
 	class Thread;
 	class ThreadData;
+	class WorkerPool;
 	
 	// Utility //
 	class ByteStream;
@@ -56,6 +56,30 @@ namespace cbl
 	/***** Threading Configurations *****/
 	//! Make Chewable thread safe.
 	#define CBL_THREAD_SAFE				CBL_DISABLED
+	//! Minimum number of parallel listeners before Event::RaiseParallel uses the worker pool.
+	#define CBL_EVENT_PARALLEL_MIN		64
+	//! Number of parallel listeners handed to a worker at a time.
+	#define CBL_EVENT_PARALLEL_BATCH	16
+
+	/***** Services Configurations *****/
+	//! Maximum number of distinct service types.
+	#define CBL_SERVICE_SLOTS			64
+
+	/***** Memory Configurations *****/
+	//! Block size of each thread's frame arena.
+	#define CBL_FRAME_ARENA_BLOCK		( 64 * 1024 )
+	//! Block size of the arena holding each TypeDB's types and field containers.
+	#define CBL_TYPEDB_ARENA_BLOCK		( 16 * 1024 )
+	//! Record per type and per tag allocation statistics in MemTracker.
+	#define CBL_MEMORY_TRACKING			CBL_DISABLED
+	//! Back object pool storage with a PageArena instead of the general heap.
+	#define CBL_POOL_PAGE_ARENA			CBL_DISABLED
+	//! Address space reserved for the pool PageArena.
+	#define CBL_POOL_ARENA_RESERVE		( 512 * 1024 * 1024 )
+	//! PageArena commit granularity. 2MB so each commit can be one huge page.
+	#define CBL_PAGE_ARENA_COMMIT		( 2 * 1024 * 1024 )
+	//! Ask for huge pages when PageArena commits memory.
+	#define CBL_PAGE_ARENA_HUGE_PAGES	CBL_ENABLED
 
 	/***** Float Point Configurations *****/
 	//! Use double floating point precision.
@@ -48,6 +48,7 @@
 // Chewable Headers //
 #include "cbl/Chewable.h"
 #include "cbl/Util/Delegate.h"
+#include "cbl/Thread/WorkerPool.h"
 
 #include <vector>
 
@@ -70,22 +71,63 @@ namespace cbl
 
 	/***** Public Methods *****/
 	public:
-		inline Event() {}
+		inline Event() : mSweep( false ) {}
 		inline ~Event() {}
 		//! Raise an event with arguments.
 		void Raise(Args... args)
 		{
-			if (mDelegates.size() > 0) {
+			if (mDelegates.size() > 0 || mParallelDelegates.size() > 0) {
 				for (size_t i = 0; i < mDelegates.size(); ++i) {
 					typename DelegateType dlg = mDelegates[i];
 					if (dlg)
 						dlg(args...);
 				}
+				for (size_t i = 0; i < mParallelDelegates.size(); ++i) {
+					typename DelegateType dlg = mParallelDelegates[i];
+					if (dlg)
+						dlg(args...);
+				}
 
 				if (mSweep)
 					Sweep();
 			}
 		}
+		//! Raise an event, fanning parallel listeners out across the worker pool.
+		//! Serial listeners run first on the calling thread. Parallel listeners
+		//! then run concurrently and all have returned when this call returns.
+		//! Parallel listeners must not register or unregister listeners on this
+		//! event, nor touch state shared with other parallel listeners.
+		//! Below CBL_EVENT_PARALLEL_MIN parallel listeners this behaves like Raise.
+		void RaiseParallel(Args... args)
+		{
+			for (size_t i = 0; i < mDelegates.size(); ++i) {
+				typename DelegateType dlg = mDelegates[i];
+				if (dlg)
+					dlg(args...);
+			}
+
+			const cbl::Uint32 count = cbl::Uint32(mParallelDelegates.size());
+			if (count < CBL_EVENT_PARALLEL_MIN) {
+				for (cbl::Uint32 i = 0; i < count; ++i) {
+					typename DelegateType dlg = mParallelDelegates[i];
+					if (dlg)
+						dlg(args...);
+				}
+			}
+			else {
+				const typename DelegateType * delegates = &mParallelDelegates[0];
+				auto job = [&](cbl::Uint32 begin, cbl::Uint32 end) {
+					for (cbl::Uint32 i = begin; i < end; ++i) {
+						if (delegates[i])
+							delegates[i](args...);
+					}
+				};
+				cbl::WorkerPool::Instance().ParallelFor(count, CBL_EVENT_PARALLEL_BATCH, job);
+			}
+
+			if (mSweep)
+				Sweep();
+		}
 		//! Raise an event with arguments using the () operator.
 		inline void operator () (Args... args)
 		{
@@ -96,6 +138,12 @@ namespace cbl
 		{
 			mDelegates.push_back(dlg);
 		}
+		//! Register a listener that may be run concurrently by RaiseParallel.
+		//! The listener must be independent of every other parallel listener.
+		inline void RegisterParallel(typename DelegateType dlg)
+		{
+			mParallelDelegates.push_back(dlg);
+		}
 
 		//! Increment operator used to register a listener function to the event.
 		inline void operator += (const typename DelegateType & dlg)
@@ -105,13 +153,8 @@ namespace cbl
 		//! Unregister a listener function from the event.
 		void Unregister(const typename DelegateType & dlg)
 		{
-			for (cbl::Uint32 i = 0; i < mDelegates.size(); ++i) {
-				if (mDelegates[i] == dlg) {
-					mDelegates[i].Reset();
-					mSweep = true;
-					break;
-				}
-			}
+			if (!Reset(mDelegates, dlg))
+				Reset(mParallelDelegates, dlg);
 		}
 		//! Decrement operator used to unregister a listener function from the event.
 		inline void operator -= (const typename DelegateType & dlg)
@@ -122,6 +165,7 @@ namespace cbl
 		inline void Clear()
 		{
 			mDelegates.clear();
+			mParallelDelegates.clear();
 			mSweep = false;
 		}
 
@@ -146,22 +190,48 @@ namespace cbl
 			return DelegateType::FromConstMethod< O, OMethod >(objectPtr);
 		}
 		
+	/***** Private Types *****/
+	private:
+		typedef std::vector<typename DelegateType> DelegateList;
+
 	/***** Private Methods *****/
 	private:
-		void Sweep()
+		//! Reset the first delegate matching dlg. Returns true if found.
+		bool Reset(DelegateList & list, const typename DelegateType & dlg)
 		{
-			for (size_t i = 0; i < mDelegates.size(); ++i) {
-				if (!mDelegates[i]) {
-					mDelegates[i] = mDelegates[mDelegates.size() - 1];
-					mDelegates.pop_back();
+			for (size_t i = 0; i < list.size(); ++i) {
+				if (list[i] == dlg) {
+					list[i].Reset();
+					mSweep = true;
+					return true;
+				}
+			}
+			return false;
+		}
+		static void Sweep(DelegateList & list)
+		{
+			for (size_t i = 0; i < list.size(); ) {
+				if (!list[i]) {
+					list[i] = list[list.size() - 1];
+					list.pop_back();
+				}
+				else {
+					++i;
 				}
 			}
 		}
+		void Sweep()
+		{
+			Sweep(mDelegates);
+			Sweep(mParallelDelegates);
+			mSweep = false;
+		}
 
 	/***** Private Members *****/
 	private:
-		std::vector<typename DelegateType> mDelegates;
-		bool                               mSweep;
+		DelegateList	mDelegates;			//!< Listeners raised on the calling thread.
+		DelegateList	mParallelDelegates;	//!< Listeners RaiseParallel may run concurrently.
+		bool			mSweep;				//!< Set when listeners were unregistered.
 	};
 }
 
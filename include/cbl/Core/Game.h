@@ -36,6 +36,7 @@
 #include "cbl/Core/GameTime.h"
 #include "cbl/Core/ObjectManager.h"
 #include "cbl/Core/GameStateManager.h"
+#include "cbl/Memory/FrameArena.h"
 
 namespace cbl
 {
@@ -75,8 +76,9 @@ namespace cbl
 	/***** Public Methods *****/
 	public:
 		//! Constructor.
-		//! @param	name	Game name.
-		explicit Game( const Char* name );
+		//! @param	name		Game name.
+		//! @param	allocator	Allocator for the object and state tables.
+		explicit Game( const Char* name, Allocator& allocator = Allocator::GetDefault() );
 		//!  Destructor.
 		virtual ~Game();
 		//!  Start the game application.
@@ -84,6 +86,7 @@ namespace cbl
 		//!  End the game application.
 		void Exit( void );
 		//! Add an IUpdatable object to the game.
+		//! Use GameState::AddUpdatable instead to have it skipped while the state is paused.
 		void AddUpdatable( IUpdatable * updatable );
 		//! Remove an IUpdatable object from the game.
 		void RemoveUpdatable( IUpdatable * updatable );
@@ -116,17 +119,6 @@ namespace cbl
 		//! Ends the drawing of a frame. This method is preceeded by calls to Draw and BeginDraw.
 		virtual void EndDraw( void );
 
-	/***** Events *****/
-	public:
-		//! OnComponentAdded event handler.
-		void OnComponentAdded( GameComponent * updatable );
-		//! OnComponentRemoved event handler.
-		void OnComponentRemoved( GameComponent * updatable );
-		//! OnDrawableAdded event handler.
-		void OnDrawableAdded( DrawableGameComponent * drawable );
-		//! OnDrawableRemoved event handler.
-		void OnDrawableRemoved( DrawableGameComponent * drawable );
-
 	/***** Private Methods *****/
 	private:
 		//!  Updates the game's clock and calls Update and Draw.
@@ -146,8 +138,9 @@ namespace cbl
 
 		typedef VectorSet<IUpdatable*>		UpdatableList;
 		typedef VectorSet<IDrawable*>		DrawableList;
-		typedef std::vector<IUpdatable*>	UpdatableRunList;
-		typedef std::vector<IDrawable*>		DrawableRunList;
+		typedef FrameVector<IUpdatable*>::Type	UpdatableRunList;	//!< Per-step list, in frame memory.
+		typedef FrameVector<IDrawable*>::Type	DrawableRunList;	//!< Per-draw list, in frame memory.
+		typedef std::vector<GameState*>		StateRunList;
 
 	/***** Private Static Members *****/
 	private:
@@ -155,10 +148,9 @@ namespace cbl
 
 	/***** Private Members *****/
 	private:
-		UpdatableList		mUpdatables;			//!< Update list.
-		DrawableList		mDrawables;				//!< Drawable list.
-		UpdatableRunList	mUpdatableRuns;			//!< Update run list.
-		DrawableRunList		mDrawableRuns;			//!< Draw run list.
+		UpdatableList		mUpdatables;			//!< Updatables added through AddUpdatable (components live in Components).
+		DrawableList		mDrawables;				//!< Drawables added through AddDrawable (components live in Components).
+		StateRunList		mStateRuns;				//!< States whose partitions run this frame.
 		String				mName;					//!< Game name.
 		GameTime			mGameTime;				//!< Current application time.
 		GameTime			mDrawTime;				//!< Current draw time.
@@ -61,6 +61,13 @@ namespace cbl
 		virtual void Shutdown( void ) = 0;
 		//! Pure virtual update function (from IUpdatable).
 		virtual void Update( const GameTime & time ) = 0;
+
+	/***** Private Members *****/
+	private:
+		friend class	GameComponentCollection;	//!< Befriend the collection to manage slots.
+
+		Uint32			mSlot;		//!< Update slot in the owning collection.
+		Uint32			mDrawSlot;	//!< Draw slot in the owning collection (drawable components only).
 	};
 }
 
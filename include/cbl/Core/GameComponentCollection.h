@@ -30,7 +30,8 @@
 #include "cbl/Core/Event.h"
 
 // External Dependencies //
-#include <list>
+#include <vector>
+#include <iterator>
 
 namespace cbl
 {
@@ -46,24 +47,61 @@ namespace cbl
 	//! GameComponent::OnComponentAdded and GameComponent::OnComponentRemoved are called respectively when
 	//! a game component object is added to and removed from the container and the local GameComponentCollection.OnComponentAdded
 	//! and GameComponentCollection.OnComponentRemoved events are raised.
+	//!
+	//! Components are kept in a contiguous array sorted by UpdateOrder, and drawable components in a
+	//! second array sorted by DrawOrder. Each component stores its slot so removal only clears the slot;
+	//! cleared slots are skipped during iteration and compacted away by the next call to Sort. This keeps
+	//! indices and iterators stable while components are removed mid-update. A component may only
+	//! belong to one collection at a time.
 	class CBL_API GameComponentCollection :
 		Noncopyable
 	{
-	/***** Private Types *****/
-	private:
-		//! Game component sort predicate.
-		struct GameComponentSort {
-			bool operator () ( GameComponent* lhs, GameComponent* rhs ) {
-				return lhs->UpdateOrder < rhs->UpdateOrder;
-			}
-		};
 	/***** Types *****/
 	public:
-		typedef std::list< GameComponent * >					ComponentList;			//!< Component list type.
-		typedef ComponentList::iterator							iterator;				//!< List iterator.
-		typedef ComponentList::const_iterator					const_iterator;			//!< List const iterator.
-		typedef ComponentList::reverse_iterator					reverse_iterator;		//!< List iterator.
-		typedef ComponentList::const_reverse_iterator			const_reverse_iterator;	//!< List const iterator.
+		typedef std::vector< GameComponent * >					ComponentList;			//!< Component list type.
+		typedef std::vector< DrawableGameComponent * >			DrawableList;			//!< Drawable component list type.
+
+		//! Iterator over the live slots of the component list, skipping removed slots.
+		class CBL_API SlotIterator
+		{
+		public:
+			typedef std::bidirectional_iterator_tag		iterator_category;
+			typedef GameComponent *						value_type;
+			typedef std::ptrdiff_t						difference_type;
+			typedef GameComponent * const *				pointer;
+			typedef GameComponent * const &				reference;
+
+			SlotIterator() : mCur( NULL ), mBegin( NULL ), mEnd( NULL ) {}
+			SlotIterator( pointer cur, pointer begin, pointer end ) : mCur( cur ), mBegin( begin ), mEnd( end ) {
+				while( mCur != mEnd && !*mCur ) ++mCur;
+			}
+			inline reference operator * ( void ) const { return *mCur; }
+			inline pointer operator -> ( void ) const { return mCur; }
+			inline SlotIterator & operator ++ ( void ) {
+				do { ++mCur; } while( mCur != mEnd && !*mCur );
+				return *this;
+			}
+			inline SlotIterator operator ++ ( int ) { SlotIterator tmp( *this ); ++( *this ); return tmp; }
+			inline SlotIterator & operator -- ( void ) {
+				do { --mCur; } while( mCur != mBegin && !*mCur );
+				return *this;
+			}
+			inline SlotIterator operator -- ( int ) { SlotIterator tmp( *this ); --( *this ); return tmp; }
+			inline bool operator == ( const SlotIterator & rhs ) const { return mCur == rhs.mCur; }
+			inline bool operator != ( const SlotIterator & rhs ) const { return mCur != rhs.mCur; }
+
+		private:
+			pointer		mCur;	//!< Current slot.
+			pointer		mBegin;	//!< First slot.
+			pointer		mEnd;	//!< One past the last slot.
+		};
+
+		typedef SlotIterator									iterator;				//!< List iterator.
+		typedef SlotIterator									const_iterator;			//!< List const iterator.
+		typedef std::reverse_iterator< SlotIterator >			reverse_iterator;		//!< List iterator.
+		typedef std::reverse_iterator< SlotIterator >			const_reverse_iterator;	//!< List const iterator.
+
+		static const Uint32		InvalidSlot = 0xFFFFFFFF;	//!< Slot of a component not in a collection.
 
 	/***** Events *****/
 	public:
@@ -86,19 +124,37 @@ namespace cbl
 		//! Local OnDrawableAdded event is raised.
 		//! @param	component	Drawable component to add.
 		void Add( DrawableGameComponent * const component, bool init = false );
-		//! @brief Remove a component from the collection.
+		//! @brief Remove a component from the collection in constant time.
 		//! Local OnComponentRemoved event is raised.
 		//! @param	component	Component to remove.
 		void Remove( GameComponent * const component, bool shutdown = false );
-		//! @brief Remove a drawable component to the collection.
+		//! @brief Remove a drawable component to the collection in constant time.
 		//! Local OnDrawableRemoved event is raised.
 		//! @param	component	Drawable component to remove.
 		void Remove( DrawableGameComponent * const component, bool shutdown = false );
+		//! @brief Compact removed slots and restore UpdateOrder/DrawOrder sorting.
+		//! Only does work if something was removed or an order changed since the last call.
+		//! Must not be called while iterating over slots.
+		void Sort( void );
 		//! @brief Clear the component collection of all components.
 		void clear( void );
 		//! Component list size.
 		//! @return	Size of the component collection.
 		const size_t size( void ) const;
+		//! Get the number of update slots, including removed ones.
+		//! @return	Update slot count.
+		Uint32 GetSlotCount( void ) const;
+		//! Get the component in an update slot.
+		//! @param	slot	Slot index, sorted by UpdateOrder as of the last Sort.
+		//! @return			Component, or NULL if the slot has been removed.
+		GameComponent * GetSlot( Uint32 slot ) const;
+		//! Get the number of draw slots, including removed ones.
+		//! @return	Draw slot count.
+		Uint32 GetDrawSlotCount( void ) const;
+		//! Get the drawable component in a draw slot.
+		//! @param	slot	Slot index, sorted by DrawOrder as of the last Sort.
+		//! @return			Drawable component, or NULL if the slot has been removed.
+		DrawableGameComponent * GetDrawSlot( Uint32 slot ) const;
 		//! Reverse begin component collection iterator.
 		//! @return	Component collection reverse begin iterator.
 		reverse_iterator rbegin( void );
@@ -123,10 +179,20 @@ namespace cbl
 		//! End component collection constant iterator.
 		//! @return	Component collection end const iterator.
 		const_iterator end( void ) const;
-		
+
+	/***** Private Methods *****/
+	private:
+		//! Clear a component's update slot.
+		void ClearSlot( GameComponent * const component );
+		//! Clear a drawable component's draw slot.
+		void ClearDrawSlot( DrawableGameComponent * const component );
+
 	/***** Private Members *****/
 	private:
-		ComponentList		mComponentList;	//!< Internal component list.
+		ComponentList		mComponentList;		//!< Components sorted by UpdateOrder.
+		DrawableList		mDrawableList;		//!< Drawable components sorted by DrawOrder.
+		Uint32				mRemoved;			//!< Number of cleared update slots.
+		Uint32				mDrawRemoved;		//!< Number of cleared draw slots.
 	};
 }
 
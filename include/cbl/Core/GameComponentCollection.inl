@@ -26,46 +26,69 @@ namespace cbl
 	/***** Inline Methods *****/
 	inline const size_t GameComponentCollection::size( void ) const
 	{
-		return mComponentList.size();
+		return mComponentList.size() - mRemoved;
+	}
+
+	inline Uint32 GameComponentCollection::GetSlotCount( void ) const
+	{
+		return Uint32( mComponentList.size() );
+	}
+
+	inline GameComponent * GameComponentCollection::GetSlot( Uint32 slot ) const
+	{
+		return mComponentList[ slot ];
+	}
+
+	inline Uint32 GameComponentCollection::GetDrawSlotCount( void ) const
+	{
+		return Uint32( mDrawableList.size() );
+	}
+
+	inline DrawableGameComponent * GameComponentCollection::GetDrawSlot( Uint32 slot ) const
+	{
+		return mDrawableList[ slot ];
 	}
 
 	inline GameComponentCollection::const_reverse_iterator GameComponentCollection::rbegin( void ) const
 	{
-		return mComponentList.rbegin();
+		return const_reverse_iterator( end() );
 	}
 
 	inline GameComponentCollection::const_iterator GameComponentCollection::begin( void ) const
 	{
-		return mComponentList.begin();
+		const SlotIterator::pointer first = mComponentList.empty() ? NULL : &mComponentList[0];
+		return SlotIterator( first, first, first + mComponentList.size() );
 	}
 
 	inline GameComponentCollection::reverse_iterator GameComponentCollection::rbegin( void )
 	{
-		return mComponentList.rbegin();
+		return reverse_iterator( end() );
 	}
 
 	inline GameComponentCollection::iterator GameComponentCollection::begin( void )
 	{
-		return mComponentList.begin();
+		return static_cast< const GameComponentCollection * >( this )->begin();
 	}
 	
 	inline GameComponentCollection::const_reverse_iterator GameComponentCollection::rend( void ) const
 	{
-		return mComponentList.rend();
+		return const_reverse_iterator( begin() );
 	}
 	
 	inline GameComponentCollection::const_iterator GameComponentCollection::end( void ) const
 	{
-		return mComponentList.end();
+		const SlotIterator::pointer first = mComponentList.empty() ? NULL : &mComponentList[0];
+		const SlotIterator::pointer last = first + mComponentList.size();
+		return SlotIterator( last, first, last );
 	}
 	
 	inline GameComponentCollection::reverse_iterator GameComponentCollection::rend( void )
 	{
-		return mComponentList.rend();
+		return reverse_iterator( begin() );
 	}
 	
 	inline GameComponentCollection::iterator GameComponentCollection::end( void )
 	{
-		return mComponentList.end();
+		return static_cast< const GameComponentCollection * >( this )->end();
 	}
 }
@@ -28,24 +28,46 @@
 #include "cbl/Chewable.h"
 #include "cbl/Util/Property.h"
 #include "cbl/Util/Noncopyable.h"
+#include "cbl/Util/VectorSet.h"
 #include "cbl/Reflection/Entity.h"
 
+// External Dependencies //
+#include <atomic>
+
 namespace cbl
 {
 	//! Abstract game state class.
+	//! A state owns a partition of updatables, drawables and objects. Game skips
+	//! the whole partition while the state is paused or inactive.
 	class CBL_API GameState :
 		public Entity,
 		Noncopyable
 	{
+	/***** Types *****/
+	public:
+		typedef VectorSet<IUpdatable*>	UpdatableList;
+		typedef VectorSet<IDrawable*>	DrawableList;
+		typedef VectorSet<Object*>		ObjectList;
+
 	/***** Properties *****/
 	public:
 		GETTER_AUTO( bool, Active );
 		GETTER_AUTO( bool, Paused );
+		GETTER_AUTO_CREF( UpdatableList, Updatables );	//!< Updatables owned by this state.
+		GETTER_AUTO_CREF( DrawableList, Drawables );	//!< Drawables owned by this state.
+		GETTER_AUTO_CREF( ObjectList, Objects );		//!< Objects owned by this state.
+		//! Check if the state's partition is updated and drawn.
+		inline bool IsRunning( void ) const { return mActive && !mPaused; }
 
 	/***** Public Methods *****/
 	public:
 		//! Destructor.
 		virtual ~GameState();
+		//! Called on a background thread when the state is preloaded.
+		//! Load assets here so that Activate has little left to do.
+		//! Must not touch systems that aren't thread safe, e.g. the entity manager.
+		//! @see GameStateManager::PreloadState
+		virtual void Preload( void ) {}
 		//! Called when state is added/pushed.
 		virtual void Activate( void ) {}
 		//! Called when state is removed/popped.
@@ -66,16 +88,38 @@ namespace cbl
 		//! Called after the entity is saved.
 		//! e.g. After serialisation.
 		virtual void OnSaved( void ) const;
+		//! Get the preload progress, from 0 to 1.
+		Real GetLoadProgress( void ) const;
+		//! Add an updatable to this state's partition.
+		void AddUpdatable( IUpdatable* updatable );
+		//! Remove an updatable from this state's partition.
+		void RemoveUpdatable( IUpdatable* updatable );
+		//! Add a drawable to this state's partition.
+		void AddDrawable( IDrawable* drawable );
+		//! Remove a drawable from this state's partition.
+		void RemoveDrawable( IDrawable* drawable );
+		//! Take ownership of an object. Objects belong to at most one state.
+		//! While this state isn't running, owned objects report themselves dormant and are
+		//! left out of ObjectManager::GetLiveObjects.
+		void AddObject( Object* object );
+		//! Release an owned object.
+		void RemoveObject( Object* object );
 		
 	/***** Protected Methods *****/
 	protected:
 		//! Constructor.
 		GameState();
+		//! Report preload progress, from 0 to 1. Safe to call from Preload.
+		void SetLoadProgress( Real progress );
 		
 	/***** Private Members *****/
 	private:
 		bool			mActive;
 		bool			mPaused;
+		std::atomic< Real >	mLoadProgress;	//!< Preload progress, written by the loading thread.
+		UpdatableList	mUpdatables;
+		DrawableList	mDrawables;
+		ObjectList		mObjects;
 		friend class	GameStateManager;
 		friend class	TypeDB;
 	};
@@ -31,10 +31,13 @@
 #include "cbl/Util/Noncopyable.h"
 #include "cbl/Util/Hash.h"
 #include "cbl/Util/Singleton.h"
+#include "cbl/Memory/Allocator.h"
 
 // External Dependencies //
 #include <stack>
 #include <map>
+#include <thread>
+#include <atomic>
 
 namespace cbl
 {
@@ -45,7 +48,8 @@ namespace cbl
 	/***** Public Methods *****/
 	public:
 		//! Constructor.
-		GameStateManager();
+		//! @param	allocator	Allocator for the state stack and tables.
+		explicit GameStateManager( Allocator& allocator = Allocator::GetDefault() );
 		//! Destructor.
 		~GameStateManager();
 		//! Push state to stack.
@@ -57,6 +61,30 @@ namespace cbl
 		void Push( const CName& type );
 		//! Pop state from stack.
 		void Pop( void );
+		//! Create a state and run its Preload on a background thread.
+		//! A later Push of the same type takes the preloaded state instead of creating one.
+		//! @tparam	STATE_TYPE	State type.
+		template< typename STATE_TYPE >
+		void PreloadState( void );
+		//! Create a state and run its Preload on a background thread.
+		//! @param	type		State type.
+		void PreloadState( const CName& type );
+		//! Check if a preloaded state has finished loading.
+		//! @tparam	STATE_TYPE	State type.
+		template< typename STATE_TYPE >
+		bool IsPreloaded( void ) const;
+		//! Check if a preloaded state has finished loading.
+		//! @param	type		State type.
+		bool IsPreloaded( const CName& type ) const;
+		//! Get preload progress of a state.
+		//! @tparam	STATE_TYPE	State type.
+		//! @return				Progress from 0 to 1, or 0 if the state isn't being preloaded.
+		template< typename STATE_TYPE >
+		Real GetPreloadProgress( void ) const;
+		//! Get preload progress of a state.
+		//! @param	type		State type.
+		//! @return				Progress from 0 to 1, or 0 if the state isn't being preloaded.
+		Real GetPreloadProgress( const CName& type ) const;
 		//! Add persistent state.
 		//! @tparam	STATE_TYPE	State type.
 		//! @param	name		State name.
@@ -78,6 +106,10 @@ namespace cbl
 		//! @param	name		State name.
 		//! @return				Game state, NULL if doesn't exist.
 		GameState* Get( const Hash& name ) const;
+		//! Get the states whose partitions should run this frame.
+		//! Paused and inactive states are skipped without touching their contents.
+		//! @param	states		Cleared and filled with running states, stack states first.
+		void GetRunningStates( std::vector<GameState*>& states ) const;
 		//! Initialise and purge states.
 		void Update( void );
 		//! Clear all stack and persistent states.
@@ -89,13 +121,27 @@ namespace cbl
 		static void DeactivateState( GameState* state );
 		static void ResumeState( GameState* state );
 		static void PauseState( GameState* state );
+		static void PreloadMain( GameState* state, std::atomic< bool >* done );
+
+		//! State being loaded in the background.
+		struct Preload
+		{
+			GameState*				State;		//!< Preloading state.
+			std::thread				Worker;		//!< Loading thread.
+			std::atomic< bool >		Done;		//!< Set once State->Preload has returned.
+		};
 
 		typedef void (*StateFunction)( GameState* );
 		typedef std::pair<GameState*,StateFunction>		StateAction;
 
-		typedef std::unordered_map<Hash, GameState*>	StateMap;
-		typedef std::vector<GameState*>					StateArray;
-		typedef std::vector<StateAction>				StateActions;
+		typedef AllocUnorderedMap<Hash, GameState*>::Type	StateMap;
+		typedef AllocVector<GameState*>::Type				StateArray;
+		typedef AllocVector<StateAction>::Type				StateActions;
+		typedef AllocUnorderedMap<CName, Preload*>::Type	PreloadMap;
+
+		//! Wait for a preload to finish and release its state.
+		//! @return				Preloaded state, or NULL if the type isn't being preloaded.
+		GameState* TakePreload( const CName& type );
 		
 	/***** Private Members *****/
 	private:
@@ -103,6 +149,7 @@ namespace cbl
 		StateArray			mStateStack;	//!< Current state stack.
 		StateArray			mToDelete;		//!< States to delete.
 		StateMap			mStates;		//!< Existing persistent states.
+		PreloadMap			mPreloads;		//!< States being loaded in the background.
 
 		friend class		Game;
 	};
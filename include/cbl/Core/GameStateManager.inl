@@ -31,6 +31,26 @@ namespace cbl
 		Push( TypeCName<GAMESTATE_TYPE>() );
 	}
 
+	template< typename GAMESTATE_TYPE >
+	inline void GameStateManager::PreloadState( void )
+	{
+		// Force a compile-time type test.
+		CBL_ENTITY_TYPETEST( GameState, GAMESTATE_TYPE );
+		PreloadState( TypeCName<GAMESTATE_TYPE>() );
+	}
+
+	template< typename GAMESTATE_TYPE >
+	inline bool GameStateManager::IsPreloaded( void ) const
+	{
+		return IsPreloaded( TypeCName<GAMESTATE_TYPE>() );
+	}
+
+	template< typename GAMESTATE_TYPE >
+	inline Real GameStateManager::GetPreloadProgress( void ) const
+	{
+		return GetPreloadProgress( TypeCName<GAMESTATE_TYPE>() );
+	}
+
 	template< typename GAMESTATE_TYPE >
 	void GameStateManager::Add( const Hash& name )
 	{
@@ -52,10 +52,13 @@ namespace cbl
 		GETTER_AUTO( ObjectID, ID );			//!< Get object's ID.
 		GETTER_AUTO( bool, Initialised );		//!< Get object initialised.
 		GETTER_AUTO_CREF( GroupNames, Groups );	//!< Get object groups.
+		GETTER_AUTO_PTR( GameState, Owner );	//!< Get owning game state (NULL if unowned).
 		//! Get object's name.
 		inline const String& GetName( void ) const { return mName.GetText(); }
 		//! Get object's hashed name value.
 		inline HashValue GetHashValue( void ) const { return mName.GetHash(); }
+		//! Check if the object's owning state is paused or inactive.
+		bool IsDormant( void ) const;
 
 	/***** Public Members *****/
 	public:
@@ -99,11 +102,13 @@ namespace cbl
 		Hash			mName;				//!< Name. Set when object factory instantiates this object.
 		PartList		mParts;				//!< Actual object part list.
 		GroupNames		mGroups;			//!< Object's groups.
+		GameState*		mOwner;				//!< Owning game state.
 		friend class	CblRegistrar;		//!< Befriend the registrar.
 		friend class	ObjectManager;		//!< Befriend object factory.
 		friend class	ObjectGroups;		//!< Befriend object groups.
 		friend class	TypeDB;				//!< Befriend the type DB.
 		friend class	EntityManager;		//!< Befriend the entity manager.
+		friend class	GameState;			//!< Befriend the owning state.
 	};
 }
 
@@ -28,6 +28,7 @@
 #include "cbl/Chewable.h"
 #include "cbl/Util/Noncopyable.h"
 #include "cbl/Util/Hash.h"
+#include "cbl/Memory/Allocator.h"
 
 // External Libraries //
 #include <unordered_map>
@@ -36,7 +37,7 @@
 namespace cbl
 {
 	/***** Types *****/
-	typedef std::vector<Uint32>	ObjectIDList;	//!< Group name (hash) list.
+	typedef AllocVector<Uint32>::Type	ObjectIDList;	//!< Group name (hash) list.
 
 	//! Object grouping system.
 	//! New objects added from the ObjectManager are automatically added to the default group (sDefaultGroupName).
@@ -51,7 +52,8 @@ namespace cbl
 	/***** Public Methods *****/
 	public:
 		//! Constructor.
-		ObjectGroups();
+		//! @param	allocator	Allocator for the group table and the group lists.
+		explicit ObjectGroups( Allocator& allocator = Allocator::GetDefault() );
 		//! Destructor.
 		~ObjectGroups();
 		//! Add object to group by name.
@@ -81,7 +83,12 @@ namespace cbl
 
 	/***** Private Types *****/
 	private:
-		typedef std::unordered_map<Hash, ObjectIDList> GroupTable;	//!< Object group table.
+		typedef AllocUnorderedMap<Hash, ObjectIDList>::Type GroupTable;	//!< Object group table.
+
+	/***** Private Methods *****/
+	private:
+		//! Find a group, creating it if it does not exist.
+		GroupTable::iterator _GetGroup( const Hash& groupName ) const;
 
 	/***** Private Members *****/
 	private:
@@ -29,11 +29,13 @@
 #include "cbl/Core/Object.h"
 #include "cbl/Core/Services.h"
 #include "cbl/Core/ObjectGroups.h"
+#include "cbl/Memory/Allocator.h"
 #include "cbl/Util/Hash.h"
 #include "cbl/Util/SharedPtr.h"
 #include "cbl/Util/WeakPtr.h"
 #include "cbl/Util/Noncopyable.h"
 #include "cbl/Util/Singleton.h"
+#include "cbl/Util/VectorSet.h"
 #include "cbl/Serialisation/BinaryDeserialiser.h"
 #include "cbl/Serialisation/BinarySerialiser.h"
 
@@ -43,6 +45,9 @@
 
 namespace cbl
 {
+	/***** Forward Declarations *****/
+	class GameState;
+
 	/***** Types *****/
 	typedef Object * ObjectPtr;
 
@@ -55,7 +60,10 @@ namespace cbl
 		typedef ObjectChange ObjectDestroy;
 	}
 
-	//! Object manager. 
+	//! Object manager.
+	//! Objects are partitioned by owning game state (see GameState::AddObject). Unowned
+	//! objects are kept in a list of their own, so GetLiveObjects skips the objects of a
+	//! paused or inactive state with one check per state.
 	class CBL_API ObjectManager :
 		Noncopyable
 	{
@@ -76,7 +84,8 @@ namespace cbl
 	/***** Public Methods *****/
 	public:
 		//! Constructor.
-		ObjectManager();
+		//! @param	allocator	Allocator for the object tables.
+		explicit ObjectManager( Allocator& allocator = Allocator::GetDefault() );
 		//! Destructor.
 		~ObjectManager();
 		//! Create an uninitialised object (used for custom object manipulation before initialisation).
@@ -169,11 +178,18 @@ namespace cbl
 		//! Deserialises a single object from a dserialiser.
 		template< typename OBJECT_TYPE >
 		OBJECT_TYPE* DeserialiseObject( Deserialiser& deserialiser, bool init = true );
+		//! Gather the objects to process this frame: unowned objects, then the objects of
+		//! running states. States that are paused or inactive are skipped as a whole.
+		//! @param	objects		Receives the objects. Cleared first.
+		void GetLiveObjects( std::vector<ObjectPtr>& objects ) const;
+		//! Get the objects not owned by any game state.
+		inline const VectorSet<ObjectPtr>& GetUnownedObjects( void ) const { return mUnowned; }
 
 	/***** Object Iteration Methods *****/
 	public:
-		typedef std::unordered_map<CName,Uint32>::iterator					iterator;
-		typedef std::unordered_map<CName,Uint32>::const_iterator			const_iterator;
+		typedef AllocUnorderedMap<CName,Uint32>::Type	ObjectNameTable;
+		typedef ObjectNameTable::iterator				iterator;
+		typedef ObjectNameTable::const_iterator			const_iterator;
 
 		inline iterator begin( void ) { return mObjectNameTable.begin(); }
 		inline iterator end( void ) { return mObjectNameTable.end(); }
@@ -193,18 +209,30 @@ namespace cbl
 		//! Called when an object has changed internally.
 		void PostRename( ObjectPtr obj );
 
+	/***** Private Methods *****/
+	private:
+		//! Move an object to the partition of its current owner.
+		//! @param	obj			Object whose owner changed.
+		//! @param	oldOwner	Previous owner, NULL if it was unowned.
+		void _Reown( ObjectPtr obj, GameState* oldOwner );
+		//! Take an object out of its partition before it is deleted.
+		void _Detach( ObjectPtr obj );
+
 	/***** Private Members *****/
 	private:
-		typedef std::vector<ObjectPtr>				ObjectList;
-		typedef std::vector<Uint32>					IDList;
-		typedef std::unordered_map<CName,Uint32>	ObjectNameTable;
+		typedef AllocVector<ObjectPtr>::Type		ObjectList;
+		typedef AllocVector<Uint32>::Type			IDList;
+		typedef AllocUnorderedMap<GameState*,Uint32>::Type	PartitionTable;
 		bool				mDestroyAll;		//!< Destroy all objects?
 		ObjectList			mObjectList;		//!< Full object list.
 		ObjectNameTable		mObjectNameTable;	//!< Object name to ID table.
 		IDList				mUnusedIDs;			//!< Unused object ID list.
 		IDList				mObjectsToDestroy;	//!< Objects to destroy.
+		VectorSet<ObjectPtr>	mUnowned;		//!< Objects not owned by a game state.
+		PartitionTable		mPartitions;		//!< Owning states, with how many of our objects each holds.
 		friend class		Game;
 		friend class		Object;
+		friend class		GameState;
 	};
 
 	//! Binary object deserialiser.
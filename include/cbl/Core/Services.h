@@ -28,29 +28,33 @@
 #include "cbl/Chewable.h"
 #include "cbl/Util/Noncopyable.h"
 #include "cbl/Util/Hash.h"
+#include "cbl/Util/CName.h"
 #include "cbl/Util/Singleton.h"
 #include "cbl/Debug/Assert.h"
 
 // External Libraries //
-#include <unordered_map>
+#include <atomic>
 
 namespace cbl
 {
+	template< typename SERVICE_TYPE > class ServiceRef;
+
 	//! Services provide registration and retrieval of game services.
-	//! They stored and accessible through a unique hashed string ID.
+	//! Every service type is given a process-wide slot index the first time it is used,
+	//! so lookups are a single array index rather than a hashed search.
 	//! 
 	//! Usage:
 	//! @code
 	//! class TheService
 	//! {
-	//! public:
-	//!     CBL_SERVICE_TYPE( TheService );  // Declare a service type for TheService.
 	//! };
+	//! CBL_TYPE( TheService, TheService );	// Service types need a type name.
 	//! 
 	//! TheService		      object;
 	//! 
 	//! cbl::Services::Instance().Add< TheService >( &object ); // services.Add( &object ); works as well.
-	//! TheService * getService = cbl::Services::Instance().Find< TheService >(); // Returns NULL if service is not found.
+	//! TheService * getService = cbl::Services::Instance().Get< TheService >(); // Returns NULL if service is not found.
+	//! cbl::ServiceRef< TheService > ref = services.GetRef< TheService >(); // Cached handle, valid across Add/Remove.
 	//! cbl::Services::Instance().Remove< TheService >(); // Service is now removed.
 	//! @endcode
 	class CBL_API Services : 
@@ -58,30 +62,73 @@ namespace cbl
 	{
 	/***** Types *****/
 	public:
-		typedef std::unordered_map<CName,void*>	ServiceMap;		//!< Service table type.
+		typedef std::atomic< void* >	ServiceSlot;	//!< Storage for a single service.
+
+	/***** Public Static Methods *****/
+	public:
+		//! Get the slot index for a service type, allocating one on first use.
+		//! Slots are keyed on type name so they agree across module boundaries.
+		//! @param	type	Service type name.
+		//! @return			Slot index.
+		static Uint32 GetSlotIndex( const CName& type );
+		//! Get the slot index for a service type.
+		template< typename SERVICE_TYPE >
+		static Uint32 SlotIndex( void );
 
 	/***** Public Methods *****/
 	public:
+		//! Default constructor.
+		Services();
 		//! Add service to container.
-		//! @see CBL_SERVICE_TYPE
-		//! @param	type	Service class type.
 		//! @param	service	Service to object add.
 		template< typename SERVICE_TYPE >
 		void Add( SERVICE_TYPE* service );
 		//! Remove service from container.
-		//! @param	type	Service class type.
 		template< typename SERVICE_TYPE >
 		void Remove( void );
 		//! Get service from container.
-		//! @tparam	T		Type to return.
-		//! @param	type	Type to search for.
-		//! @return			Pointer to object of type T or NULL if service doesn't exist.
+		//! @tparam	SERVICE_TYPE	Type to return.
+		//! @return					Pointer to object of type SERVICE_TYPE or NULL if service doesn't exist.
 		template< typename SERVICE_TYPE >
 		SERVICE_TYPE* Get( void ) const;
+		//! Get a cached handle to a service.
+		//! The handle stays valid while this container lives, and sees later Add/Remove calls.
+		//! @tparam	SERVICE_TYPE	Service type.
+		//! @return					Service handle.
+		template< typename SERVICE_TYPE >
+		ServiceRef< SERVICE_TYPE > GetRef( void ) const;
+
+	/***** Private Members *****/
+	private:
+		ServiceSlot				mSlots[CBL_SERVICE_SLOTS];	//!< Services indexed by slot.
+	};
+
+	//! Cached handle to a service slot.
+	//! Reads are atomic, so a handle may be read from worker threads while
+	//! the service is being added or removed on the main thread.
+	template< typename SERVICE_TYPE >
+	class ServiceRef
+	{
+	/***** Public Methods *****/
+	public:
+		//! Default constructor; refers to no service.
+		ServiceRef() : mSlot( NULL ) {}
+		//! Get the service.
+		//! @return		Service, or NULL if it is not currently registered.
+		SERVICE_TYPE* Get( void ) const;
+		//! Check if the handle refers to a service slot.
+		bool IsBound( void ) const { return mSlot != NULL; }
+		//! Access the service.
+		SERVICE_TYPE* operator -> ( void ) const { return Get(); }
+
+	/***** Private Methods *****/
+	private:
+		friend class Services;
+		explicit ServiceRef( const Services::ServiceSlot* slot ) : mSlot( slot ) {}
 
 	/***** Private Members *****/
 	private:
-		ServiceMap				mServices;	//!< List of services.
+		const Services::ServiceSlot*	mSlot;	//!< Referenced slot.
 	};
 }
 
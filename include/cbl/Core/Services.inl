@@ -26,27 +26,46 @@
 namespace cbl
 {
 	/***** Template definitions *****/
+	template< typename SERVICE_TYPE >
+	inline Uint32 Services::SlotIndex( void )
+	{
+		static const Uint32 sIndex = GetSlotIndex( TypeCName<SERVICE_TYPE>() );
+		return sIndex;
+	}
+
 	template< typename SERVICE_TYPE >
 	void Services::Add( SERVICE_TYPE* service )
 	{
 		CBL_ASSERT_TRUE( service );
-		CBL_ASSERT( mServices.find( TypeCName<SERVICE_TYPE>() ) == mServices.end(), "Service type already exists." );
+		ServiceSlot& slot = mSlots[ SlotIndex<SERVICE_TYPE>() ];
+		CBL_ASSERT( slot.load( std::memory_order_relaxed ) == NULL, "Service type already exists." );
 
-		mServices.insert( std::make_pair( TypeCName<SERVICE_TYPE>(), static_cast< void * >( service ) ) );
+		slot.store( static_cast< void * >( service ), std::memory_order_release );
 	}
 	
 	template< typename SERVICE_TYPE >
 	void Services::Remove()
 	{
-		ServiceMap::iterator eraseIt = mServices.find( TypeCName<SERVICE_TYPE>() );
-		CBL_ASSERT( eraseIt != mServices.end(), "Service type does not exist!" );
-		mServices.erase( eraseIt );
+		ServiceSlot& slot = mSlots[ SlotIndex<SERVICE_TYPE>() ];
+		CBL_ASSERT( slot.load( std::memory_order_relaxed ) != NULL, "Service type does not exist!" );
+		slot.store( NULL, std::memory_order_release );
 	}
 
 	template< typename SERVICE_TYPE >
 	inline SERVICE_TYPE* Services::Get( void ) const
 	{
-		ServiceMap::const_iterator findIt = mServices.find( TypeCName<SERVICE_TYPE>() );
-		return findIt != mServices.end() ? static_cast< SERVICE_TYPE * >( findIt->second ) : NULL;
+		return static_cast< SERVICE_TYPE * >( mSlots[ SlotIndex<SERVICE_TYPE>() ].load( std::memory_order_acquire ) );
+	}
+
+	template< typename SERVICE_TYPE >
+	inline ServiceRef< SERVICE_TYPE > Services::GetRef( void ) const
+	{
+		return ServiceRef< SERVICE_TYPE >( &mSlots[ SlotIndex<SERVICE_TYPE>() ] );
+	}
+
+	template< typename SERVICE_TYPE >
+	inline SERVICE_TYPE* ServiceRef< SERVICE_TYPE >::Get( void ) const
+	{
+		return mSlot ? static_cast< SERVICE_TYPE * >( mSlot->load( std::memory_order_acquire ) ) : NULL;
 	}
 }
@@ -30,6 +30,7 @@
 #if CBL_LOGGING_ENABLED == CBL_ENABLED
 // Chewable Headers //
 #include "cbl/Debug/ILogger.h"
+#include "cbl/Memory/MemBudget.h"
 #include "cbl/Util/Noncopyable.h"
 #include "cbl/Util/Property.h"
 #include "cbl/Util/Singleton.h"
@@ -99,6 +100,8 @@ namespace cbl
 		//! @param	file	Source file.
 		//! @param	line	Line number.
 		void OutputMessage( const Char * file, Uint32 line );
+		//! Get the number of messages dropped because the logging budget ran out.
+		inline Uint32 GetDropped( void ) const { return mDropped; }
 
 	/***** Private Methods *****/
 	private:
@@ -109,12 +112,15 @@ namespace cbl
 	private:
 		typedef std::map< std::string, ILogger * >		LoggerList;		//!< Logger list.
 		typedef std::pair< std::string, ILogger * >		LoggerEntry;	//!< Logger list entry.
+		typedef std::basic_ostringstream< Char, std::char_traits< Char >, BudgetStlAllocator< Char, MemCategory::Logging > >
+														LogBuffer;		//!< Message buffer, in the logging budget.
 
 	/***** Private Members *****/
 	private:
 		LoggerList							mLogs;			//!< Loggers list.
-		mutable Ostringstream				mBuffer;		//!< Log buffer.
+		mutable LogBuffer					mBuffer;		//!< Log buffer.
 		mutable LogLevel::Options			mWriteThreshold;//!< Log buffer threshold.
+		Uint32								mDropped;		//!< Messages dropped at the logging budget.
 		CBL_DECL_SINGLETON( LogManager );
 	};
 	
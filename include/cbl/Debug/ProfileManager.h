@@ -56,6 +56,9 @@ namespace cbl
 		void Enter( const Char* id );
 		void Exit( void );
 		void GenerateStatistics(const Char* filename);
+		//! Set the allocator for the profile tree. Discards the profiles recorded so far,
+		//! so call it before profiling starts.
+		void SetAllocator( Allocator& allocator );
 
 	/***** Private Methods *****/
 	private:
@@ -65,6 +68,7 @@ namespace cbl
 	private:
 		Profile *		mRoot;
 		Profile *		mCurrent;
+		Allocator *		mAllocator;
 		Uint32			mLongestLine;
 		Int32			mStackCount;
 		CBL_DECL_SINGLETON( ProfileManager );
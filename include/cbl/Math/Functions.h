@@ -27,6 +27,12 @@
 // Chewable Headers //
 #include "cbl/Chewable.h"
 
+// External Dependencies //
+#if CBL_COMPILER == CBL_COMPILER_MSVC
+#	include <intrin.h>
+#	pragma intrinsic( _BitScanForward, _BitScanReverse )
+#endif
+
 namespace cbl
 {
 	namespace Math
@@ -237,6 +243,38 @@ namespace cbl
             x |= (x >> 16);
             return(32 - NumOnesInBit32(x));
         }
+
+		//! Count the leading zero bits of an integer.
+		//! @return		Number of zero bits above the most significant set bit, 32 if x is 0.
+		inline Uint32 CountLeadingZeros32( Uint32 x )
+		{
+			if( x == 0 ) return 32;
+		#if CBL_COMPILER == CBL_COMPILER_MSVC
+			unsigned long index;
+			_BitScanReverse( &index, x );
+			return 31 - Uint32( index );
+		#elif CBL_COMPILER == CBL_COMPILER_GNUC
+			return Uint32( __builtin_clz( x ) );
+		#else
+			return LastZeroBitPos( x );
+		#endif
+		}
+
+		//! Count the trailing zero bits of an integer.
+		//! @return		Index of the least significant set bit, 32 if x is 0.
+		inline Uint32 CountTrailingZeros32( Uint32 x )
+		{
+			if( x == 0 ) return 32;
+		#if CBL_COMPILER == CBL_COMPILER_MSVC
+			unsigned long index;
+			_BitScanForward( &index, x );
+			return Uint32( index );
+		#elif CBL_COMPILER == CBL_COMPILER_GNUC
+			return Uint32( __builtin_ctz( x ) );
+		#else
+			return NumOnesInBit32( ( x & -Int32( x ) ) - 1 );
+		#endif
+		}
 	}
 }
 
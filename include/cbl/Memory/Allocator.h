@@ -0,0 +1,158 @@
+/* This source file is part of the Chewable Framework.
+ * For the latest info, please visit http://chewable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file Allocator.h
+ * @brief Allocator interface and STL adapters for framework containers.
+ */
+
+#ifndef __CBL_ALLOCATOR_H_
+#define __CBL_ALLOCATOR_H_
+
+// Chewable Headers //
+#include "cbl/Chewable.h"
+
+// External Dependencies //
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <unordered_map>
+#include <vector>
+
+namespace cbl
+{
+	//! Memory source for framework containers.
+	//! Subsystems such as ObjectManager, TypeDB and GameStateManager take an allocator at
+	//! construction and route all of their container memory through it, so a game can
+	//! back them with its own arenas or pools and measure them separately.
+	//! Implementations must be thread-safe if the subsystem using them is.
+	class CBL_API Allocator
+	{
+	/***** Public Static Methods *****/
+	public:
+		//! Get the general purpose heap allocator.
+		static Allocator& GetDefault( void );
+		//! Get the allocator that backs object pool storage.
+		//! This is a shared PageArena when CBL_POOL_PAGE_ARENA is enabled, otherwise the heap.
+		static Allocator& GetPool( void );
+
+	/***** Public Methods *****/
+	public:
+		//! Destructor.
+		virtual ~Allocator() {}
+		//! Allocate uninitialised memory.
+		//! @param	size		Bytes to allocate.
+		//! @param	align		Alignment, must be a power of 2.
+		//! @return				Memory, or NULL if the allocator refuses the request
+		//!						(see MemBudget).
+		virtual void* Allocate( size_t size, size_t align ) = 0;
+		//! Free memory from Allocate.
+		//! @param	mem			Memory to free.
+		//! @param	size		Bytes passed to Allocate.
+		//! @param	align		Alignment passed to Allocate.
+		virtual void Deallocate( void* mem, size_t size, size_t align ) = 0;
+	};
+
+	//! Allocator using the global heap.
+	class CBL_API HeapAllocator :
+		public Allocator
+	{
+	public:
+		virtual void* Allocate( size_t size, size_t align );
+		virtual void Deallocate( void* mem, size_t size, size_t align );
+	};
+
+	//! Allocator that counts the memory it passes through to another allocator.
+	class CBL_API CountingAllocator :
+		public Allocator
+	{
+	/***** Public Methods *****/
+	public:
+		//! Constructor.
+		//! @param	parent		Allocator that provides the memory.
+		explicit CountingAllocator( Allocator& parent = Allocator::GetDefault() );
+		virtual void* Allocate( size_t size, size_t align );
+		virtual void Deallocate( void* mem, size_t size, size_t align );
+		//! Get the bytes currently allocated.
+		inline size_t GetLiveBytes( void ) const { return mLiveBytes.load( std::memory_order_relaxed ); }
+		//! Get the number of live allocations.
+		inline size_t GetLiveCount( void ) const { return mLiveCount.load( std::memory_order_relaxed ); }
+		//! Get the total number of allocations made.
+		inline size_t GetAllocations( void ) const { return mAllocations.load( std::memory_order_relaxed ); }
+
+	/***** Private Members *****/
+	private:
+		Allocator&				mParent;		//!< Memory source.
+		std::atomic<size_t>		mLiveBytes;		//!< Bytes currently allocated.
+		std::atomic<size_t>		mLiveCount;		//!< Live allocations.
+		std::atomic<size_t>		mAllocations;	//!< Total allocations.
+	};
+
+	//! STL allocator that takes its memory from a cbl::Allocator.
+	template< typename T >
+	class StlAllocator
+	{
+	public:
+		typedef T					value_type;
+		typedef T*					pointer;
+		typedef const T*			const_pointer;
+		typedef T&					reference;
+		typedef const T&			const_reference;
+		typedef size_t				size_type;
+		typedef ptrdiff_t			difference_type;
+
+		template< typename U >
+		struct rebind { typedef StlAllocator< U > other; };
+
+		//! Constructor.
+		//! @param	allocator	Allocator to take memory from, defaults to the heap.
+		StlAllocator( Allocator& allocator = Allocator::GetDefault() ) : mAllocator( &allocator ) {}
+		template< typename U >
+		StlAllocator( const StlAllocator< U >& rhs ) : mAllocator( rhs.GetAllocator() ) {}
+
+		T* allocate( size_t n ) {
+			void* mem = mAllocator->Allocate( n * sizeof(T), alignof(T) );
+			if( mem == NULL ) throw std::bad_alloc();
+			return static_cast< T* >( mem );
+		}
+		void deallocate( T* mem, size_t n ) { mAllocator->Deallocate( mem, n * sizeof(T), alignof(T) ); }
+
+		Allocator* GetAllocator( void ) const { return mAllocator; }
+
+		template< typename U >
+		bool operator == ( const StlAllocator< U >& rhs ) const { return mAllocator == rhs.GetAllocator(); }
+		template< typename U >
+		bool operator != ( const StlAllocator< U >& rhs ) const { return mAllocator != rhs.GetAllocator(); }
+
+	private:
+		Allocator*			mAllocator;
+	};
+
+	//! Vector using a cbl::Allocator.
+	template< typename T >
+	struct AllocVector { typedef std::vector< T, StlAllocator< T > > Type; };
+
+	//! Unordered map using a cbl::Allocator.
+	template< typename KEY, typename VALUE, typename HASH = std::hash< KEY > >
+	struct AllocUnorderedMap {
+		typedef std::unordered_map< KEY, VALUE, HASH, std::equal_to< KEY >, StlAllocator< std::pair< const KEY, VALUE > > > Type;
+	};
+}
+
+#endif // __CBL_ALLOCATOR_H_
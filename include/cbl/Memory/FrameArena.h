@@ -0,0 +1,169 @@
+/* This source file is part of the Chewable Framework.
+ * For the latest info, please visit http://chewable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file FrameArena.h
+ * @brief Per-thread linear allocator for scratch memory that lives for one frame.
+ */
+
+#ifndef __CBL_FRAMEARENA_H_
+#define __CBL_FRAMEARENA_H_
+
+// Chewable Headers //
+#include "cbl/Chewable.h"
+#include "cbl/Util/Noncopyable.h"
+
+// External Dependencies //
+#include <cstddef>
+#include <vector>
+
+namespace cbl
+{
+	//! Bump-pointer allocator for short-lived scratch memory.
+	//! Each thread has its own arena (see Get), which Game::Tick resets after every step.
+	//! Deallocation is a no-op; memory comes back through Reset or by releasing to a
+	//! marker (see FrameScope).
+	//! 
+	//! Usage:
+	//! @code
+	//! cbl::FrameScope scope;	// Everything below is released when scope ends.
+	//! cbl::FrameVector< int >::Type ids;
+	//! ids.push_back( 1 );
+	//! @endcode
+	class CBL_API FrameArena :
+		Noncopyable
+	{
+	/***** Types *****/
+	public:
+		//! Arena position, used to release everything allocated after it.
+		struct Marker
+		{
+			size_t			Block;		//!< Block index.
+			size_t			Offset;		//!< Offset in block.
+			size_t			Used;		//!< Total bytes used.
+		};
+
+	/***** Public Static Methods *****/
+	public:
+		//! Get the calling thread's arena.
+		static FrameArena& Get( void );
+
+	/***** Public Methods *****/
+	public:
+		//! Constructor.
+		//! @param	blockSize	Size of each memory block.
+		explicit FrameArena( size_t blockSize = CBL_FRAME_ARENA_BLOCK );
+		//! Destructor.
+		~FrameArena();
+		//! Allocate uninitialised memory.
+		//! @param	size		Bytes to allocate.
+		//! @param	align		Alignment, must be a power of 2.
+		//! @return				Memory, valid until the arena is reset or released past it.
+		void* Allocate( size_t size, size_t align = sizeof(void*) * 2 );
+		//! Get the current position.
+		Marker GetMarker( void ) const;
+		//! Release everything allocated since a marker.
+		void Release( const Marker& marker );
+		//! Release everything. If the frame needed more than one block, the blocks are
+		//! merged into one big enough for the high-water mark.
+		void Reset( void );
+		//! Get the bytes currently in use, including alignment padding.
+		inline size_t GetUsed( void ) const { return mUsed; }
+		//! Get the most bytes ever in use at once.
+		inline size_t GetHighWater( void ) const { return mHighWater; }
+		//! Get the bytes reserved by the arena.
+		size_t GetCapacity( void ) const;
+
+	/***** Private Types *****/
+	private:
+		struct Block
+		{
+			Char*			Data;		//!< Block memory.
+			size_t			Size;		//!< Block size.
+		};
+		typedef std::vector<Block>	BlockList;
+
+	/***** Private Members *****/
+	private:
+		BlockList			mBlocks;	//!< Memory blocks. Blocks past mBlock are spare.
+		size_t				mBlock;		//!< Current block.
+		size_t				mOffset;	//!< Offset in current block.
+		size_t				mUsed;		//!< Bytes in use.
+		size_t				mHighWater;	//!< Peak bytes in use.
+		size_t				mBlockSize;	//!< Default block size.
+	};
+
+	//! Releases the arena back to where it was when the scope was entered.
+	class CBL_API FrameScope :
+		Noncopyable
+	{
+	public:
+		//! Constructor.
+		//! @param	arena	Arena to mark, defaults to the calling thread's.
+		explicit FrameScope( FrameArena& arena = FrameArena::Get() )
+			: mArena( arena ), mMarker( arena.GetMarker() ) {}
+		//! Destructor.
+		~FrameScope() { mArena.Release( mMarker ); }
+
+	private:
+		FrameArena&			mArena;
+		FrameArena::Marker	mMarker;
+	};
+
+	//! STL allocator that takes its memory from a FrameArena.
+	template< typename T >
+	class FrameAllocator
+	{
+	public:
+		typedef T					value_type;
+		typedef T*					pointer;
+		typedef const T*			const_pointer;
+		typedef T&					reference;
+		typedef const T&			const_reference;
+		typedef size_t				size_type;
+		typedef ptrdiff_t			difference_type;
+
+		template< typename U >
+		struct rebind { typedef FrameAllocator< U > other; };
+
+		//! Constructor.
+		//! @param	arena	Arena to allocate from, defaults to the calling thread's.
+		FrameAllocator( FrameArena& arena = FrameArena::Get() ) : mArena( &arena ) {}
+		template< typename U >
+		FrameAllocator( const FrameAllocator< U >& rhs ) : mArena( rhs.GetArena() ) {}
+
+		T* allocate( size_t n ) { return static_cast< T* >( mArena->Allocate( n * sizeof(T), alignof(T) ) ); }
+		void deallocate( T*, size_t ) {}
+
+		FrameArena* GetArena( void ) const { return mArena; }
+
+		template< typename U >
+		bool operator == ( const FrameAllocator< U >& rhs ) const { return mArena == rhs.GetArena(); }
+		template< typename U >
+		bool operator != ( const FrameAllocator< U >& rhs ) const { return mArena != rhs.GetArena(); }
+
+	private:
+		FrameArena*			mArena;
+	};
+
+	//! Vector using frame memory.
+	template< typename T >
+	struct FrameVector { typedef std::vector< T, FrameAllocator< T > > Type; };
+}
+
+#endif // __CBL_FRAMEARENA_H_
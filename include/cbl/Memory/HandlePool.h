@@ -0,0 +1,144 @@
+/* This source file is part of the Chewable Framework.
+ * For the latest info, please visit http://chewable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file HandlePool.h
+ * @brief Object pool addressed through handles, with incremental compaction.
+ */
+
+#ifndef __CBL_HANDLEPOOL_H_
+#define __CBL_HANDLEPOOL_H_
+
+// Chewable Headers //
+#include "cbl/Chewable.h"
+#include "cbl/Memory/HeapPages.h"
+#include "cbl/Memory/Relocate.h"
+#include "cbl/Util/TimeSpan.h"
+
+// External Dependencies //
+#include <type_traits>
+#include <vector>
+
+namespace cbl
+{
+	//! Object pool whose objects are reached through handles rather than pointers.
+	//! Since nothing else holds their address, live objects can be moved: Compact
+	//! relocates objects out of sparse pages into dense ones within a time budget,
+	//! patches the handle table and releases the emptied pages. Run it once a frame
+	//! after heavy churn to keep iteration on densely packed pages.
+	//! Code that needs a raw pointer across a Compact call must Pin the handle; pinned
+	//! objects are skipped.
+	template< class C, cbl::Uint32 PageSize = 1024 >
+	class HandlePool
+	{
+	/***** Types *****/
+	public:
+		//! Object handle. Stale handles are detected through the generation.
+		struct Handle
+		{
+			Uint32			Index;			//!< Handle table index.
+			Uint32			Generation;		//!< Generation of the table entry.
+
+			Handle() : Index( 0xFFFFFFFF ), Generation( 0 ) {}
+			bool operator == ( const Handle& rhs ) const { return Index == rhs.Index && Generation == rhs.Generation; }
+		};
+
+	/***** Public Methods *****/
+	public:
+		//! Constructor.
+		//! @param	relocate		Hook that moves an object, e.g. Type::Relocate.
+		//!							Defaults to move constructing C.
+		//! @param	maxEmptyPages	Number of empty pages to keep around before releasing them.
+		explicit HandlePool( RelocateFunc relocate = DefaultRelocator<C>(), Uint32 maxEmptyPages = 1 );
+		//! Destructor. Destroys the remaining objects.
+		~HandlePool();
+		//! Construct an object in the pool, forwarding the arguments to its constructor.
+		//! @return		Handle to the new object.
+		template< typename... Args >
+		Handle Allocate( Args&&... args );
+		//! Destroy an object.
+		//! @return		False if the handle is stale.
+		bool Deallocate( const Handle& handle );
+		//! Get an object. The pointer is only stable until the next Compact, unless pinned.
+		//! @return		Object, or NULL if the handle is stale.
+		C* Get( const Handle& handle ) const;
+		//! Stop an object from being moved by Compact. Pins are counted.
+		//! @return		Object, or NULL if the handle is stale.
+		C* Pin( const Handle& handle );
+		//! Release a pin.
+		void Unpin( const Handle& handle );
+		//! Move objects into dense pages until the budget runs out or nothing is left to move.
+		//! @param	budget		Time to spend.
+		//! @return				Number of objects moved.
+		Uint32 Compact( const TimeSpan& budget );
+		//! Get the number of live objects.
+		inline Uint32 GetCount( void ) const { return mCount; }
+		//! Get the number of allocated pages.
+		inline Uint32 GetPageCount( void ) const { return mPages.GetPageCount(); }
+
+	/***** Private Types *****/
+	private:
+		//! Pool slot: the object and the handle table entry that points at it.
+		struct Slot
+		{
+			typename std::aligned_storage< sizeof(C), alignof(C) >::type	Object;
+			Uint32			Handle;			//!< Handle table index.
+		};
+
+		//! Handle table entry.
+		struct Entry
+		{
+			Slot*			Object;			//!< Slot, or NULL if the entry is free.
+			Uint32			Generation;		//!< Bumped every time the entry is freed.
+			Uint32			Pins;			//!< Pin count.
+		};
+
+		typedef std::vector< Entry >	EntryList;
+		typedef std::vector< Uint32 >	IndexList;
+
+		//! Compaction callbacks for HeapPages::CompactStep.
+		struct Mover
+		{
+			HandlePool*		Pool;
+			Uint32			Moved;
+
+			bool CanMove( const Slot* slot ) const { return Pool->mEntries[slot->Handle].Pins == 0; }
+			void Move( Slot* from, Slot* to );
+		};
+
+	/***** Private Methods *****/
+	private:
+		HandlePool( const HandlePool& );
+		HandlePool& operator = ( const HandlePool& );
+		//! Get the table entry of a handle.
+		//! @return		Entry, or NULL if the handle is stale.
+		Entry* _GetEntry( const Handle& handle ) const;
+
+	/***** Private Members *****/
+	private:
+		HeapPages< Slot, PageSize >		mPages;			//!< Object storage.
+		mutable EntryList				mEntries;		//!< Handle table.
+		IndexList						mFreeEntries;	//!< Free handle table entries.
+		RelocateFunc					mRelocate;		//!< Object relocation hook.
+		Uint32							mCount;			//!< Live objects.
+	};
+}
+
+#include "HandlePool.inl"
+
+#endif // __CBL_HANDLEPOOL_H_
@@ -0,0 +1,152 @@
+/* This source file is part of the Chewable Framework.
+ * For the latest info, please visit http://chewable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file HandlePool.inl
+ * @brief Object pool addressed through handles, with incremental compaction.
+ */
+
+// Chewable Headers //
+#include "cbl/Util/Stopwatch.h"
+
+namespace cbl
+{
+	template< class C, cbl::Uint32 PageSize >
+	HandlePool<C,PageSize>::HandlePool( RelocateFunc relocate, Uint32 maxEmptyPages )
+	: mPages( maxEmptyPages )
+	, mRelocate( relocate )
+	, mCount( 0 )
+	{
+	}
+
+	template< class C, cbl::Uint32 PageSize >
+	HandlePool<C,PageSize>::~HandlePool()
+	{
+		for( size_t i = 0; i < mEntries.size(); ++i ) {
+			if( Slot* slot = mEntries[i].Object ) {
+				reinterpret_cast<C*>( &slot->Object )->~C();
+				mPages.DeallocateSlot( slot );
+			}
+		}
+	}
+
+	template< class C, cbl::Uint32 PageSize >
+	template< typename... Args >
+	typename HandlePool<C,PageSize>::Handle HandlePool<C,PageSize>::Allocate( Args&&... args )
+	{
+		Uint32 index;
+		if( mFreeEntries.empty() ) {
+			index = Uint32( mEntries.size() );
+			Entry entry = { NULL, 0, 0 };
+			mEntries.push_back( entry );
+		}
+		else {
+			index = mFreeEntries.back();
+			mFreeEntries.pop_back();
+		}
+
+		Slot* slot = mPages.AllocateSlot();
+		new ( &slot->Object ) C( std::forward<Args>( args )... );
+		slot->Handle = index;
+		mEntries[index].Object = slot;
+		++mCount;
+
+		Handle handle;
+		handle.Index		= index;
+		handle.Generation	= mEntries[index].Generation;
+		return handle;
+	}
+
+	template< class C, cbl::Uint32 PageSize >
+	bool HandlePool<C,PageSize>::Deallocate( const Handle& handle )
+	{
+		Entry* entry = _GetEntry( handle );
+		if( !entry )
+			return false;
+
+		reinterpret_cast<C*>( &entry->Object->Object )->~C();
+		mPages.DeallocateSlot( entry->Object );
+
+		entry->Object = NULL;
+		entry->Pins = 0;
+		++entry->Generation;
+		mFreeEntries.push_back( handle.Index );
+		--mCount;
+		return true;
+	}
+
+	template< class C, cbl::Uint32 PageSize >
+	inline C* HandlePool<C,PageSize>::Get( const Handle& handle ) const
+	{
+		Entry* entry = _GetEntry( handle );
+		return entry ? reinterpret_cast<C*>( &entry->Object->Object ) : NULL;
+	}
+
+	template< class C, cbl::Uint32 PageSize >
+	C* HandlePool<C,PageSize>::Pin( const Handle& handle )
+	{
+		Entry* entry = _GetEntry( handle );
+		if( !entry )
+			return NULL;
+
+		++entry->Pins;
+		return reinterpret_cast<C*>( &entry->Object->Object );
+	}
+
+	template< class C, cbl::Uint32 PageSize >
+	void HandlePool<C,PageSize>::Unpin( const Handle& handle )
+	{
+		Entry* entry = _GetEntry( handle );
+		if( entry && entry->Pins > 0 )
+			--entry->Pins;
+	}
+
+	template< class C, cbl::Uint32 PageSize >
+	Uint32 HandlePool<C,PageSize>::Compact( const TimeSpan& budget )
+	{
+		if( !mRelocate )
+			return 0;
+
+		Mover mover = { this, 0 };
+		Int64 end = Stopwatch::GetSystemTicks() + budget.Ticks();
+		while( mPages.CompactStep( mover ) ) {
+			if( Stopwatch::GetSystemTicks() >= end )
+				break;
+		}
+		return mover.Moved;
+	}
+
+	template< class C, cbl::Uint32 PageSize >
+	void HandlePool<C,PageSize>::Mover::Move( Slot* from, Slot* to )
+	{
+		Pool->mRelocate( &to->Object, &from->Object );
+		to->Handle = from->Handle;
+		Pool->mEntries[to->Handle].Object = to;
+		++Moved;
+	}
+
+	template< class C, cbl::Uint32 PageSize >
+	inline typename HandlePool<C,PageSize>::Entry* HandlePool<C,PageSize>::_GetEntry( const Handle& handle ) const
+	{
+		if( handle.Index >= mEntries.size() )
+			return NULL;
+
+		Entry& entry = mEntries[handle.Index];
+		return entry.Object && entry.Generation == handle.Generation ? &entry : NULL;
+	}
+}
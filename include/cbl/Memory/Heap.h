@@ -27,40 +27,95 @@
 // Chewable Headers //
 #include "cbl/Chewable.h"
 #include "cbl/Math/Functions.h"
+#include "cbl/Memory/Allocator.h"
 #include "cbl/Util/Helpers.h"
 
+// External Dependencies //
+#include <utility>
+
 namespace cbl
 {
+	//! Fixed size object pool.
+	//! Free slots are tracked by a bitmap with one bit per object, plus a summary with
+	//! one bit per bitmap word that still has a free slot. Allocation scans the summary
+	//! from the lowest word that may be free, so it touches a couple of words rather
+	//! than the whole bitmap; slots are found with hardware bit scans.
+	//! Deallocation is O(1) and rejects pointers that are foreign or already free.
 	template< class C, cbl::Uint32 HeapSize = 1024 >
 	class Heap
-    {
-    /***** Public Methods *****/
+	{
+	/***** Public Static Constants *****/
+	public:
+		static const Uint32 Capacity = HeapSize;	//!< Number of objects the heap holds.
+
+	/***** Public Methods *****/
 	public:
-        //! Constructor.
+		//! Constructor.
 		Heap();
-        //! Destructor.
+		//! Destructor.
 		~Heap();
-        //! Default object allocation.
-		C* Allocate();
-		//! Heap allocation variadic arguments.
-		template<typename ...Args>
-		C* Allocate(Args... args);
-		//! Deallocate class memory.
+		//! Construct an object in the heap, forwarding the arguments to its constructor.
+		//! @return		New object, or NULL if the heap is full.
+		template< typename... Args >
+		C* Allocate( Args&&... args );
+		//! Destroy an object and free its slot.
+		//! @return		False if the pointer is NULL, not from this heap, or already freed.
 		bool Deallocate( C* mem );
+		//! Claim a slot without constructing an object in it.
+		//! @return		Uninitialised slot, or NULL if the heap is full.
+		inline C* AllocateSlot( void ) { return reinterpret_cast<C*>( _AllocateSpace() ); }
+		//! Free a slot without destroying its contents.
+		//! @return		False if the pointer is NULL, not from this heap, or already freed.
+		bool DeallocateSlot( C* mem );
+		//! Check if a pointer lies inside this heap's storage.
+		bool Owns( const C* mem ) const;
+		//! Check if a pointer is an allocated slot of this heap.
+		bool IsAllocated( const C* mem ) const;
+		//! Get the number of free slots.
+		inline Uint32 GetFreeCount( void ) const { return mFreeCount; }
+		//! Check if the heap has no free slots.
+		inline bool IsFull( void ) const { return mFreeCount == 0; }
+		//! Check if the heap has no live objects.
+		inline bool IsEmpty( void ) const { return mFreeCount == HeapSize; }
+		//! Get the start of the heap's object storage.
+		inline const Char* GetStorage( void ) const { return mMemAlloc; }
 
-    private:
-        Char* _AllocateSpace( void );
+	/***** Private Methods *****/
+	private:
+		Heap( const Heap& );
+		Heap& operator = ( const Heap& );
+		//! Claim a free slot.
+		//! @return		Slot memory, or NULL if the heap is full.
+		Char* _AllocateSpace( void );
+		//! Get the slot index of a pointer.
+		//! @return		Slot index, or InvalidSlot if the pointer isn't the start of a slot in this heap.
+		Uint32 _GetSlot( const C* mem ) const;
+
+	/***** Private Static Constants *****/
+	private:
+		static const Uint32 InvalidSlot = 0xFFFFFFFF;
 
-    /***** Private Static Members *****/
+	/***** Private Static Members *****/
 	private:
-        static const Uint32 sSpareBits = HeapSize % 32;
-		// We get the number of bit slots we need by taking the StackSize / 32 (number of bits in a Uint32).
+		static const Uint32 sSpareBits = HeapSize % 32;
+		//! Number of bitmap words, one bit per object.
 		static const Uint32 sBitSlots = sSpareBits ? HeapSize / 32 + 1 : HeapSize / 32;
-        static const Uint32 sBitSlotSize = sBitSlots * sizeof(Uint32);
+		//! Number of summary words, one bit per bitmap word.
+		static const Uint32 sSummarySlots = ( sBitSlots + 31 ) / 32;
+		//! Object storage size, padded so the bitmaps that follow are word aligned.
+		static const Uint32 sObjectSize = ( sizeof(C) * HeapSize + 3 ) & ~3;
+		//! Total storage size, objects followed by the bitmaps.
+		static const Uint32 sStorageSize = sObjectSize + ( sBitSlots + sSummarySlots ) * sizeof(Uint32);
+		//! Storage alignment.
+		static const Uint32 sStorageAlign = alignof(C) > 16 ? alignof(C) : 16;
 
-    /***** Private Members *****/
+	/***** Private Members *****/
 	private:
-		Char*           mMemAlloc;  //!< Allocated memory.
+		Char*			mMemAlloc;	//!< Object storage followed by the bitmaps.
+		Uint32*			mFree;		//!< Free bitmap. Set bits are free slots.
+		Uint32*			mSummary;	//!< Summary bitmap. Set bits are bitmap words with a free slot.
+		Uint32			mHint;		//!< Lowest summary word that may have a free slot.
+		Uint32			mFreeCount;	//!< Number of free slots.
 	};
 }
 
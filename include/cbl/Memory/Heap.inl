@@ -26,78 +26,112 @@
 
 namespace cbl
 {
-    template< class C, cbl::Uint32 HeapSize >
-    Heap<C,HeapSize>::Heap()
-    {
-		mMemAlloc = new cbl::Char[ sizeof(C) * HeapSize + sBitSlotSize ];
-		memset( mMemAlloc, 0, sBitSlotSize ); // Initialise memory bit slots to 0.
-        // Set our trailing unused bits to 1 so we don't ever use them.
-        if( sSpareBits ) {
-            Uint32 bits = 0;
-            Uint32 set = 1;
-            Uint32 loop = 32 - sSpareBits;
-            for( Uint32 i = 0; i < loop; ++i, set <<= 1 )
-                bits |= set;
-            *(reinterpret_cast<cbl::Uint32*>(mMemAlloc + sBitSlotSize - sizeof(Uint32))) = bits;
-        }
+	template< class C, cbl::Uint32 HeapSize >
+	Heap<C,HeapSize>::Heap()
+	: mHint( 0 )
+	, mFreeCount( HeapSize )
+	{
+		mMemAlloc	= static_cast<Char*>( Allocator::GetPool().Allocate( sStorageSize, sStorageAlign ) );
+		mFree		= reinterpret_cast<Uint32*>( mMemAlloc + sObjectSize );
+		mSummary	= mFree + sBitSlots;
+
+		// Every slot starts free; the trailing unused bits stay clear so they're never handed out.
+		memset( mFree, 0xFF, sBitSlots * sizeof(Uint32) );
+		if( sSpareBits )
+			mFree[sBitSlots - 1] = ( 1u << sSpareBits ) - 1;
+
+		memset( mSummary, 0, sSummarySlots * sizeof(Uint32) );
+		for( Uint32 i = 0; i < sBitSlots; ++i )
+			mSummary[i / 32] |= 1u << ( i % 32 );
 	}
 
-    template< class C, cbl::Uint32 HeapSize >
-    Heap<C,HeapSize>::~Heap()
-    {
-		delete [] mMemAlloc;
+	template< class C, cbl::Uint32 HeapSize >
+	Heap<C,HeapSize>::~Heap()
+	{
+		Allocator::GetPool().Deallocate( mMemAlloc, sStorageSize, sStorageAlign );
 	}
 
-    template< class C, cbl::Uint32 HeapSize >
-    inline C* Heap<C,HeapSize>::Allocate()
-    {
-        cbl::Char* _mem = _AllocateSpace();
-        return _mem ? reinterpret_cast<C*>( new (_mem) C() ) : nullptr;
+	template< class C, cbl::Uint32 HeapSize >
+	template< typename... Args >
+	inline C* Heap<C,HeapSize>::Allocate( Args&&... args )
+	{
+		cbl::Char* _mem = _AllocateSpace();
+		return _mem ? new (_mem) C( std::forward<Args>( args )... ) : nullptr;
 	}
 
-	//! Heap allocation template definition.
-    template< class C, cbl::Uint32 HeapSize >
-	template< typename... Args>
-    inline C* Heap<C,HeapSize>::Allocate(Args... args)
-    {
-        cbl::Char* _mem = _AllocateSpace();
-        return _mem ? reinterpret_cast<C*>( new (_mem) C(args...) ) : nullptr;
-    }
-
-#undef ALLOC_DEF
-
-    template< class C, cbl::Uint32 HeapSize >
-    bool Heap<C,HeapSize>::Deallocate( C* mem )
-    {
-		if (mem == nullptr)
-			return false;
+	template< class C, cbl::Uint32 HeapSize >
+	inline bool Heap<C,HeapSize>::Owns( const C* mem ) const
+	{
+		const Char* ptr = reinterpret_cast<const Char*>( mem );
+		return ptr >= mMemAlloc && ptr < mMemAlloc + sizeof(C) * HeapSize;
+	}
 
-		Uint32 arraypos	= ( reinterpret_cast<Char*>(mem) - ( mMemAlloc + sBitSlotSize ) ) / sizeof(C);
-		Uint32 bitpos		= arraypos % 32;
-		Uint32* mempos		= reinterpret_cast<Uint32*>(mMemAlloc) + arraypos / 32;
-		if( ( *mempos & ( 0x80000000 >> bitpos ) ) == 0 )
-			return false;
+	template< class C, cbl::Uint32 HeapSize >
+	inline bool Heap<C,HeapSize>::IsAllocated( const C* mem ) const
+	{
+		Uint32 slot = _GetSlot( mem );
+		return slot != InvalidSlot && ( mFree[slot / 32] & ( 1u << ( slot % 32 ) ) ) == 0;
+	}
+
+	template< class C, cbl::Uint32 HeapSize >
+	bool Heap<C,HeapSize>::Deallocate( C* mem )
+	{
+		if( !IsAllocated( mem ) )
+			return false; // Foreign, misaligned or double free.
 
-		*mempos ^= (0x80000000 >> bitpos);
 		// Call our destructor when we 'clear' our memory.
 		mem->~C();
+		return DeallocateSlot( mem );
+	}
+
+	template< class C, cbl::Uint32 HeapSize >
+	bool Heap<C,HeapSize>::DeallocateSlot( C* mem )
+	{
+		Uint32 slot = _GetSlot( mem );
+		if( slot == InvalidSlot )
+			return false;
+
+		Uint32 word	= slot / 32;
+		Uint32 bit	= 1u << ( slot % 32 );
+		if( mFree[word] & bit )
+			return false; // Double free.
+
+		mFree[word] |= bit;
+		mSummary[word / 32] |= 1u << ( word % 32 );
+		if( word / 32 < mHint )
+			mHint = word / 32;
+		++mFreeCount;
 		return true;
 	}
 
-    template< class C, cbl::Uint32 HeapSize >
-    Char* Heap<C,HeapSize>::_AllocateSpace( void )
-    {
-        Uint32* mem = reinterpret_cast<cbl::Uint32*>(mMemAlloc);
-        for( Uint32 i = 0; i < sBitSlots; ++i )
-        {
-            Uint32 availBit = Math::MostSigBit32( ~(*mem) );
-            if( availBit != 0 ) {
-                *mem |= availBit; // set the 'allocated' bit.
-                return (mMemAlloc + sBitSlotSize + ( i * 32 + Math::LastZeroBitPos(availBit) ) * sizeof(C));
-            }
-            ++mem;
-        }
-
-        return NULL;
-    }
+	template< class C, cbl::Uint32 HeapSize >
+	inline Uint32 Heap<C,HeapSize>::_GetSlot( const C* mem ) const
+	{
+		if( mem == nullptr || !Owns( mem ) )
+			return InvalidSlot;
+
+		size_t offset = reinterpret_cast<const Char*>(mem) - mMemAlloc;
+		return offset % sizeof(C) == 0 ? Uint32( offset / sizeof(C) ) : InvalidSlot;
+	}
+
+	template< class C, cbl::Uint32 HeapSize >
+	Char* Heap<C,HeapSize>::_AllocateSpace( void )
+	{
+		for( ; mHint < sSummarySlots; ++mHint ) {
+			Uint32 summary = mSummary[mHint];
+			if( summary == 0 )
+				continue;
+
+			Uint32 word	= mHint * 32 + Math::CountTrailingZeros32( summary );
+			Uint32 bit	= Math::CountTrailingZeros32( mFree[word] );
+			mFree[word] &= mFree[word] - 1; // Clear the lowest set bit.
+			if( mFree[word] == 0 )
+				mSummary[mHint] &= summary - 1;
+			--mFreeCount;
+
+			return mMemAlloc + ( word * 32 + bit ) * sizeof(C);
+		}
+
+		return NULL;
+	}
 }
@@ -17,8 +17,8 @@
  */
 
 /**
- * @file HeapPage.h
- * @brief Paged heap allocator.
+ * @file HeapPages.h
+ * @brief Growable paged object pool.
  */
 
 #ifndef __CBL_HEAPPAGES_H_
@@ -27,45 +27,118 @@
 // Chewable Headers //
 #include "cbl/Chewable.h"
 #include "cbl/Memory/Heap.h"
+#include "cbl/Memory/MemTracker.h"
+
+// External Dependencies //
+#include <vector>
 
 namespace cbl
 {
+	//! Object pool that grows by adding Heap pages.
+	//! Pages with free slots are kept in a separate list, so allocation never searches
+	//! full pages. Pages are also kept sorted by address, which lets Deallocate find the
+	//! owning page with a binary search. Empty pages beyond the high-water mark are
+	//! released back to the system.
+	//! CompactStep moves objects out of the sparsest pages into the densest ones so
+	//! that churned pools can give pages back; see HandlePool.
 	template< class C, cbl::Uint32 PageSize = 1024 >
 	class HeapPages
-    {
-    /***** Public Methods *****/
+	{
+	/***** Public Methods *****/
 	public:
-        //! Constructor.
-		HeapPages();
-        //! Destructor.
+		//! Constructor.
+		//! @param	maxEmptyPages	Number of empty pages to keep around before releasing them.
+		explicit HeapPages( Uint32 maxEmptyPages = 1 );
+		//! Destructor.
 		~HeapPages();
-        //! Default object allocation.
-		C* Allocate();
-        
-//! Heap allocation template methods.
-#define ALLOC_DECL( paramCount )\
-        template< CBL_TPLPARAM_REPEAT(A, paramCount) >\
-        C* Allocate( CBL_PARAM_REPEAT_DECL(A, a, paramCount) )
+		//! Construct an object in the pool, forwarding the arguments to its constructor.
+		//! @return		New object.
+		template< typename... Args >
+		C* Allocate( Args&&... args );
+		//! Destroy an object and free its slot.
+		//! @return		False if the pointer is NULL, not from this pool, or already freed.
+		bool Deallocate( C* mem );
+		//! Claim a slot without constructing an object in it.
+		//! @return		Uninitialised slot.
+		C* AllocateSlot( void );
+		//! Free a slot without destroying its contents.
+		//! @return		False if the pointer is NULL, not from this pool, or already freed.
+		bool DeallocateSlot( C* mem );
+		//! Check if a pointer lies inside one of this pool's pages.
+		bool Owns( const C* mem ) const;
+		//! Get the number of allocated pages.
+		inline Uint32 GetPageCount( void ) const { return Uint32( mPages.size() ); }
+		//! Get the number of pages with no live objects.
+		inline Uint32 GetEmptyPageCount( void ) const { return mEmptyPages; }
+		//! Get the number of empty pages kept before releasing them.
+		inline Uint32 GetMaxEmptyPages( void ) const { return mMaxEmptyPages; }
+		//! Set the number of empty pages kept before releasing them.
+		//! Releases surplus empty pages immediately.
+		void SetMaxEmptyPages( Uint32 maxEmptyPages );
+		//! Move one object from the sparsest page into the densest page that has room.
+		//! A page emptied this way is released. Call repeatedly to compact incrementally.
+		//! @param	mover	Provides bool CanMove( const C* ) to skip pinned objects, and
+		//!					void Move( C* from, C* to ) to relocate an object into an
+		//!					uninitialised slot and patch references to it.
+		//! @return			False once a pass over the pages has nothing left to move.
+		template< typename MOVER >
+		bool CompactStep( MOVER& mover );
 
-        ALLOC_DECL(1);
-        ALLOC_DECL(2);
-        ALLOC_DECL(3);
-        ALLOC_DECL(4);
-        ALLOC_DECL(5);
-        ALLOC_DECL(6);
-        ALLOC_DECL(7);
-        ALLOC_DECL(8);
-        ALLOC_DECL(9);
-        ALLOC_DECL(10);
+	/***** Private Types *****/
+	private:
+		typedef Heap<C,PageSize> PageHeap;
 
-#undef ALLOC_DECL
+		//! Single pool page.
+		struct Page
+		{
+			PageHeap		Objects;		//!< Page storage.
+			Uint32			NonFullIndex;	//!< Index in the non-full list, or InvalidIndex if full.
+			Uint32			CompactPass;	//!< Last compaction pass that gave up on the page.
+		};
 
-		bool Deallocate( C* mem );
+		typedef std::vector<Page*>	PageList;
 
-    private:
-        typedef Heap<C,PageSize>*   HeapPtr;
-        std::vector<HeapPtr>        mPages;
+		static const Uint32 InvalidIndex = 0xFFFFFFFF;
+
+	/***** Private Methods *****/
+	private:
+		HeapPages( const HeapPages& );
+		HeapPages& operator = ( const HeapPages& );
+		//! Add a new empty page.
+		Page* _AddPage( void );
+		//! Release an empty page.
+		void _ReleasePage( Page* page );
+		//! Claim a slot in a specific page.
+		C* _AllocateSlotIn( Page* page );
+		//! Free a slot in a specific page.
+		//! @return		True if the page was released.
+		bool _DeallocateSlotIn( Page* page, C* mem );
+		//! Remove a page from the non-full list.
+		void _RemoveNonFull( Page* page );
+		//! Pick the next page to empty during compaction.
+		//! @return		Sparsest page whose objects fit in the other pages, or NULL.
+		Page* _PickCompactSource( void );
+		//! Pick the page to move objects into during compaction.
+		//! @return		Fullest non-full page other than the source, or NULL.
+		Page* _PickCompactTarget( const Page* source ) const;
+		//! Find the page that holds an object.
+		//! @return		Owning page, or NULL if the pointer isn't in any page.
+		Page* _FindPage( const C* mem ) const;
+		//! Page ordering by storage address.
+		static bool _PageLess( const Page* lhs, const Page* rhs );
+
+	/***** Private Members *****/
+	private:
+		PageList			mPages;			//!< All pages, sorted by storage address.
+		PageList			mNonFull;		//!< Pages that have free slots.
+		Uint32				mEmptyPages;	//!< Number of pages with no live objects.
+		Uint32				mMaxEmptyPages;	//!< Empty page high-water mark.
+		Page*				mCompactSource;	//!< Page being emptied by compaction.
+		Uint32				mCompactSlot;	//!< Next slot to look at in the source page.
+		Uint32				mCompactPass;	//!< Current compaction pass.
 	};
 }
 
+#include "HeapPages.inl"
+
 #endif // __CBL_HEAPPAGES_H_
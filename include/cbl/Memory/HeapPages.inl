@@ -0,0 +1,272 @@
+/* This source file is part of the Chewable Framework.
+ * For the latest info, please visit http://chewable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file HeapPages.inl
+ * @brief Growable paged object pool.
+ */
+
+namespace cbl
+{
+	template< class C, cbl::Uint32 PageSize >
+	HeapPages<C,PageSize>::HeapPages( Uint32 maxEmptyPages )
+	: mEmptyPages( 0 )
+	, mMaxEmptyPages( maxEmptyPages )
+	, mCompactSource( NULL )
+	, mCompactSlot( 0 )
+	, mCompactPass( 1 )
+	{
+	}
+
+	template< class C, cbl::Uint32 PageSize >
+	HeapPages<C,PageSize>::~HeapPages()
+	{
+		for( size_t i = 0; i < mPages.size(); ++i ) {
+			CBL_MEM_TRACK_FREE( "HeapPages", sizeof(Page) + sizeof(C) * PageSize );
+			delete mPages[i];
+		}
+	}
+
+	template< class C, cbl::Uint32 PageSize >
+	template< typename... Args >
+	inline C* HeapPages<C,PageSize>::Allocate( Args&&... args )
+	{
+		return new ( AllocateSlot() ) C( std::forward<Args>( args )... );
+	}
+
+	template< class C, cbl::Uint32 PageSize >
+	bool HeapPages<C,PageSize>::Deallocate( C* mem )
+	{
+		Page* page = _FindPage( mem );
+		if( !page || !page->Objects.IsAllocated( mem ) )
+			return false;
+
+		mem->~C();
+		return DeallocateSlot( mem );
+	}
+
+	template< class C, cbl::Uint32 PageSize >
+	inline C* HeapPages<C,PageSize>::AllocateSlot( void )
+	{
+		return _AllocateSlotIn( mNonFull.empty() ? _AddPage() : mNonFull.back() );
+	}
+
+	template< class C, cbl::Uint32 PageSize >
+	bool HeapPages<C,PageSize>::DeallocateSlot( C* mem )
+	{
+		Page* page = _FindPage( mem );
+		if( !page || !page->Objects.IsAllocated( mem ) )
+			return false;
+
+		_DeallocateSlotIn( page, mem );
+		return true;
+	}
+
+	template< class C, cbl::Uint32 PageSize >
+	inline bool HeapPages<C,PageSize>::Owns( const C* mem ) const
+	{
+		return _FindPage( mem ) != NULL;
+	}
+
+	template< class C, cbl::Uint32 PageSize >
+	void HeapPages<C,PageSize>::SetMaxEmptyPages( Uint32 maxEmptyPages )
+	{
+		mMaxEmptyPages = maxEmptyPages;
+		for( size_t i = mNonFull.size(); i > 0 && mEmptyPages > mMaxEmptyPages; --i ) {
+			if( mNonFull[i-1]->Objects.IsEmpty() )
+				_ReleasePage( mNonFull[i-1] );
+		}
+	}
+
+	template< class C, cbl::Uint32 PageSize >
+	template< typename MOVER >
+	bool HeapPages<C,PageSize>::CompactStep( MOVER& mover )
+	{
+		if( !mCompactSource ) {
+			mCompactSource = _PickCompactSource();
+			mCompactSlot = 0;
+			if( !mCompactSource ) {
+				++mCompactPass;
+				return false;
+			}
+		}
+
+		// Find the next object that may move.
+		Page* source = mCompactSource;
+		C* storage = reinterpret_cast<C*>( const_cast<Char*>( source->Objects.GetStorage() ) );
+		for( ; mCompactSlot < PageSize; ++mCompactSlot ) {
+			C* obj = storage + mCompactSlot;
+			if( source->Objects.IsAllocated( obj ) && mover.CanMove( obj ) )
+				break;
+		}
+
+		Page* target = mCompactSlot < PageSize ? _PickCompactTarget( source ) : NULL;
+		if( !target ) {
+			// Only pinned objects are left, or nowhere to put them; try again next pass.
+			source->CompactPass = mCompactPass;
+			mCompactSource = NULL;
+			return true;
+		}
+
+		C* obj = storage + mCompactSlot++;
+		C* slot = _AllocateSlotIn( target );
+		mover.Move( obj, slot );
+
+		if( source->Objects.GetFreeCount() == PageSize - 1 ) {
+			// Last object out; release the page regardless of the high-water mark.
+			source->Objects.DeallocateSlot( obj );
+			++mEmptyPages;
+			_ReleasePage( source );
+		}
+		else {
+			_DeallocateSlotIn( source, obj );
+		}
+		return true;
+	}
+
+	template< class C, cbl::Uint32 PageSize >
+	typename HeapPages<C,PageSize>::Page* HeapPages<C,PageSize>::_AddPage( void )
+	{
+		Page* page = new Page;
+		page->CompactPass = 0;
+		CBL_MEM_TRACK_ALLOC( "HeapPages", sizeof(Page) + sizeof(C) * PageSize );
+		page->NonFullIndex = Uint32( mNonFull.size() );
+		mNonFull.push_back( page );
+		mPages.insert( std::lower_bound( mPages.begin(), mPages.end(), page, _PageLess ), page );
+		++mEmptyPages;
+		return page;
+	}
+
+	template< class C, cbl::Uint32 PageSize >
+	void HeapPages<C,PageSize>::_ReleasePage( Page* page )
+	{
+		if( page == mCompactSource )
+			mCompactSource = NULL;
+
+		_RemoveNonFull( page );
+		mPages.erase( std::lower_bound( mPages.begin(), mPages.end(), page, _PageLess ) );
+		--mEmptyPages;
+		CBL_MEM_TRACK_FREE( "HeapPages", sizeof(Page) + sizeof(C) * PageSize );
+		delete page;
+	}
+
+	template< class C, cbl::Uint32 PageSize >
+	C* HeapPages<C,PageSize>::_AllocateSlotIn( Page* page )
+	{
+		if( page->Objects.IsEmpty() )
+			--mEmptyPages;
+
+		C* slot = page->Objects.AllocateSlot();
+		if( page->Objects.IsFull() )
+			_RemoveNonFull( page );
+		return slot;
+	}
+
+	template< class C, cbl::Uint32 PageSize >
+	bool HeapPages<C,PageSize>::_DeallocateSlotIn( Page* page, C* mem )
+	{
+		bool wasFull = page->Objects.IsFull();
+		page->Objects.DeallocateSlot( mem );
+
+		if( wasFull ) {
+			page->NonFullIndex = Uint32( mNonFull.size() );
+			mNonFull.push_back( page );
+		}
+
+		if( page->Objects.IsEmpty() && ++mEmptyPages > mMaxEmptyPages ) {
+			_ReleasePage( page );
+			return true;
+		}
+		return false;
+	}
+
+	template< class C, cbl::Uint32 PageSize >
+	void HeapPages<C,PageSize>::_RemoveNonFull( Page* page )
+	{
+		// Swap-remove.
+		Page* last = mNonFull.back();
+		mNonFull[page->NonFullIndex] = last;
+		last->NonFullIndex = page->NonFullIndex;
+		mNonFull.pop_back();
+		page->NonFullIndex = InvalidIndex;
+	}
+
+	template< class C, cbl::Uint32 PageSize >
+	typename HeapPages<C,PageSize>::Page* HeapPages<C,PageSize>::_PickCompactSource( void )
+	{
+		// Free slots in partly used pages; empty pages don't count, filling them gains nothing.
+		Uint32 freeSlots = 0;
+		for( size_t i = 0; i < mNonFull.size(); ++i ) {
+			if( !mNonFull[i]->Objects.IsEmpty() )
+				freeSlots += mNonFull[i]->Objects.GetFreeCount();
+		}
+
+		Page* source = NULL;
+		for( size_t i = 0; i < mNonFull.size(); ++i ) {
+			Page* page = mNonFull[i];
+			if( page->Objects.IsEmpty() || page->CompactPass == mCompactPass )
+				continue;
+
+			Uint32 live = PageSize - page->Objects.GetFreeCount();
+			if( live <= freeSlots - page->Objects.GetFreeCount() &&
+				( !source || page->Objects.GetFreeCount() > source->Objects.GetFreeCount() ) )
+				source = page;
+		}
+		return source;
+	}
+
+	template< class C, cbl::Uint32 PageSize >
+	typename HeapPages<C,PageSize>::Page* HeapPages<C,PageSize>::_PickCompactTarget( const Page* source ) const
+	{
+		Page* target = NULL;
+		for( size_t i = 0; i < mNonFull.size(); ++i ) {
+			Page* page = mNonFull[i];
+			if( page == source || page->Objects.IsEmpty() )
+				continue;
+			if( !target || page->Objects.GetFreeCount() < target->Objects.GetFreeCount() )
+				target = page;
+		}
+		return target;
+	}
+
+	template< class C, cbl::Uint32 PageSize >
+	typename HeapPages<C,PageSize>::Page* HeapPages<C,PageSize>::_FindPage( const C* mem ) const
+	{
+		if( mem == NULL )
+			return NULL;
+
+		// Find the last page that starts at or before the pointer.
+		const Char* ptr = reinterpret_cast<const Char*>( mem );
+		size_t lo = 0, hi = mPages.size();
+		while( lo < hi ) {
+			size_t mid = ( lo + hi ) / 2;
+			if( mPages[mid]->Objects.GetStorage() <= ptr )
+				lo = mid + 1;
+			else
+				hi = mid;
+		}
+
+		return lo > 0 && mPages[lo-1]->Objects.Owns( mem ) ? mPages[lo-1] : NULL;
+	}
+
+	template< class C, cbl::Uint32 PageSize >
+	inline bool HeapPages<C,PageSize>::_PageLess( const Page* lhs, const Page* rhs )
+	{
+		return lhs->Objects.GetStorage() < rhs->Objects.GetStorage();
+	}
+}
@@ -0,0 +1,156 @@
+/* This source file is part of the Chewable Framework.
+ * For the latest info, please visit http://chewable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file MemBudget.h
+ * @brief Memory budgets per subsystem with soft and hard limits.
+ */
+
+#ifndef __CBL_MEMBUDGET_H_
+#define __CBL_MEMBUDGET_H_
+
+// Chewable Headers //
+#include "cbl/Chewable.h"
+#include "cbl/Core/Event.h"
+#include "cbl/Memory/Allocator.h"
+#include "cbl/Util/Noncopyable.h"
+
+// External Dependencies //
+#include <atomic>
+
+namespace cbl
+{
+	//! Framework memory categories with their own budget.
+	namespace MemCategory
+	{
+		enum Options
+		{
+			Objects,		//!< Object instances.
+			Parts,			//!< Object part instances.
+			Serialisation,	//!< ByteStream buffers (patches, static serialisation), not std::ostream output.
+			Logging,		//!< Log message buffers.
+			Count,
+		};
+	}
+
+	//! Memory pressure levels.
+	namespace MemPressure
+	{
+		enum Options
+		{
+			Soft,			//!< Usage reached the soft limit; shrink caches.
+			Hard,			//!< An allocation would exceed the hard limit; free what you can.
+		};
+	}
+
+	namespace E
+	{
+		typedef cbl::Event< void( MemBudget&, MemPressure::Options ) >	MemoryPressure;	//!< params: budget, pressure level
+	}
+
+	//! Allocator that enforces a memory budget on another allocator.
+	//! OnMemoryPressure is raised with MemPressure::Soft once usage reaches the soft limit,
+	//! and again only after usage has dropped back below it. An allocation that would go
+	//! over the hard limit raises MemPressure::Hard and is retried once; if it still
+	//! doesn't fit, Allocate returns NULL and the failure is counted. Containers using
+	//! StlAllocator get std::bad_alloc, object creation returns NULL.
+	//! Listeners run on the allocating thread and must be thread-safe if the budget is
+	//! shared between threads. A limit of 0 means unlimited.
+	//! Usage counters are atomics and are cheap enough to poll every frame.
+	class CBL_API MemBudget :
+		public Allocator,
+		Noncopyable
+	{
+	/***** Public Static Methods *****/
+	public:
+		//! Get the budget of a framework memory category.
+		//! All categories are unlimited until SetLimits is called.
+		static MemBudget& Get( MemCategory::Options category );
+
+	/***** Public Members *****/
+	public:
+		E::MemoryPressure		OnMemoryPressure;	//!< Triggered at the soft limit and before failing at the hard limit.
+
+	/***** Public Methods *****/
+	public:
+		//! Constructor.
+		//! @param	name		Budget name.
+		//! @param	parent		Allocator that provides the memory.
+		explicit MemBudget( const Char* name, Allocator& parent = Allocator::GetDefault() );
+		virtual void* Allocate( size_t size, size_t align );
+		virtual void Deallocate( void* mem, size_t size, size_t align );
+		//! Set the limits.
+		//! @param	soft		Bytes at which pressure is signalled, 0 for none.
+		//! @param	hard		Bytes that can't be exceeded, 0 for unlimited.
+		void SetLimits( size_t soft, size_t hard );
+		//! Reset the peak to the current usage.
+		void ResetPeak( void );
+		//! Get the budget name.
+		inline const Char* GetName( void ) const { return mName; }
+		//! Get the bytes currently allocated.
+		inline size_t GetUsed( void ) const { return mUsed.load( std::memory_order_relaxed ); }
+		//! Get the highest usage since construction or ResetPeak.
+		inline size_t GetPeak( void ) const { return mPeak.load( std::memory_order_relaxed ); }
+		//! Get the soft limit.
+		inline size_t GetSoftLimit( void ) const { return mSoftLimit.load( std::memory_order_relaxed ); }
+		//! Get the hard limit.
+		inline size_t GetHardLimit( void ) const { return mHardLimit.load( std::memory_order_relaxed ); }
+		//! Get the number of allocations refused at the hard limit.
+		inline size_t GetFailures( void ) const { return mFailures.load( std::memory_order_relaxed ); }
+		//! Check if usage is at or above the soft limit.
+		inline bool IsUnderPressure( void ) const { size_t soft = GetSoftLimit(); return soft > 0 && GetUsed() >= soft; }
+
+	/***** Private Methods *****/
+	private:
+		//! Add bytes to the usage if they fit under the hard limit.
+		//! @param	used	Usage after the reservation.
+		//! @return			False if the bytes don't fit.
+		bool _Reserve( size_t size, size_t& used );
+		//! Raise OnMemoryPressure unless this thread is already handling pressure on this budget.
+		void _RaisePressure( MemPressure::Options pressure );
+
+	/***** Private Members *****/
+	private:
+		const Char*				mName;			//!< Budget name.
+		Allocator&				mParent;		//!< Memory source.
+		std::atomic<size_t>		mUsed;			//!< Bytes currently allocated.
+		std::atomic<size_t>		mPeak;			//!< Highest usage.
+		std::atomic<size_t>		mSoftLimit;		//!< Soft limit.
+		std::atomic<size_t>		mHardLimit;		//!< Hard limit.
+		std::atomic<size_t>		mFailures;		//!< Refused allocations.
+		std::atomic<bool>		mSoftRaised;	//!< Soft pressure signalled and not yet cleared.
+	};
+
+	//! STL allocator bound to the budget of a memory category.
+	//! It is default constructible into the budget, so it also works for standard types
+	//! that can't be handed an allocator instance, such as string streams.
+	template< typename T, MemCategory::Options CATEGORY >
+	class BudgetStlAllocator :
+		public StlAllocator< T >
+	{
+	public:
+		template< typename U >
+		struct rebind { typedef BudgetStlAllocator< U, CATEGORY > other; };
+
+		BudgetStlAllocator() : StlAllocator< T >( MemBudget::Get( CATEGORY ) ) {}
+		template< typename U >
+		BudgetStlAllocator( const BudgetStlAllocator< U, CATEGORY >& rhs ) : StlAllocator< T >( rhs ) {}
+	};
+}
+
+#endif // __CBL_MEMBUDGET_H_
@@ -0,0 +1,178 @@
+/* This source file is part of the Chewable Framework.
+ * For the latest info, please visit http://chewable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file MemTracker.h
+ * @brief Allocation tracking per reflected type and per subsystem tag.
+ */
+
+#ifndef __CBL_MEMTRACKER_H_
+#define __CBL_MEMTRACKER_H_
+
+// Chewable Headers //
+#include "cbl/Chewable.h"
+#include "cbl/Util/CName.h"
+#include "cbl/Util/Noncopyable.h"
+#include "cbl/Util/Singleton.h"
+
+// External Dependencies //
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace cbl
+{
+	//! @brief Memory accounting.
+	//! Records live count, bytes, peaks and allocation totals for every reflected Type,
+	//! and for subsystem tags. Allocations made inside a CBL_MEM_TAG scope are also
+	//! charged to that tag. The hooks in Type::New/Delete and the pool allocators are
+	//! only compiled in when CBL_MEMORY_TRACKING is enabled.
+	//! 
+	//! Usage:
+	//! @code
+	//! cbl::MemTracker::Snapshot before = cbl::MemTracker::Instance().TakeSnapshot();
+	//! // ... play for a while ...
+	//! cbl::MemTracker::Snapshot after = cbl::MemTracker::Instance().TakeSnapshot();
+	//! cbl::MemTracker::DeltaList grown = cbl::MemTracker::Diff( before.Types, after.Types, after.Time - before.Time );
+	//! @endcode
+	class CBL_API MemTracker :
+		Noncopyable
+	{
+	/***** Types *****/
+	public:
+		//! Allocation statistics.
+		struct Stats
+		{
+			Int64			LiveCount;		//!< Live allocations.
+			Int64			LiveBytes;		//!< Live bytes.
+			Int64			PeakCount;		//!< Most live allocations at once.
+			Int64			PeakBytes;		//!< Most live bytes at once.
+			Uint64			Allocations;	//!< Total allocations.
+			Uint64			Frees;			//!< Total frees.
+
+			Stats() : LiveCount( 0 ), LiveBytes( 0 ), PeakCount( 0 ), PeakBytes( 0 ), Allocations( 0 ), Frees( 0 ) {}
+		};
+		typedef std::map< CName, Stats >	StatsTable;		//!< Statistics by type or tag name.
+
+		//! Statistics at a point in time.
+		struct Snapshot
+		{
+			StatsTable		Types;			//!< Per type statistics.
+			StatsTable		Tags;			//!< Per tag statistics.
+			Float64			Time;			//!< Seconds since the tracker started.
+		};
+
+		//! Change in statistics between two snapshots.
+		struct Delta
+		{
+			CName			Name;			//!< Type or tag name.
+			Int64			Count;			//!< Change in live allocations.
+			Int64			Bytes;			//!< Change in live bytes.
+			Uint64			Allocations;	//!< Allocations made in between.
+			Float64			Rate;			//!< Allocations per second in between.
+		};
+		typedef std::vector< Delta >		DeltaList;
+
+	/***** Public Static Methods *****/
+	public:
+		//! Compare two statistics tables.
+		//! @param	before		Earlier table.
+		//! @param	after		Later table.
+		//! @param	seconds		Time between them, used for the allocation rate.
+		//! @return				Entries that changed, largest byte growth first.
+		static DeltaList Diff( const StatsTable& before, const StatsTable& after, Float64 seconds );
+		//! Get the calling thread's current tag, or NULL if there is none.
+		static const CName* GetCurrentTag( void );
+
+	/***** Public Methods *****/
+	public:
+		//! Record an allocation of a reflected type.
+		//! It is also charged to the calling thread's tag, if any.
+		//! @param	type	Allocated type.
+		//! @param	obj		New object.
+		void TrackAllocate( const Type& type, const void* obj );
+		//! Record a free of a reflected type.
+		//! Frees the tag charge made when the object was allocated.
+		//! @param	type	Freed type.
+		//! @param	obj		Object being freed.
+		void TrackFree( const Type& type, const void* obj );
+		//! Record an allocation against a tag.
+		void TrackAllocate( const CName& tag, size_t bytes );
+		//! Record a free against a tag.
+		void TrackFree( const CName& tag, size_t bytes );
+		//! Copy the current statistics.
+		Snapshot TakeSnapshot( void ) const;
+		//! Clear all statistics.
+		void Reset( void );
+
+	/***** Private Types *****/
+	private:
+		typedef std::unordered_map< const void*, CName >	TagTable;
+
+	/***** Private Methods *****/
+	private:
+		MemTracker();
+		static void Add( StatsTable& table, const CName& name, size_t bytes );
+		static void Remove( StatsTable& table, const CName& name, size_t bytes );
+		Float64 GetTime( void ) const;
+
+	/***** Private Members *****/
+	private:
+		mutable std::mutex	mLock;		//!< Guards the tables.
+		StatsTable			mTypes;		//!< Per type statistics.
+		StatsTable			mTags;		//!< Per tag statistics.
+		TagTable			mObjectTags;	//!< Tag each tagged object was allocated under.
+		Int64				mStart;		//!< Start time in clock ticks.
+		CBL_DECL_SINGLETON( MemTracker );
+	};
+
+	//! Charges allocations on this thread to a tag until the scope ends.
+	class CBL_API MemTagScope :
+		Noncopyable
+	{
+	public:
+		//! Constructor.
+		//! @param	tag		Tag name. The text must outlive the tracker, e.g. a string literal.
+		explicit MemTagScope( const CName& tag );
+		//! Destructor. Restores the enclosing tag.
+		~MemTagScope();
+
+	private:
+		CName				mTag;		//!< This scope's tag.
+		const CName*		mPrevious;	//!< Enclosing tag.
+	};
+}
+
+#if CBL_MEMORY_TRACKING == CBL_ENABLED
+//! Charge allocations in the current scope to a tag.
+#define CBL_MEM_TAG( tag )\
+	::cbl::MemTagScope CBL_CONCAT( _memTag, __COUNTER__ )( tag )
+//! Record a tagged allocation.
+#define CBL_MEM_TRACK_ALLOC( tag, bytes )\
+	::cbl::MemTracker::Instance().TrackAllocate( tag, bytes )
+//! Record a tagged free.
+#define CBL_MEM_TRACK_FREE( tag, bytes )\
+	::cbl::MemTracker::Instance().TrackFree( tag, bytes )
+#else
+#define CBL_MEM_TAG( tag )
+#define CBL_MEM_TRACK_ALLOC( tag, bytes )
+#define CBL_MEM_TRACK_FREE( tag, bytes )
+#endif // CBL_MEMORY_TRACKING == CBL_ENABLED
+
+#endif // __CBL_MEMTRACKER_H_
@@ -0,0 +1,105 @@
+/* This source file is part of the Chewable Framework.
+ * For the latest info, please visit http://chewable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file PageArena.h
+ * @brief Virtual memory arena that commits pages on demand, optionally as huge pages.
+ */
+
+#ifndef __CBL_PAGEARENA_H_
+#define __CBL_PAGEARENA_H_
+
+// Chewable Headers //
+#include "cbl/Chewable.h"
+#include "cbl/Memory/Allocator.h"
+#include "cbl/Util/Noncopyable.h"
+
+// External Dependencies //
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace cbl
+{
+	//! Arena over one large reserved range of address space.
+	//! The range is committed CBL_PAGE_ARENA_COMMIT bytes at a time as it fills up, so
+	//! memory stays contiguous and, with huge pages, is covered by far fewer TLB entries
+	//! than the same objects spread over the general heap. Huge pages are requested with
+	//! madvise( MADV_HUGEPAGE ) on Linux; on Windows large pages need a privilege most
+	//! users don't have, so normal pages are used.
+	//! Freed blocks are kept on a free list per size and reused by the next allocation of
+	//! the same size, which suits pool pages. Once the range is used up, allocations fall
+	//! back to the general heap.
+	//! Enable CBL_POOL_PAGE_ARENA in Config.h to back the object pools (Heap storage) with
+	//! a shared arena, see Allocator::GetPool.
+	class CBL_API PageArena :
+		public Allocator,
+		Noncopyable
+	{
+	/***** Public Methods *****/
+	public:
+		//! Constructor. Reserves the address range; nothing is committed yet.
+		//! @param	reserve		Bytes of address space to reserve.
+		//! @param	hugePages	Ask for huge pages when committing.
+		explicit PageArena( size_t reserve, bool hugePages = CBL_PAGE_ARENA_HUGE_PAGES == CBL_ENABLED );
+		//! Destructor. Releases the whole range.
+		virtual ~PageArena();
+		virtual void* Allocate( size_t size, size_t align );
+		virtual void Deallocate( void* mem, size_t size, size_t align );
+		//! Check if a pointer lies in the reserved range.
+		bool Owns( const void* mem ) const;
+		//! Get the bytes of address space reserved.
+		inline size_t GetReserved( void ) const { return mReserved; }
+		//! Get the bytes committed so far.
+		size_t GetCommitted( void ) const;
+		//! Get the bytes handed out, including blocks on the free lists.
+		size_t GetUsed( void ) const;
+		//! Get the number of commit calls made.
+		Uint32 GetCommitCount( void ) const;
+		//! Get the number of allocations that fell back to the general heap.
+		Uint32 GetFallbackCount( void ) const;
+		//! Check if the committed memory was advised to use huge pages.
+		inline bool UsesHugePages( void ) const { return mHugePages; }
+
+	/***** Private Types *****/
+	private:
+		typedef std::unordered_map< size_t, std::vector< void* > >	FreeLists;
+
+	/***** Private Methods *****/
+	private:
+		//! Commit memory up to an offset. The lock must be held.
+		//! @return		False if the OS refused.
+		bool _CommitTo( size_t offset );
+
+	/***** Private Members *****/
+	private:
+		void*				mMapping;		//!< Start of the OS mapping.
+		size_t				mMappingSize;	//!< Size of the OS mapping.
+		Char*				mBase;			//!< Start of the usable range, aligned to the commit size.
+		size_t				mReserved;		//!< Usable range size.
+		size_t				mCommitted;		//!< Committed bytes.
+		size_t				mOffset;		//!< Bytes handed out.
+		Uint32				mCommits;		//!< Number of commits.
+		Uint32				mFallbacks;		//!< Allocations made from the general heap.
+		bool				mHugePages;		//!< Huge pages requested and accepted.
+		FreeLists			mFree;			//!< Freed blocks by size.
+		mutable std::mutex	mLock;			//!< Guards the arena.
+	};
+}
+
+#endif // __CBL_PAGEARENA_H_
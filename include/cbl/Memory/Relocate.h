@@ -0,0 +1,64 @@
+/* This source file is part of the Chewable Framework.
+ * For the latest info, please visit http://chewable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file Relocate.h
+ * @brief Object relocation hooks used when compacting pools.
+ */
+
+#ifndef __CBL_RELOCATE_H_
+#define __CBL_RELOCATE_H_
+
+// Chewable Headers //
+#include "cbl/Chewable.h"
+
+// External Dependencies //
+#include <type_traits>
+#include <utility>
+
+namespace cbl
+{
+	//! Relocate an object: construct it at dst from src, then destroy src.
+	typedef void (*RelocateFunc)( void* dst, void* src );
+
+	namespace detail
+	{
+		template< typename TYPE >
+		inline void MoveRelocate( void* dst, void* src ) {
+			TYPE* obj = static_cast< TYPE* >( src );
+			new (dst) TYPE( std::move( *obj ) );
+			obj->~TYPE();
+		}
+
+		template< typename TYPE >
+		inline RelocateFunc GetRelocator( std::true_type ) { return &MoveRelocate< TYPE >; }
+
+		template< typename TYPE >
+		inline RelocateFunc GetRelocator( std::false_type ) { return NULL; }
+	}
+
+	//! Get the default relocation hook for a type.
+	//! @return		Hook that move (or copy) constructs the object, or NULL if the type can't be
+	//!				moved; such types need a hook registered with Type::Relocator.
+	template< typename TYPE >
+	inline RelocateFunc DefaultRelocator( void ) {
+		return detail::GetRelocator< TYPE >( typename std::is_move_constructible< TYPE >::type() );
+	}
+}
+
+#endif // __CBL_RELOCATE_H_
@@ -0,0 +1,135 @@
+/* This source file is part of the Chewable Framework.
+ * For the latest info, please visit http://chewable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file SharedPool.h
+ * @brief Thread-safe object pool with per-thread magazines.
+ */
+
+#ifndef __CBL_SHAREDPOOL_H_
+#define __CBL_SHAREDPOOL_H_
+
+// Chewable Headers //
+#include "cbl/Chewable.h"
+#include "cbl/Memory/HeapPages.h"
+
+// External Dependencies //
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace cbl
+{
+	//! Object pool that can be shared between threads.
+	//! Each thread that allocates gets a magazine, a small stack of free slots in front
+	//! of the shared HeapPages. Allocating and freeing only touch the calling thread's
+	//! magazine; it is refilled from, or drained to, the shared pages half a magazine
+	//! at a time under the pool lock.
+	//! Threads that free objects without ever allocating from the pool (e.g. a loader
+	//! handing objects over to the main thread) push them onto a lock-free remote-free
+	//! list instead, which allocating threads take over on their next refill.
+	//! When a thread exits its magazine is orphaned and the slots are returned on the
+	//! next refill, drain or Trim.
+	//! Deallocate doesn't validate pointers on the fast path; only free objects that
+	//! came from this pool.
+	template< class C, cbl::Uint32 PageSize = 1024, cbl::Uint32 MagazineSize = 64 >
+	class SharedPool
+	{
+	/***** Public Methods *****/
+	public:
+		//! Constructor.
+		//! @param	maxEmptyPages	Number of empty pages to keep around before releasing them.
+		explicit SharedPool( Uint32 maxEmptyPages = 1 );
+		//! Destructor.
+		~SharedPool();
+		//! Construct an object in the pool, forwarding the arguments to its constructor.
+		//! @return		New object.
+		template< typename... Args >
+		C* Allocate( Args&&... args );
+		//! Destroy an object and return its slot to the pool.
+		void Deallocate( C* mem );
+		//! Return the calling thread's magazine to the shared pages.
+		void Flush( void );
+		//! Return orphaned magazines and the remote-free list to the shared pages.
+		void Trim( void );
+		//! Get the number of allocated pages.
+		Uint32 GetPageCount( void ) const;
+		//! Get the number of magazines, including orphaned ones not yet returned.
+		Uint32 GetMagazineCount( void ) const;
+
+	/***** Private Types *****/
+	private:
+		//! Per thread stack of free slots.
+		struct Magazine
+		{
+			C*					Slots[MagazineSize];	//!< Free slots.
+			Uint32				Count;					//!< Number of free slots.
+			std::atomic<bool>	Orphaned;				//!< Set when the owning thread exits.
+			std::atomic<bool>	Detached;				//!< Set when the pool is destroyed.
+
+			Magazine() : Count( 0 ), Orphaned( false ), Detached( false ) {}
+		};
+		typedef std::shared_ptr<Magazine>	MagazinePtr;
+		typedef std::vector<MagazinePtr>	MagazineList;
+
+		//! Magazines of the calling thread, keyed by pool id.
+		struct ThreadCache
+		{
+			typedef std::pair< Uint64, MagazinePtr >	Entry;
+			std::vector<Entry>	Entries;
+
+			~ThreadCache();
+		};
+
+		static const Uint32 BatchSize = MagazineSize / 2;
+
+	/***** Private Methods *****/
+	private:
+		SharedPool( const SharedPool& );
+		SharedPool& operator = ( const SharedPool& );
+		//! Get the calling thread's magazine cache.
+		static ThreadCache& _GetThreadCache( void );
+		//! Find the calling thread's magazine.
+		//! @return		Magazine, or NULL if the thread hasn't allocated from this pool.
+		Magazine* _FindMagazine( void ) const;
+		//! Find or create the calling thread's magazine.
+		Magazine& _GetMagazine( void );
+		//! Fill an empty magazine from the remote-free list and the shared pages.
+		void _Refill( Magazine& magazine );
+		//! Return half of a full magazine to the shared pages.
+		void _Drain( Magazine& magazine );
+		//! Push a slot onto the remote-free list.
+		void _PushRemote( C* mem );
+		//! Return orphaned magazines to the shared pages. The pool lock must be held.
+		void _ReclaimOrphans( void );
+
+	/***** Private Members *****/
+	private:
+		const Uint64			mId;			//!< Unique pool id, never reused.
+		HeapPages<C,PageSize>	mPages;			//!< Shared pages.
+		MagazineList			mMagazines;		//!< All thread magazines.
+		std::atomic<C*>			mRemote;		//!< Remote-free list, linked through the slots.
+		mutable std::mutex		mLock;			//!< Guards the pages and the magazine list.
+	};
+}
+
+#include "SharedPool.inl"
+
+#endif // __CBL_SHAREDPOOL_H_
@@ -0,0 +1,233 @@
+/* This source file is part of the Chewable Framework.
+ * For the latest info, please visit http://chewable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file SharedPool.inl
+ * @brief Thread-safe object pool with per-thread magazines.
+ */
+
+namespace cbl
+{
+	namespace detail
+	{
+		//! Get a new shared pool id. Ids are never reused, so stale thread cache entries can't match a new pool.
+		inline Uint64 NextSharedPoolId( void )
+		{
+			static std::atomic<Uint64> sNextId( 1 );
+			return sNextId.fetch_add( 1, std::memory_order_relaxed );
+		}
+	}
+
+	template< class C, cbl::Uint32 PageSize, cbl::Uint32 MagazineSize >
+	SharedPool<C,PageSize,MagazineSize>::SharedPool( Uint32 maxEmptyPages )
+	: mId( detail::NextSharedPoolId() )
+	, mPages( maxEmptyPages )
+	, mRemote( NULL )
+	{
+		static_assert( sizeof(C) >= sizeof(C*), "Remote-free list links through the slots; objects must be at least pointer sized." );
+		static_assert( MagazineSize >= 2, "Magazines must hold at least two slots." );
+	}
+
+	template< class C, cbl::Uint32 PageSize, cbl::Uint32 MagazineSize >
+	SharedPool<C,PageSize,MagazineSize>::~SharedPool()
+	{
+		std::lock_guard< std::mutex > lock( mLock );
+		for( size_t i = 0; i < mMagazines.size(); ++i )
+			mMagazines[i]->Detached.store( true, std::memory_order_release );
+		mMagazines.clear();
+	}
+
+	template< class C, cbl::Uint32 PageSize, cbl::Uint32 MagazineSize >
+	template< typename... Args >
+	inline C* SharedPool<C,PageSize,MagazineSize>::Allocate( Args&&... args )
+	{
+		Magazine& magazine = _GetMagazine();
+		if( magazine.Count == 0 )
+			_Refill( magazine );
+
+		return new ( magazine.Slots[--magazine.Count] ) C( std::forward<Args>( args )... );
+	}
+
+	template< class C, cbl::Uint32 PageSize, cbl::Uint32 MagazineSize >
+	inline void SharedPool<C,PageSize,MagazineSize>::Deallocate( C* mem )
+	{
+		if( mem == NULL )
+			return;
+
+		mem->~C();
+
+		Magazine* magazine = _FindMagazine();
+		if( !magazine ) {
+			_PushRemote( mem );
+			return;
+		}
+
+		if( magazine->Count == MagazineSize )
+			_Drain( *magazine );
+		magazine->Slots[magazine->Count++] = mem;
+	}
+
+	template< class C, cbl::Uint32 PageSize, cbl::Uint32 MagazineSize >
+	void SharedPool<C,PageSize,MagazineSize>::Flush( void )
+	{
+		Magazine* magazine = _FindMagazine();
+		if( !magazine )
+			return;
+
+		std::lock_guard< std::mutex > lock( mLock );
+		while( magazine->Count > 0 )
+			mPages.DeallocateSlot( magazine->Slots[--magazine->Count] );
+	}
+
+	template< class C, cbl::Uint32 PageSize, cbl::Uint32 MagazineSize >
+	void SharedPool<C,PageSize,MagazineSize>::Trim( void )
+	{
+		C* remote = mRemote.exchange( NULL, std::memory_order_acquire );
+
+		std::lock_guard< std::mutex > lock( mLock );
+		while( remote ) {
+			C* next;
+			memcpy( &next, remote, sizeof(next) );
+			mPages.DeallocateSlot( remote );
+			remote = next;
+		}
+		_ReclaimOrphans();
+	}
+
+	template< class C, cbl::Uint32 PageSize, cbl::Uint32 MagazineSize >
+	Uint32 SharedPool<C,PageSize,MagazineSize>::GetPageCount( void ) const
+	{
+		std::lock_guard< std::mutex > lock( mLock );
+		return mPages.GetPageCount();
+	}
+
+	template< class C, cbl::Uint32 PageSize, cbl::Uint32 MagazineSize >
+	Uint32 SharedPool<C,PageSize,MagazineSize>::GetMagazineCount( void ) const
+	{
+		std::lock_guard< std::mutex > lock( mLock );
+		return Uint32( mMagazines.size() );
+	}
+
+	template< class C, cbl::Uint32 PageSize, cbl::Uint32 MagazineSize >
+	SharedPool<C,PageSize,MagazineSize>::ThreadCache::~ThreadCache()
+	{
+		for( size_t i = 0; i < Entries.size(); ++i )
+			Entries[i].second->Orphaned.store( true, std::memory_order_release );
+	}
+
+	template< class C, cbl::Uint32 PageSize, cbl::Uint32 MagazineSize >
+	inline typename SharedPool<C,PageSize,MagazineSize>::ThreadCache& SharedPool<C,PageSize,MagazineSize>::_GetThreadCache( void )
+	{
+		static thread_local ThreadCache sCache;
+		return sCache;
+	}
+
+	template< class C, cbl::Uint32 PageSize, cbl::Uint32 MagazineSize >
+	inline typename SharedPool<C,PageSize,MagazineSize>::Magazine* SharedPool<C,PageSize,MagazineSize>::_FindMagazine( void ) const
+	{
+		ThreadCache& cache = _GetThreadCache();
+		for( size_t i = 0; i < cache.Entries.size(); ++i ) {
+			if( cache.Entries[i].first == mId )
+				return cache.Entries[i].second.get();
+		}
+		return NULL;
+	}
+
+	template< class C, cbl::Uint32 PageSize, cbl::Uint32 MagazineSize >
+	inline typename SharedPool<C,PageSize,MagazineSize>::Magazine& SharedPool<C,PageSize,MagazineSize>::_GetMagazine( void )
+	{
+		Magazine* magazine = _FindMagazine();
+		if( magazine )
+			return *magazine;
+
+		MagazinePtr newMagazine = std::make_shared<Magazine>();
+		{
+			std::lock_guard< std::mutex > lock( mLock );
+			mMagazines.push_back( newMagazine );
+		}
+
+		// Drop entries of pools that have since been destroyed.
+		ThreadCache& cache = _GetThreadCache();
+		for( size_t i = cache.Entries.size(); i > 0; --i ) {
+			if( cache.Entries[i-1].second->Detached.load( std::memory_order_acquire ) )
+				cache.Entries.erase( cache.Entries.begin() + ( i - 1 ) );
+		}
+		cache.Entries.push_back( typename ThreadCache::Entry( mId, newMagazine ) );
+		return *newMagazine;
+	}
+
+	template< class C, cbl::Uint32 PageSize, cbl::Uint32 MagazineSize >
+	void SharedPool<C,PageSize,MagazineSize>::_Refill( Magazine& magazine )
+	{
+		// Take over the remote-free list first; it needs no lock.
+		C* remote = mRemote.exchange( NULL, std::memory_order_acquire );
+		while( remote && magazine.Count < MagazineSize ) {
+			magazine.Slots[magazine.Count++] = remote;
+			memcpy( &remote, remote, sizeof(remote) );
+		}
+
+		if( magazine.Count >= BatchSize && !remote )
+			return;
+
+		std::lock_guard< std::mutex > lock( mLock );
+		while( remote ) {
+			C* next;
+			memcpy( &next, remote, sizeof(next) );
+			mPages.DeallocateSlot( remote );
+			remote = next;
+		}
+		_ReclaimOrphans();
+
+		while( magazine.Count < BatchSize )
+			magazine.Slots[magazine.Count++] = mPages.AllocateSlot();
+	}
+
+	template< class C, cbl::Uint32 PageSize, cbl::Uint32 MagazineSize >
+	void SharedPool<C,PageSize,MagazineSize>::_Drain( Magazine& magazine )
+	{
+		std::lock_guard< std::mutex > lock( mLock );
+		for( Uint32 i = 0; i < BatchSize; ++i )
+			mPages.DeallocateSlot( magazine.Slots[--magazine.Count] );
+		_ReclaimOrphans();
+	}
+
+	template< class C, cbl::Uint32 PageSize, cbl::Uint32 MagazineSize >
+	inline void SharedPool<C,PageSize,MagazineSize>::_PushRemote( C* mem )
+	{
+		C* head = mRemote.load( std::memory_order_relaxed );
+		do {
+			memcpy( mem, &head, sizeof(head) );
+		} while( !mRemote.compare_exchange_weak( head, mem, std::memory_order_release, std::memory_order_relaxed ) );
+	}
+
+	template< class C, cbl::Uint32 PageSize, cbl::Uint32 MagazineSize >
+	void SharedPool<C,PageSize,MagazineSize>::_ReclaimOrphans( void )
+	{
+		for( size_t i = mMagazines.size(); i > 0; --i ) {
+			Magazine& magazine = *mMagazines[i-1];
+			if( !magazine.Orphaned.load( std::memory_order_acquire ) )
+				continue;
+
+			while( magazine.Count > 0 )
+				mPages.DeallocateSlot( magazine.Slots[--magazine.Count] );
+
+			mMagazines[i-1] = mMagazines.back();
+			mMagazines.pop_back();
+		}
+	}
+}
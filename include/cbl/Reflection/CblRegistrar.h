@@ -30,18 +30,21 @@
 namespace cbl
 {
 	//! Chewable registrar.
-	//! Takes care of registering all chewable types.
+	//! Takes care of registering all chewable types. They are added to CBL_ENT as a
+	//! module at startup and registered on first use.
 	class CBL_API CblRegistrar
 	{
 	/***** Public Static Methods *****/
 	public:
-		//! Register Chewable types in the CBL_ENT.
+		//! Register Chewable types in the CBL_ENT now, if they aren't already.
 		static void RegisterCblTypes( void );
 
 	/***** Private Methods *****/
 	private:
 		//! Constructor.
 		CblRegistrar();
+		//! Module registration function, see TypeDB::AddModule.
+		static void _Register( TypeDB& typedb );
 		
 	/***** Private Members *****/
 	private:
@@ -103,22 +103,68 @@ namespace cbl
 				return false;
 			}
 
+			virtual void Clear( void ) {
+				// Arrays have a fixed size; start overwriting from the front.
+				mPosition = 0;
+			}
+
+			virtual void* InsertEmpty( Uint32 ) {
+				CBL_FAIL( "Implementation not supported." );
+				return NULL;
+			}
+
+			virtual bool EraseAt( Uint32 ) {
+				CBL_FAIL( "Implementation not supported." );
+				return false;
+			}
+
+			virtual bool Erase( const void* ) {
+				CBL_FAIL( "Implementation not supported." );
+				return false;
+			}
+
+			virtual bool Truncate( Uint32 count ) {
+				// Arrays have a fixed size.
+				return count >= LENGTH;
+			}
+
 		private:
 			TYPE*	mContainer;
 			Uint32	mPosition;
 		};
 
+		template< typename TYPE, int LENGTH >
+		class ArrayContainer_Impl :
+			public FieldContainer_Impl< TYPE, ArrayReadIterator_Impl<TYPE, LENGTH>, ArrayWriteIterator_Impl<TYPE, LENGTH> >
+		{
+		public:
+			ArrayContainer_Impl() {
+				this->IsContiguous	= true;
+				this->Stride		= sizeof( TYPE );
+			}
+
+			virtual void* GetData( const void* container ) const {
+				return (TYPE*)container;
+			}
+
+			virtual Uint32 GetCount( const void* ) const {
+				return LENGTH;
+			}
+
+			virtual bool Resize( void*, Uint32 count ) const {
+				return count == LENGTH;
+			}
+		};
+
 		//! POD array container creation specialization.
 		template <typename TYPE, int LENGTH>
-		FieldContainer* CreateContainer( TYPE (&)[LENGTH] )
+		FieldContainer* CreateContainer( TYPE (&)[LENGTH], Allocator& storage )
 		{
-			FieldContainer* cont = new FieldContainer_Impl<
-				TYPE,
-				ArrayReadIterator_Impl<TYPE, LENGTH>,
-				ArrayWriteIterator_Impl<TYPE, LENGTH> >();
+			FieldContainer* cont = NewContainer< ArrayContainer_Impl<TYPE, LENGTH> >( storage );
 
 			cont->ValueType			= &CBL_ENT.Types.Create<TYPE>();
 			cont->IsValuePointer	= IsPtr<TYPE>::Value;
+			cont->IsFixedSize		= true;
 
 			return cont;
 		}
@@ -34,6 +34,7 @@
 // External Libraries //
 #include <map>
 #include <unordered_map>
+#include <iterator>
 
 namespace cbl
 {
@@ -112,50 +113,85 @@ namespace cbl
 				return &mContainer[ *(KeyType*)key ];
 			}
 
+			virtual void Clear( void ) {
+				mContainer.clear();
+			}
+
+			virtual void* InsertEmpty( Uint32 ) {
+				CBL_FAIL( "Implementation not supported." );
+				return NULL;
+			}
+
+			virtual bool EraseAt( Uint32 ) {
+				CBL_FAIL( "Implementation not supported." );
+				return false;
+			}
+
+			virtual bool Erase( const void* key ) {
+				return mContainer.erase( *( const KeyType* )key ) > 0;
+			}
+
+			virtual bool Truncate( Uint32 count ) {
+				if( count < mContainer.size() ) {
+					Iterator it = mContainer.begin();
+					std::advance( it, count );
+					mContainer.erase( it, mContainer.end() );
+				}
+				return true;
+			}
+
 		private:
 			MAP_TYPE&	mContainer;
 		};
 
+		template< typename MAP_TYPE >
+		class MapContainer_Impl :
+			public FieldContainer_Impl< MAP_TYPE, MapReadIterator_Impl< MAP_TYPE >, MapWriteIterator_Impl< MAP_TYPE > >
+		{
+		public:
+			virtual const void* Find( const void* container, const void* key ) const {
+				const MAP_TYPE& map = *(const MAP_TYPE*)container;
+				typename MAP_TYPE::const_iterator it = map.find( *(const typename MAP_TYPE::key_type*)key );
+				return it == map.end() ? NULL : &it->second;
+			}
+		};
+
 		//! std::map container creation specialization.
 		template< typename KEY, typename DATA, typename COMPARE, typename ALLOC >
-		FieldContainer* CreateContainer( std::map<KEY, DATA, COMPARE, ALLOC>& )
+		FieldContainer* CreateContainer( std::map<KEY, DATA, COMPARE, ALLOC>&, Allocator& storage )
 		{
 			// Can't deal with keys that are pointers
 			static_assert( !IsPtr<KEY>::Value, "Container keys cannot be pointer to pointer types." );
 
 			typedef typename std::map<KEY, DATA, COMPARE, ALLOC> MapType;
 
-			FieldContainer* cont = new FieldContainer_Impl<
-				MapType,
-				MapReadIterator_Impl<MapType>,
-				MapWriteIterator_Impl<MapType> >();
+			FieldContainer* cont = NewContainer< MapContainer_Impl< MapType > >( storage );
 
 			cont->KeyType			= &CBL_ENT.Types.Create<KEY>();
 			cont->ValueType			= &CBL_ENT.Types.Create<DATA>();
 			cont->IsKeyPointer		= IsPtr<KEY>::Value;
 			cont->IsValuePointer	= IsPtr<DATA>::Value;
+			cont->IsKeyed			= true;
 
 			return cont;
 		}
 
 		//! std::unordered_map container creation specialization.
 		template< typename KEY, typename DATA, typename COMPARE, typename ALLOC >
-		FieldContainer* CreateContainer( std::unordered_map<KEY, DATA, COMPARE, ALLOC>& )
+		FieldContainer* CreateContainer( std::unordered_map<KEY, DATA, COMPARE, ALLOC>&, Allocator& storage )
 		{
 			// Can't deal with keys that are pointers
 			static_assert( !IsPtr<KEY>::Value, "Container keys cannot be pointer to pointer types." );
 
 			typedef typename std::unordered_map<KEY, DATA, COMPARE, ALLOC> MapType;
 
-			FieldContainer* cont = new FieldContainer_Impl<
-				MapType,
-				MapReadIterator_Impl<MapType>,
-				MapWriteIterator_Impl<MapType> >();
+			FieldContainer* cont = NewContainer< MapContainer_Impl< MapType > >( storage );
 
 			cont->KeyType			= &CBL_ENT.Types.Create<KEY>();
 			cont->ValueType			= &CBL_ENT.Types.Create<DATA>();
 			cont->IsKeyPointer		= IsPtr<KEY>::Value;
 			cont->IsValuePointer	= IsPtr<DATA>::Value;
+			cont->IsKeyed			= true;
 
 			return cont;
 		}
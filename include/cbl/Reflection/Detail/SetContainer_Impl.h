@@ -34,6 +34,7 @@
 // External Libraries //
 #include <set>
 #include <unordered_set>
+#include <iterator>
 
 namespace cbl
 {
@@ -111,46 +112,81 @@ namespace cbl
 				return NULL;
 			}
 
+			virtual void Clear( void ) {
+				mContainer.clear();
+			}
+
+			virtual void* InsertEmpty( Uint32 ) {
+				CBL_FAIL( "Implementation not supported." );
+				return NULL;
+			}
+
+			virtual bool EraseAt( Uint32 ) {
+				CBL_FAIL( "Implementation not supported." );
+				return false;
+			}
+
+			virtual bool Erase( const void* key ) {
+				return mContainer.erase( *( const ValueType* )key ) > 0;
+			}
+
+			virtual bool Truncate( Uint32 count ) {
+				if( count < mContainer.size() ) {
+					Iterator it = mContainer.begin();
+					std::advance( it, count );
+					mContainer.erase( it, mContainer.end() );
+				}
+				return true;
+			}
+
 		private:
 			SET_TYPE&	mContainer;
 		};
 
+		template< typename SET_TYPE >
+		class SetContainer_Impl :
+			public FieldContainer_Impl< SET_TYPE, SetReadIterator_Impl< SET_TYPE >, SetWriteIterator_Impl< SET_TYPE > >
+		{
+		public:
+			virtual const void* Find( const void* container, const void* key ) const {
+				const SET_TYPE& set = *(const SET_TYPE*)container;
+				typename SET_TYPE::const_iterator it = set.find( *(const typename SET_TYPE::key_type*)key );
+				return it == set.end() ? NULL : &*it;
+			}
+		};
+
 		//! std::set container creation specialization.
 		template< typename KEY, typename COMPARE, typename ALLOC >
-		FieldContainer* CreateContainer( std::set<KEY, COMPARE, ALLOC>& )
+		FieldContainer* CreateContainer( std::set<KEY, COMPARE, ALLOC>&, Allocator& storage )
 		{
 			// Can't deal with keys that are pointers
 			static_assert( !IsPtr<KEY>::Value, "Container keys cannot be pointer to pointer types." );
 
 			typedef typename std::set<KEY, COMPARE, ALLOC> SetType;
 
-			FieldContainer* cont = new FieldContainer_Impl<
-				SetType,
-				SetReadIterator_Impl<SetType>,
-				SetWriteIterator_Impl<SetType> >();
+			FieldContainer* cont = NewContainer< SetContainer_Impl< SetType > >( storage );
 
 			cont->ValueType			= &CBL_ENT.Types.Create<KEY>();
 			cont->IsValuePointer	= IsPtr<KEY>::Value;
+			cont->IsKeyed			= true;
 
 			return cont;
 		}
 
 		//! std::unordered_set container creation specialization.
 		template< typename KEY, typename COMPARE, typename ALLOC >
-		FieldContainer* CreateContainer( std::unordered_set<KEY, COMPARE, ALLOC>& )
+		FieldContainer* CreateContainer( std::unordered_set<KEY, COMPARE, ALLOC>&, Allocator& storage )
 		{
 			// Can't deal with keys that are pointers
 			static_assert( !IsPtr<KEY>::Value, "Container keys cannot be pointer to pointer types." );
 
 			typedef typename std::unordered_set<KEY, COMPARE, ALLOC> SetType;
 
-			FieldContainer* cont = new FieldContainer_Impl<
-				SetType,
-				SetReadIterator_Impl<SetType>,
-				SetWriteIterator_Impl<SetType> >();
+			FieldContainer* cont = NewContainer< SetContainer_Impl< SetType > >( storage );
 
 			cont->ValueType			= &CBL_ENT.Types.Create<KEY>();
 			cont->IsValuePointer	= IsPtr<KEY>::Value;
+			cont->IsKeyed			= true;
 
 			return cont;
 		}
@@ -99,18 +99,66 @@ namespace cbl
 				return false;
 			}
 
+			virtual void Clear( void ) {
+				mContainer.clear();
+			}
+
+			virtual void* InsertEmpty( Uint32 index ) {
+				if( index > mContainer.size() ) return NULL;
+				return &( *mContainer.insert( mContainer.begin() + index, typename VECTOR_TYPE::value_type() ) );
+			}
+
+			virtual bool EraseAt( Uint32 index ) {
+				if( index >= mContainer.size() ) return false;
+				mContainer.erase( mContainer.begin() + index );
+				return true;
+			}
+
+			virtual bool Erase( const void* ) {
+				CBL_FAIL( "Implementation not supported." );
+				return false;
+			}
+
+			virtual bool Truncate( Uint32 count ) {
+				if( count < mContainer.size() )
+					mContainer.erase( mContainer.begin() + count, mContainer.end() );
+				return true;
+			}
+
 		private:
 			VECTOR_TYPE&	mContainer;
 		};
 
+		template< typename VECTOR_TYPE >
+		class VectorContainer_Impl :
+			public FieldContainer_Impl< VECTOR_TYPE, VectorReadIterator_Impl< VECTOR_TYPE >, VectorWriteIterator_Impl< VECTOR_TYPE > >
+		{
+		public:
+			VectorContainer_Impl() {
+				this->IsContiguous	= true;
+				this->Stride		= sizeof( typename VECTOR_TYPE::value_type );
+			}
+
+			virtual void* GetData( const void* container ) const {
+				VECTOR_TYPE& vec = *(VECTOR_TYPE*)container;
+				return vec.empty() ? NULL : &vec[0];
+			}
+
+			virtual Uint32 GetCount( const void* container ) const {
+				return Uint32( ((const VECTOR_TYPE*)container)->size() );
+			}
+
+			virtual bool Resize( void* container, Uint32 count ) const {
+				((VECTOR_TYPE*)container)->resize( count );
+				return true;
+			}
+		};
+
 		//! POD array container creation specialization.
 		template <typename TYPE, typename ALLOCATOR>
-		FieldContainer* CreateContainer( std::vector<TYPE, ALLOCATOR>& )
+		FieldContainer* CreateContainer( std::vector<TYPE, ALLOCATOR>&, Allocator& storage )
 		{
-			FieldContainer* cont = new FieldContainer_Impl<
-				std::vector<TYPE, ALLOCATOR>,
-				VectorReadIterator_Impl< std::vector<TYPE, ALLOCATOR> >,
-				VectorWriteIterator_Impl< std::vector<TYPE, ALLOCATOR> > >();
+			FieldContainer* cont = NewContainer< VectorContainer_Impl< std::vector<TYPE, ALLOCATOR> > >( storage );
 
 			cont->ValueType			= &CBL_ENT.Types.Create<TYPE>();
 			cont->IsValuePointer	= IsPtr<TYPE>::Value;
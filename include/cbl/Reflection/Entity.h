@@ -78,6 +78,20 @@ namespace cbl
 
 	//! Entity pointer type.
 	typedef Entity*	EntityPtr;
+
+	//! Checked downcast using the entity's reflected type.
+	//! @tparam	TYPE		Registered type derived from Entity.
+	//! @return				Entity as TYPE, or NULL if it's NULL or not of that type.
+	template< typename TYPE >
+	inline TYPE* TypeCast( Entity* entity ) {
+		return entity && entity->GetType().IsType< TYPE >() ? static_cast< TYPE* >( entity ) : NULL;
+	}
+
+	//! Checked downcast using the entity's reflected type.
+	template< typename TYPE >
+	inline const TYPE* TypeCast( const Entity* entity ) {
+		return entity && entity->GetType().IsType< TYPE >() ? static_cast< const TYPE* >( entity ) : NULL;
+	}
 }
 
 //! Entity type test macro. Used to test for type dependencies at compile-time.
@@ -28,57 +28,12 @@
 // Chewable Headers //
 #include "cbl/Chewable.h"
 #include "cbl/Util/CName.h"
-#include "cbl/Util/SharedPtr.h"
+#include "cbl/Memory/Allocator.h"
 #include "cbl/Reflection/FieldContainer.h"
+#include "cbl/Reflection/FieldAttr.h"
 
 namespace cbl
 {
-#pragma warning( push )
-// Disable the unnamed struct warnings.
-#pragma warning( disable : 4201 )
-
-	//! Field attributes.
-	class CBL_API FieldAttr
-	{
-	/***** Types *****/
-	public:
-		enum {
-			F_READONLY		= 0x01,
-			F_TRANSIENT		= 0x02,
-			F_INLINE		= 0x04,
-			F_HEX			= 0x08,
-			F_CHANGEREFRESH	= 0x10,
-		};
-		
-	/***** Public Methods *****/
-	public:
-		//! Constructor.
-		FieldAttr() : Group(NULL), Value( 0 ) {}
-		//! Constructor.
-		//! @param	val		Attribute values.
-		FieldAttr( Uint32 val ) : Group(NULL), Value( val ) {}
-		//! Constructor.
-		//! @param	group	Field group.
-		//! @param	val		Attribute values.
-		FieldAttr( const Char* group, Uint32 val ) : Group(group), Value( val ) {}
-		
-	/***** Public Members *****/
-	public:
-		const Char* Group;
-		union {
-			struct {
-				Uint32 ReadOnly			: 1;	//!< Read-only field.
-				Uint32 Transient		: 1;	//!< Transient field (not serialisable).
-				Uint32 Inline			: 1;	//!< Inline output field.
-				Uint32 Hex				: 1;	//!< Hex value field.
-				Uint32 ChangeRefresh	: 1;	//!< Indicates if editor needs to be refreshed when this value is set.
-				Uint32 Unused			: 27;	//!< Unused flags.
-			};
-			Uint32 Value;	//! Field attribute value.
-		};
-	};
-#pragma warning( pop ) 
-
 	/***** Forward Declarations *****/
 	class Type;
 
@@ -93,11 +48,12 @@ namespace cbl
 		//! @param	name		Field name.
 		//! @param	type		Field type.
 		//! @param	attrs		Field attributes.
+		//! @param	storage		Memory for the field container, never freed individually.
 		//! @param	group		Field grouping.
 		//! @param	desc		Field description.
 		template< typename ENTITY_TYPE, typename FIELD_TYPE >
 		Field( const CName& name, const cbl::Type* type, FIELD_TYPE ENTITY_TYPE::*field, FieldAttr attrs,
-			const Char* group = NULL, const Char* desc = NULL );
+			Allocator& storage, const Char* group = NULL, const Char* desc = NULL );
 
 		//! Get pointer to field data.
 		//! @param	ent		Base object.
@@ -109,7 +65,7 @@ namespace cbl
 		const cbl::Type*			Type;		//!< Field type.
 		bool						IsPointer;	//!< Is field pointer?
 		size_t						Offset;		//!< Field memory offset.
-		SharedPtr<FieldContainer>	Container;	//!< Field container. NULL if this is not a container.
+		FieldContainer*				Container;	//!< Field container, owned by the TypeDB. NULL if this is not a container.
 		CName						Name;		//!< Field name.
 		CName						Group;		//!< Field grouping.
 		CName						Desc;		//!< Field description.
@@ -30,10 +30,10 @@
 namespace cbl
 {
 	template< typename ENTITY_TYPE, typename FIELD_TYPE >
-	inline Field::Field( const CName& name, const cbl::Type* type, FIELD_TYPE ENTITY_TYPE::*field, FieldAttr attrs, const Char* group, const Char* desc )
+	inline Field::Field( const CName& name, const cbl::Type* type, FIELD_TYPE ENTITY_TYPE::*field, FieldAttr attrs, Allocator& storage, const Char* group, const Char* desc )
 	: Type( type ), IsPointer( IsPtr<FIELD_TYPE>::Value ), Offset( offsetof( ENTITY_TYPE, *field ) ), Name( name ), Attributes( attrs )
 	, Group( group ), Desc( desc )
 	{
-		Container = SharedPtr<FieldContainer>( detail::CreateContainer( ((ENTITY_TYPE*)0)->*field ) );
+		Container = detail::CreateContainer( ((ENTITY_TYPE*)0)->*field, storage );
 	}
 }
@@ -28,6 +28,7 @@
 // Chewable Headers //
 #include "cbl/Chewable.h"
 #include "cbl/Util/Noncopyable.h"
+#include "cbl/Memory/Allocator.h"
 
 namespace cbl
 {
@@ -63,6 +64,16 @@ namespace cbl
 		virtual bool Add( void* key, void* obj )	= 0;
 		virtual void* AddEmpty( void )				= 0;
 		virtual void* AddEmpty( void* key )			= 0;
+		virtual void Clear( void )					= 0;
+		//! Insert a default value before a position in a sequence.
+		//! @return		New value, NULL if the position is past the end.
+		virtual void* InsertEmpty( Uint32 index )	= 0;
+		//! Erase the value at a position in a sequence.
+		virtual bool EraseAt( Uint32 index )		= 0;
+		//! Erase a key from a map, or a value from a set.
+		virtual bool Erase( const void* key )		= 0;
+		//! Keep only the first count elements.
+		virtual bool Truncate( Uint32 count )		= 0;
 
 		template<typename T>
 		inline bool Add(T obj) { return Add(static_cast<void*>(&obj)); }
@@ -92,13 +103,40 @@ namespace cbl
 		const Type*		ValueType;		//!< Container value type.
 		bool			IsKeyPointer;	//!< Is key pointer?
 		bool			IsValuePointer;	//!< Is value pointer?
+		bool			IsKeyed;		//!< Are elements found by key (maps) or value (sets) rather than position?
+		bool			IsFixedSize;	//!< Is the element count fixed (arrays)?
+		bool			IsContiguous;	//!< Are the values laid out in one block (vectors, arrays)? See GetData.
+		Uint32			Stride;			//!< Distance in bytes between contiguous values, 0 if not contiguous.
 		
 	/***** Public Methods *****/
 	public:
 		//! Constructor.
 		FieldContainer()
 		: KeyType( NULL ), ValueType( NULL )
-		, IsKeyPointer( false ), IsValuePointer( false ) {}
+		, IsKeyPointer( false ), IsValuePointer( false )
+		, IsKeyed( false ), IsFixedSize( false )
+		, IsContiguous( false ), Stride( 0 ) {}
+		//! Get the first value of a contiguous container.
+		//! @param	container	Pointer to container.
+		//! @return				First value, NULL if the container is empty or not contiguous.
+		virtual void* GetData( const void* container ) const { return NULL; }
+		//! Get the number of values in a contiguous container.
+		//! @param	container	Pointer to container.
+		//! @return				Value count, 0 if the container is not contiguous.
+		virtual Uint32 GetCount( const void* container ) const { return 0; }
+		//! Resize a contiguous container, default constructing any new values.
+		//! @param	container	Pointer to container.
+		//! @param	count		New value count.
+		//! @return				False if the container can't hold count values.
+		virtual bool Resize( void* container, Uint32 count ) const { return false; }
+		//! Find a value in a keyed container.
+		//! @param	container	Pointer to container.
+		//! @param	key			Key to look up (maps) or value to look for (sets).
+		//! @return				Value, NULL if absent or the container isn't keyed.
+		virtual const void* Find( const void* container, const void* key ) const { return NULL; }
+		//! Are the values plain data laid out in one block, so they can be copied,
+		//! compared and written as raw bytes? Never true for keyed containers.
+		bool IsPlainBlock( void ) const;
 		//! Get read iterator allocation size.
 		virtual Uint32 GetReadItAllocSize( void ) const		= 0;
 		//! Get write iterator allocation size.
@@ -138,9 +176,17 @@ namespace cbl
 			void DestructIt( FieldWriteIterator* it ) { ((WRITE_IT*)it)->WRITE_IT::~WRITE_IT(); }
 		};
 
+		//! Construct a container in storage that is never freed individually; containers
+		//! hold no resources, so they are not destructed either.
+		template< typename CONTAINER >
+		inline CONTAINER* NewContainer( Allocator& storage )
+		{
+			return new ( storage.Allocate( sizeof( CONTAINER ), alignof( CONTAINER ) ) ) CONTAINER();
+		}
+
 		// No container factory is created by default for all field types
 		template< typename TYPE >
-		inline FieldContainer* CreateContainer( TYPE& )
+		inline FieldContainer* CreateContainer( TYPE&, Allocator& )
 		{
 			return NULL;
 		}
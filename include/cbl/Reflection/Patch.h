@@ -0,0 +1,134 @@
+/* This source file is part of the Chewable Framework.
+ * For the latest info, please visit http://chewable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file Patch.h
+ * @brief Structural difference between two objects of a reflected type.
+ */
+
+#ifndef __CBL_PATCH_H_
+#define __CBL_PATCH_H_
+
+// Chewable Headers //
+#include "cbl/Chewable.h"
+#include "cbl/Util/ByteStream.h"
+
+// External Dependencies //
+#include <vector>
+
+namespace cbl
+{
+	/***** Forward Declarations *****/
+	class Field;
+	class Type;
+
+	//! Compact, encoded list of changes to a reflected object, made by Type::Diff and
+	//! replayed by Type::Apply.
+	//!
+	//! Each operation is a path to a value followed by its payload. Path steps are field
+	//! name hashes, sequence indices or map keys. Values are written as raw bytes for
+	//! plain data and through the type's stringifiers otherwise; values and keys that
+	//! have neither can't be written and make Diff fail. Objects that didn't exist
+	//! before (new pointees and container elements) are written out in full. Sequences
+	//! are diffed by their changed middle, so inserting or erasing near either end
+	//! doesn't rewrite the elements after it.
+	//! The encoding relies on both ends sharing the same field declarations.
+	class CBL_API Patch
+	{
+	/***** Types *****/
+	public:
+		//! Patch operations.
+		enum OPERATION
+		{
+			P_SET,		//!< Overwrite a value.
+			P_CLEAR,	//!< Set a pointer to NULL.
+			P_NEW,		//!< Point a pointer to a new object of a given type.
+			P_RESIZE,	//!< Keep only the first elements of a container.
+			P_APPEND,	//!< Append a default element to a sequence.
+			P_INSERT,	//!< Insert a key with a default value into a map, a value into a set, or a default element into a sequence.
+			P_ERASE,	//!< Erase a key from a map, a value from a set, or an element from a sequence.
+
+			P_COUNT,
+		};
+
+	/***** Properties *****/
+	public:
+		//! Get the encoded operations, e.g. to send or store them.
+		inline const ByteStream& GetStream( void ) const { return mStream; }
+		//! Get the number of operations recorded by the last Diff.
+		inline Uint32 GetCount( void ) const { return mCount; }
+		//! Is the patch empty?
+		inline bool IsEmpty( void ) const { return mStream.GetSize() == 0; }
+
+	/***** Public Methods *****/
+	public:
+		//! Constructor.
+		Patch();
+		//! Constructor. Wrap an encoded patch, e.g. one received from GetStream.
+		//! @param	bytes	Encoded operations.
+		//! @param	size	Size of the encoded operations.
+		Patch( const Char* bytes, Uint32 size );
+		//! Remove all operations.
+		void Clear( void );
+
+	/***** Private Types *****/
+	private:
+		//! Key and value addresses of a container element.
+		typedef std::vector< std::pair< const void*, const void* > >	Elements;
+
+		//! Position of an operation while applying a patch.
+		struct Cursor
+		{
+			const cbl::Type*	Type;		//!< Value type.
+			void*				Addr;		//!< Value address.
+			const cbl::Field*	Container;	//!< Container field when the value is a container.
+			bool				IsPointer;	//!< Is the value a pointer to an object of Type?
+		};
+
+	/***** Private Methods *****/
+	private:
+		//! Record the operations turning a into b.
+		//! @return		False if a value can't be encoded or the stream ran out of memory.
+		bool _Diff( const Type& type, const void* a, const void* b );
+		//! Diff an object or a pointer to one. a may be NULL if there's nothing to compare to.
+		bool _DiffSlot( const Type& type, bool isPointer, const void* a, const void* b );
+		//! Diff an object. a may be NULL if there's nothing to compare to.
+		bool _DiffObject( const Type& type, const void* a, const void* b );
+		//! Diff a container. a may be NULL if there's nothing to compare to.
+		bool _DiffContainer( const Field& field, const void* a, const void* b );
+		//! Diff a sequence.
+		bool _DiffSequence( const Field& field, const Elements& a, const Elements& b );
+		//! Diff a map or set.
+		bool _DiffKeyed( const Field& field, const Elements& a, const Elements& b );
+		//! Write an operation at the current path.
+		bool _Emit( OPERATION op, const String& payload );
+		//! Replay the operations on an object.
+		bool _Apply( const Type& type, void* obj ) const;
+		//! Follow a path from the object to the target of an operation.
+		bool _Seek( ByteStream& stream, Uint32 depth, Cursor& cursor ) const;
+
+	/***** Private Members *****/
+	private:
+		ByteStream				mStream;	//!< Encoded operations.
+		Uint32					mCount;		//!< Operations written by Diff.
+		std::vector< String >	mPath;		//!< Encoded steps to the value being diffed.
+		friend class Type;					//!< Befriend type.
+	};
+}
+
+#endif // __CBL_PATCH_H_
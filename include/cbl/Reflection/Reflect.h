@@ -0,0 +1,136 @@
+/* This source file is part of the Chewable Framework.
+ * For the latest info, please visit http://chewable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file Reflect.h
+ * @brief Compile-time reflection descriptors.
+ */
+
+#ifndef __CBL_REFLECT_H_
+#define __CBL_REFLECT_H_
+
+// Chewable Headers //
+#include "cbl/Chewable.h"
+#include "cbl/Reflection/FieldAttr.h"
+
+// External Dependencies //
+#include <tuple>
+#include <utility>
+#include <type_traits>
+
+namespace cbl
+{
+	//! Compile-time description of a single field.
+	template< typename CLASS, typename FIELD >
+	struct StaticField
+	{
+		typedef CLASS	ClassType;	//!< Type declaring the member.
+		typedef FIELD	FieldType;	//!< Member type.
+
+		const Char*		Name;		//!< Field name.
+		FIELD CLASS::*	Member;		//!< Pointer to member.
+		FieldAttr		Attributes;	//!< Field attributes and group.
+	};
+
+	//! Create a compile-time field descriptor.
+	template< typename CLASS, typename FIELD >
+	inline constexpr StaticField< CLASS, FIELD > MakeStaticField( const Char* name, FIELD CLASS::*member, FieldAttr attrs = FieldAttr() ) {
+		return StaticField< CLASS, FIELD >{ name, member, attrs };
+	}
+
+	//! Compile-time description of a type, specialised with CBL_REFLECT.
+	//! Types without one only have the runtime Type.
+	template< typename TYPE >
+	struct Reflect { static const bool Defined = false; };
+
+	namespace detail
+	{
+		template< typename FIELDS, typename FUNC, size_t... I >
+		inline void ForEachStaticField( const FIELDS& fields, FUNC& func, std::index_sequence< I... > ) {
+			// Expands to one call per field, in declaration order.
+			int expand[] = { 0, ( func( std::get< I >( fields ) ), 0 )... };
+			(void)expand;
+		}
+
+		//! Declares the fields of a reflected type on its runtime type.
+		template< typename TYPE_INFO >
+		struct StaticFieldRegistrar
+		{
+			TYPE_INFO& Target;
+
+			template< typename CLASS, typename FIELD >
+			void operator () ( const StaticField< CLASS, FIELD >& field ) {
+				Target.Field( field.Name, field.Member, field.Attributes );
+			}
+		};
+
+		template< typename TYPE, typename TYPE_INFO >
+		inline void RegisterStaticFields( TYPE_INFO&, std::false_type ) {}
+
+		template< typename TYPE, typename TYPE_INFO >
+		inline void RegisterStaticFields( TYPE_INFO& type, std::true_type );
+	}
+
+	//! Call func( field ) for every field of a reflected type, in declaration order.
+	//! The loop is unrolled at compile time; func receives a StaticField.
+	template< typename TYPE, typename FUNC >
+	inline void ForEachStaticField( FUNC& func ) {
+		typedef decltype( Reflect< TYPE >::Fields() ) Fields;
+		detail::ForEachStaticField( Reflect< TYPE >::Fields(), func, std::make_index_sequence< std::tuple_size< Fields >::value >() );
+	}
+
+	namespace detail
+	{
+		template< typename TYPE, typename TYPE_INFO >
+		inline void RegisterStaticFields( TYPE_INFO& type, std::true_type ) {
+			typedef decltype( Reflect< TYPE >::Fields() ) Fields;
+			type.ReserveFields( Uint32( std::tuple_size< Fields >::value ) );
+			StaticFieldRegistrar< TYPE_INFO > registrar = { type };
+			ForEachStaticField< TYPE >( registrar );
+		}
+	}
+}
+
+//! Describe the fields of a type at compile time, e.g.
+//! CBL_REFLECT( Vector3f, CBL_RFIELD( X, Vector3f ), CBL_RFIELD( Y, Vector3f ), CBL_RFIELD( Z, Vector3f ) );
+//! Must be used at global scope alongside CBL_TYPE. TypeDB::Create declares the listed
+//! fields on the runtime type, so they should not be declared again with CBL_FIELD.
+#define CBL_REFLECT( type, ... )\
+	namespace cbl {\
+		template<>\
+		struct Reflect< type > {\
+			static const bool Defined = true;\
+			static constexpr auto Fields( void ) -> decltype( std::make_tuple( __VA_ARGS__ ) ) {\
+				return std::make_tuple( __VA_ARGS__ );\
+			}\
+		};\
+	}
+
+#define CBL_RFIELD( fieldName, className )\
+	::cbl::MakeStaticField( #fieldName, &className::fieldName )
+
+#define CBL_RFIELDM( fieldName, className )\
+	::cbl::MakeStaticField( #fieldName, &className::m##fieldName )
+
+#define CBL_RFIELD_ATTR( fieldName, className, attr )\
+	::cbl::MakeStaticField( #fieldName, &className::fieldName, attr )
+
+#define CBL_RFIELDM_ATTR( fieldName, className, attr )\
+	::cbl::MakeStaticField( #fieldName, &className::m##fieldName, attr )
+
+#endif // __CBL_REFLECT_H_
@@ -30,10 +30,14 @@
 #include "cbl/Reflection/Field.h"
 #include "cbl/Reflection/EnumConst.h"
 #include "cbl/Util/CName.h"
+#include "cbl/Util/Noncopyable.h"
+#include "cbl/Memory/Relocate.h"
+#include "cbl/Reflection/ValueOps.h"
 
 // External Libraries //
+#include <atomic>
 #include <vector>
-#include <stack>
+#include <unordered_map>
 
 namespace cbl
 {
@@ -63,6 +67,7 @@ namespace cbl
 		typedef void (*DestructFunc)( void* );			//!< Destructor function pointer type.
 		typedef std::vector< cbl::Field >		Fields;	//!< Field list type.
 		typedef std::vector< cbl::EnumConst >	Enums;	//!< Enum list type.
+		typedef std::vector< const cbl::Field* >	FieldTable;	//!< Flattened field list type.
 		
 	/***** Properties *****/
 	public:
@@ -71,9 +76,14 @@ namespace cbl
 		//! Get type enums.
 		inline const Enums& GetEnums( void ) const { return mEnums; }
 		//! Get enum by value if it exists.
+		//! Looked up in a direct table when the values are dense, by binary search otherwise.
 		const EnumConst* GetEnum( cbl::Uint32 value ) const;
 		//! Get enum by name if it exists.
 		const EnumConst* GetEnum( const CName& name ) const;
+		//! Get the enum whose value is the single bit 1 << bit, if it exists.
+		const EnumConst* GetEnumBit( cbl::Uint32 bit ) const;
+		//! Are the enum constants bit flags? See EnumFlags.
+		inline bool HasEnumFlags( void ) const { return mEnumFlags; }
 		//! Get specific field.
 		const Field* GetField( const CName& name ) const;
 
@@ -85,18 +95,36 @@ namespace cbl
 		//! @param	field		Pointer to member.
 		template< typename ENTITY_TYPE, typename FIELD_TYPE >
 		Type& Field( const Char* name, FIELD_TYPE ENTITY_TYPE::*field, FieldAttr attrs = FieldAttr() );
+		//! Reserve space for fields about to be declared, so the field list is sized once.
+		//! @param	count		Number of fields the type will have.
+		Type& ReserveFields( Uint32 count );
 		//! Declare a base type.
 		//! e.g. Base<ParentType>();
 		template< typename BASE_TYPE >
 		Type& Base( void );
 		//! Declare an enum constant for this type.
 		Type& Enum( const Char* name, Uint32 value );
+		//! Declare the enum constants of this type as bit flags. Values without a constant
+		//! of their own are written as the names of their bits joined by '|'.
+		Type& EnumFlags( void );
 		//! Define default serialisers for this type.
 		//! See the StreamSerialise struct.
 		template< typename TYPE >
 		Type& DefaultSerialisers( void );
 		//! Define the serialisers for this type.
 		Type& DefineSerialisers( Stringifiers::ToString tostr, Stringifiers::FmString fmstr );
+		//! Define the hook used to move objects of this type when compacting pools.
+		//! Types that can be move or copy constructed get one by default.
+		Type& Relocator( RelocateFunc func );
+		//! Allocate objects of this type from an allocator instead of the heap, e.g. a
+		//! MemBudget. Derived types without an allocator of their own inherit it, whenever
+		//! they were registered.
+		//! Set it before the first New of this type or a type inheriting it: Delete looks
+		//! the allocator up again, so objects made before would be freed into the wrong one.
+		Type& AllocateFrom( cbl::Allocator& allocator );
+		//! Get the allocator objects of this type come from: the nearest allocator set on
+		//! this type or a base type, NULL for the heap.
+		cbl::Allocator* GetAllocator( void ) const;
 		//! Comparison operator.
 		bool operator == ( const Type& rhs ) const;
 		//! Less-than operator.
@@ -105,41 +133,198 @@ namespace cbl
 		template< typename PARENT >
 		bool IsType( void ) const;
 		//! Check if type is child of specified parent type.
+		bool IsType( const Type& parent ) const;
+		//! Check if type is child of specified parent type.
 		bool IsType( const CName& parent ) const;
 		//! Does this type have any fields? Includes base type fields.
 		bool HasFields( void ) const;
+		//! Is this plain data that can be copied and compared as bytes?
+		inline bool IsPlain( void ) const { return IsTrivial && !HasFields(); }
 		//! Newly allocated object of this type.
+		//! @return		Object, or NULL if the type's allocator refused the request.
 		void* New( void ) const;
 		//! Delete existing allocated object of this type.
 		void Delete( void* obj ) const;
-		//! Get all fields.
-		std::stack<const Fields*> GetAllFields( void ) const;
+		//! Get all fields including base type fields, base type fields first.
+		//! The table is built on first use and rebuilt after fields or base types are
+		//! declared on any type. A returned table is never changed or freed while the
+		//! type lives, so it may be iterated while other threads register types.
+		const FieldTable& GetAllFields( void ) const;
+		//! Copy the fields of one object of this type into another.
+		//! Transient fields are skipped, pointed to objects are copied into new objects
+		//! (or into the existing one if it is of the same type) and containers are rebuilt.
+		//! Pointed to objects are treated as owned; those that are replaced are deleted.
+		//! Runs of plain data fields are copied with a single memcpy.
+		void Clone( void* dst, const void* src ) const;
+		//! Compare the fields of two objects of this type, following pointers and
+		//! containers. Plain data is compared bitwise. Transient fields are ignored.
+		bool Equals( const void* lhs, const void* rhs ) const;
+		//! Hash the fields of an object of this type.
+		//! Objects that are Equals hash the same, except for unordered containers, which
+		//! are hashed in iteration order.
+		HashValue HashContents( const void* obj ) const;
+		//! Record the changes that turn a into b, both objects of this type, in a patch.
+		//! Unchanged values aren't written, so the patch is usually much smaller than
+		//! either object. Transient fields are skipped.
+		//! @return		False if a changed value can't be encoded (see Patch) or the patch
+		//!				ran out of memory; the patch is incomplete and must not be applied.
+		bool Diff( const void* a, const void* b, Patch& patch ) const;
+		//! Replay a patch made by Diff on an object of this type.
+		//! Pointed to objects are treated as owned, as in Clone; those that are replaced or
+		//! erased are deleted.
+		//! @return		False if the patch doesn't match the object; operations before the
+		//!				mismatch are applied.
+		bool Apply( void* obj, const Patch& patch ) const;
+
+	/***** Private Types *****/
+	private:
+		//! One step of Clone, Equals and HashContents.
+		struct MemberOp
+		{
+			enum {
+				K_BYTES,		//!< Plain data, copied and compared as raw bytes.
+				K_VALUE,		//!< Object without fields, uses the type's Assign and Equal.
+				K_POINTER,		//!< Pointer to an object, followed.
+				K_CONTAINER,	//!< Container, element by element.
+			};
+
+			Uint32				Kind;		//!< Operation kind.
+			size_t				Offset;		//!< Offset from the start of the object.
+			size_t				Size;		//!< Byte count for K_BYTES.
+			const cbl::Type*	Type;		//!< Member type.
+			const cbl::Field*	Field;		//!< Field for K_POINTER and K_CONTAINER.
+
+			inline bool operator == ( const MemberOp& rhs ) const {
+				return Kind == rhs.Kind && Offset == rhs.Offset && Size == rhs.Size && Type == rhs.Type && Field == rhs.Field;
+			}
+		};
+		typedef std::vector< MemberOp >	MemberOps;	//!< Operation list type.
+
+		//! Cache that is built off to the side and published whole, so a reader holding
+		//! it never sees it change. Replaced data is kept until the type is destroyed.
+		template< typename DATA >
+		class Published :
+			Noncopyable
+		{
+		public:
+			Published() : mData( NULL ), mVersion( 0 ) {}
+			~Published() {
+				for( size_t i = 0; i < mRetired.size(); ++i )
+					CBL_DELETE( mRetired[i] );
+				delete mData.load( std::memory_order_relaxed );
+			}
+			//! Get the data if it was built at a version, NULL otherwise.
+			inline const DATA* Get( Uint32 version ) const {
+				return mVersion.load( std::memory_order_acquire ) == version ? mData.load( std::memory_order_acquire ) : NULL;
+			}
+			//! Publish data built at a version, taking ownership. If it matches the current
+			//! data, the current data is kept and only the version moves on. The caller must
+			//! serialise publishers.
+			const DATA& Publish( DATA* data, Uint32 version ) {
+				const DATA* current = mData.load( std::memory_order_relaxed );
+				if( current && *current == *data ) {
+					delete data;
+				} else {
+					if( current ) mRetired.push_back( current );
+					mData.store( data, std::memory_order_release );
+					current = data;
+				}
+				mVersion.store( version, std::memory_order_release );
+				return *current;
+			}
+
+		private:
+			std::atomic< const DATA* >		mData;		//!< Current data.
+			std::atomic< Uint32 >			mVersion;	//!< TypeDB field version mData is valid for.
+			std::vector< const DATA* >		mRetired;	//!< Replaced data, readers may still hold it.
+		};
+
+		//! Enum constant lookup tables, indices into mEnums.
+		struct EnumIndex
+		{
+			std::vector< Uint32 >	ByValue;	//!< Constants sorted by value, first declared first.
+			std::vector< Uint32 >	Dense;		//!< Constant + 1 by value - Min, 0 if none. Empty if values are sparse.
+			Uint32					Min;		//!< Smallest value.
+			Uint32					Bits[32];	//!< Constant + 1 by bit of single bit values, 0 if none.
+			std::unordered_map< HashValue, Uint32 >	ByName;	//!< Constants by name hash.
+		};
 
 	/***** Private Methods *****/
 	private:
 		//! Private constructor. Only TypeDB should be creating this.
 		inline Type( const CName& name, size_t size, ConstructFunc cfunc, DestructFunc dfunc, TypeDB* typeDB, bool entType )
-			: DB( typeDB ), Constructor( cfunc ), Destructor( dfunc )
-			, ToString( NULL ), FromString( NULL )
-			, Size( size ), BaseType( NULL ), IsEntity( entType ), Name( name ) {}
+			: DB( typeDB ), Constructor( cfunc ), Destructor( dfunc ), Relocate( NULL )
+			, Assign( NULL ), Equal( NULL ), Memory( NULL ), ToString( NULL ), FromString( NULL )
+			, Size( size ), BaseType( NULL ), IsEntity( entType ), IsTrivial( false ), Index( InvalidTypeIndex ), Name( name )
+			, mPreOrder( 0 ), mPostOrder( 0 ), mEnumsIndexed( false ), mEnumFlags( false ) {}
+		//! Append base type fields, then this type's fields.
+		void _AppendFields( FieldTable& table ) const;
+		//! Invalidate the flattened field tables after fields or base types change.
+		void _FieldsChanged( void );
+		//! Invalidate the hierarchy numbers after a base type changes.
+		void _HierarchyChanged( void );
+		//! Get a type of the same database by index.
+		const Type* _GetByIndex( Uint16 index ) const;
+		//! Get the enum lookup tables, building them if needed.
+		const EnumIndex& _GetEnumIndex( void ) const;
+		//! Build the enum lookup tables if enums were declared since. DB->mLock must be held.
+		void _IndexEnums( void ) const;
+		//! Get the cached operation list used by Clone, Equals and HashContents.
+		const MemberOps& _GetMemberOps( void ) const;
+		//! Append the operations for an object of this type at an offset.
+		void _AppendMemberOps( MemberOps& ops, size_t offset ) const;
+		//! Is this container made of plain data keys and values?
+		static bool _IsPlainContainer( const FieldContainer& container );
+		//! Allocate an object of this type, or of its entity type.
+		void* _NewObject( void ) const;
+		//! Get the actual type of an object pointed to by a field of this type.
+		const Type& _GetObjectType( const void* obj ) const;
+		//! Copy a container element by element.
+		static void _CloneContainer( const cbl::Field& field, void* dst, const void* src );
+		//! Compare containers element by element.
+		static bool _EqualContainer( const cbl::Field& field, const void* lhs, const void* rhs );
+		//! Hash a container element by element.
+		static HashValue _HashContainer( const cbl::Field& field, const void* obj );
+		//! Copy a pointed to object into a new or existing object.
+		static void* _ClonePointer( const Type& type, void* dst, const void* src );
+		//! Delete a pointed to object through its actual type.
+		static void _DeletePointer( const Type& type, void* obj );
+		//! Compare two pointed to objects.
+		static bool _EqualPointer( const Type& type, const void* lhs, const void* rhs );
+		//! Hash a pointed to object.
+		static HashValue _HashPointer( const Type& type, const void* obj );
 
 	/***** Public Members *****/
 	public:
 		TypeDB*					DB;				//!< Parent type database
 		ConstructFunc			Constructor;	//!< Pointers to the constructor function
 		DestructFunc			Destructor;		//!< Pointers to the destructor function
+		RelocateFunc			Relocate;		//!< Relocation hook, NULL if objects can't be moved.
+		AssignFunc				Assign;			//!< Copy assignment, used by Clone for types without fields.
+		EqualFunc				Equal;			//!< operator ==, used by Equals for types without fields.
+		cbl::Allocator*			Memory;			//!< Object allocator set on this type, NULL to use the base type's.
 		Stringifiers::ToString	ToString;		//!< Type to string function pointer.
 		Stringifiers::FmString	FromString;		//!< String to type function pointer.
 		size_t					Size;			//!< Result of sizeof(type) operation
 		const Type*				BaseType;		//!< Base type.
 		bool					IsEntity;		//!< Is this type derived from Entity.
+		bool					IsTrivial;		//!< Is this type trivially copyable.
+		Uint16					Index;			//!< Dense type index, see TypeIndex.
 		CName					Name;			//!< Type name.
 
 	/***** Private Members *****/
 	private:
 		Fields				mFields;		//!< List of fields.
 		Enums				mEnums;			//!< List of enum constants.
+		Uint32				mPreOrder;		//!< Hierarchy interval start until frozen, see TypeDB::Finalise.
+		Uint32				mPostOrder;		//!< Hierarchy interval end.
+		mutable Published<FieldTable>	mAllFields;		//!< Flattened fields, see GetAllFields.
+		mutable Published<MemberOps>	mMemberOps;		//!< Cached operations, see _GetMemberOps.
+		mutable EnumIndex	mEnumIndex;		//!< Enum lookup tables, see _GetEnumIndex.
+		mutable std::atomic<bool>	mEnumsIndexed;	//!< mEnumIndex is up to date.
+		bool				mEnumFlags;		//!< Enum constants are bit flags.
 		friend class TypeDB;				//!< Befriend type DB.
+		friend class Patch;					//!< Befriend patch.
 	};
 	template<>
 	CBL_API void Stringifiers::FromStringDef<bool>( const String& stream, const Type*, void* obj, const FieldAttr* );
@@ -23,41 +23,61 @@
  */
 
 #include "cbl/Debug/Assert.h"
+#include "cbl/Memory/Allocator.h"
+#include "cbl/Memory/MemTracker.h"
+#include "cbl/Util/CharConv.h"
 
 namespace cbl
 {
+	namespace detail
+	{
+		//! Numbers use CharConv; characters and other types go through the streams.
+		template< typename TYPE >
+		struct IsCharConvertible :
+			std::integral_constant< bool, std::is_arithmetic< TYPE >::value && !std::is_same< TYPE, bool >::value
+				&& !std::is_same< TYPE, Char >::value && !std::is_same< TYPE, Uchar >::value > {};
+
+		template< typename TYPE >
+		inline void ToStringValue( String& str, const TYPE& value, bool hex, std::true_type )
+		{
+			Char buf[CharConv::MaxChars];
+			str.assign( buf, CharConv::Format( buf, value, hex ) );
+		}
+
+		template< typename TYPE >
+		inline void ToStringValue( String& str, const TYPE& value, bool hex, std::false_type )
+		{
+			std::ostringstream o;
+			if( hex ) o << std::hex << std::showbase;
+			o << value;
+			str = o.str();
+		}
+
+		template< typename TYPE >
+		inline void FromStringValue( const String& str, TYPE& value, bool hex, std::true_type )
+		{
+			CharConv::Parse( str.c_str(), str.c_str() + str.length(), value, hex );
+		}
+
+		template< typename TYPE >
+		inline void FromStringValue( const String& str, TYPE& value, bool hex, std::false_type )
+		{
+			std::istringstream i( str );
+			if( hex ) i >> std::hex;
+			i >> value;
+		}
+	}
+
 	template< typename INTEGRAL_TYPE >
 	inline void Stringifiers::ToStringDef( String& str, const Type*, const void* obj, const FieldAttr* attr )
 	{
-		std::ostringstream o;
-		if( attr && attr->Hex != 0 ) o << std::hex << std::showbase;
-		o << *(INTEGRAL_TYPE*)obj;
-		str = o.str();
+		detail::ToStringValue( str, *(const INTEGRAL_TYPE*)obj, attr && attr->Hex != 0, detail::IsCharConvertible< INTEGRAL_TYPE >() );
 	}
 
 	template< typename INTEGRAL_TYPE >
 	inline void Stringifiers::FromStringDef( const String& stream, const Type*, void* obj, const FieldAttr* attr )
 	{
-		std::istringstream i( stream );
-		if( attr && attr->Hex != 0 ) i >> std::hex;
-		i >> (*(INTEGRAL_TYPE*)obj);
-	}
-
-	template<>
-	inline void Stringifiers::ToStringDef<Int8>( String& str, const Type*, const void* obj, const FieldAttr* attr )
-	{
-		std::ostringstream o;
-		if( attr && attr->Hex != 0 ) o << std::hex << std::showbase;
-		o << Int32( *(Int8*)obj );
-		str = o.str();
-	}
-
-	template<>
-	inline void Stringifiers::FromStringDef<Int8>( const String& stream, const Type*, void* obj, const FieldAttr* attr )
-	{
-		Int32 t; std::istringstream i( stream );
-		if( attr && attr->Hex != 0 ) i >> std::hex;
-		i >> t; (*(Int8*)obj) = Int8( t );
+		detail::FromStringValue( stream, *(INTEGRAL_TYPE*)obj, attr && attr->Hex != 0, detail::IsCharConvertible< INTEGRAL_TYPE >() );
 	}
 
 	template<>
@@ -81,7 +101,8 @@ namespace cbl
 	template< typename ENTITY_TYPE, typename FIELD_TYPE >
 	inline Type& Type::Field( const Char* name, FIELD_TYPE ENTITY_TYPE::*field, FieldAttr attrs )
 	{
-		mFields.push_back( cbl::Field( CName( name ), DB->Get< StripPtr<FIELD_TYPE>::Type >(), field, attrs ) );
+		mFields.push_back( cbl::Field( CName( name ), DB->Get< StripPtr<FIELD_TYPE>::Type >(), field, attrs, DB->mStorage ) );
+		_FieldsChanged();
 		return *this;
 	}
 
@@ -89,6 +110,8 @@ namespace cbl
 	inline Type& Type::Base( void )
 	{
 		BaseType = DB->Get< StripPtr<BASE_TYPE>::Type >();
+		_FieldsChanged();
+		_HierarchyChanged();
 		return *this;
 	}
 
@@ -109,6 +132,20 @@ namespace cbl
 		return *this;
 	}
 
+	inline Type& Type::Relocator( RelocateFunc func )
+	{
+		Relocate = func;
+
+		return *this;
+	}
+
+	inline Type& Type::AllocateFrom( cbl::Allocator& allocator )
+	{
+		Memory = &allocator;
+
+		return *this;
+	}
+
 	inline bool Type::operator == ( const Type& rhs ) const
 	{
 		return Name == rhs.Name;
@@ -122,32 +159,39 @@ namespace cbl
 	template< typename PARENT >
 	inline bool Type::IsType( void ) const
 	{
-		return IsType( TypeCName<PARENT>() );
+		const Type* parent = _GetByIndex( TypeIndex<PARENT>() );
+		return parent ? IsType( *parent ) : IsType( TypeCName<PARENT>() );
 	}
 
-	//! Check if type is child of specified parent type.
-	inline bool Type::IsType( const CName& parent ) const
+	inline cbl::Allocator* Type::GetAllocator( void ) const
 	{
-		if( parent == Name ) return true;
-		const Type* p = BaseType;
-		while( p ) {
-			if( p->Name == parent ) return true;
-			p = p->BaseType;
-		}
-		return false;
+		const Type* type = this;
+		while( type && !type->Memory )
+			type = type->BaseType;
+		return type ? type->Memory : NULL;
 	}
 
 	inline void* Type::New( void ) const
 	{
 		CBL_ASSERT( Size > 0, "Type not valid" );
-		void* obj = malloc( Size );
+		cbl::Allocator* memory = GetAllocator();
+		void* obj = memory ? memory->Allocate( Size, alignof( std::max_align_t ) ) : malloc( Size );
+		if( !obj ) return NULL;
 		Constructor( obj );
+	#if CBL_MEMORY_TRACKING == CBL_ENABLED
+		MemTracker::Instance().TrackAllocate( *this, obj );
+	#endif
 		return obj;
 	}
 
 	inline void Type::Delete( void* obj ) const
 	{
+	#if CBL_MEMORY_TRACKING == CBL_ENABLED
+		MemTracker::Instance().TrackFree( *this, obj );
+	#endif
 		Destructor( obj );
-		free( obj );
+		cbl::Allocator* memory = GetAllocator();
+		if( memory ) memory->Deallocate( obj, Size, alignof( std::max_align_t ) );
+		else free( obj );
 	}
 }
\ No newline at end of file
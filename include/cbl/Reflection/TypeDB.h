@@ -28,10 +28,16 @@
 // Chewable Headers //
 #include "cbl/Chewable.h"
 #include "cbl/Reflection/Type.h"
+#include "cbl/Reflection/Reflect.h"
 #include "cbl/Util/CName.h"
 #include "cbl/Util/Noncopyable.h"
+#include "cbl/Memory/Allocator.h"
+#include "cbl/Memory/FrameArena.h"
+#include "cbl/Util/TimeSpan.h"
 
 // External Libraries //
+#include <atomic>
+#include <mutex>
 #include <unordered_map>
 
 namespace cbl
@@ -40,6 +46,12 @@ namespace cbl
 	class Type;
 
 	//! Type database.
+	//! Types are registered on one thread at startup. After Freeze, lookups and IsType
+	//! read an immutable published table without locking and may run on any thread;
+	//! types registered late are added under a lock and a new table is published.
+	//! Modules added with AddModule register their types on first use rather than
+	//! before main; the first miss registers all of them. Types and field containers
+	//! live in one arena owned by the database.
 	class CBL_API TypeDB :
 		Noncopyable
 	{
@@ -51,11 +63,25 @@ namespace cbl
 		//! Entity destruction function signature.
 		template< typename TYPE >
 		static void DestructEntity( void* ent );
+		//! Module registration function signature.
+		typedef void (*RegisterFunc)( TypeDB& types );
+
+		//! Registration cost, see GetRegistrationStats.
+		struct RegistrationStats
+		{
+			Uint32			Types;			//!< Registered types.
+			Uint32			Fields;			//!< Declared fields over all types.
+			Uint32			Modules;		//!< Modules registered so far.
+			Uint32			Tables;			//!< Type tables published since frozen.
+			size_t			StorageBytes;	//!< Arena bytes used by types and field containers.
+			TimeSpan		RegisterTime;	//!< Time spent running modules.
+		};
 		
 	/***** Public Methods *****/
 	public:
 		//! Constructor.
-		TypeDB();
+		//! @param	allocator	Allocator for the type table.
+		explicit TypeDB( Allocator& allocator = Allocator::GetDefault() );
 		//! Destructor.
 		~TypeDB();
 		//! Create new type (returns existing type if already exists).
@@ -71,6 +97,34 @@ namespace cbl
 		//! @param	name		Type name.
 		//! @return				Pointer to type info structure.
 		const Type* Get(const CName& name ) const;
+		//! Gets an existing type by its dense index.
+		//! @param	index		Type index, see TypeIndex.
+		//! @return				Pointer to type info structure, or NULL if not registered.
+		const Type* GetByIndex( Uint16 index ) const;
+		//! Publish the registered types for lock-free lookups from any thread, and Finalise.
+		//! Call once startup registration is done. Types created afterwards, e.g. by Get on
+		//! a type never registered, take a lock and republish the table; describe their
+		//! fields and base type before other threads use them.
+		void Freeze( void );
+		//! Has Freeze been called?
+		inline bool IsFrozen( void ) const { return mTable.load( std::memory_order_acquire ) != NULL; }
+		//! Number the type hierarchy so Type::IsType is two integer compares, and build
+		//! the enum lookup tables. Both are done on first use after types, base types or
+		//! enums are declared; call this once registration is done to keep it off the
+		//! first query.
+		void Finalise( void );
+		//! Add a module whose types are registered on first use: the first time a type is
+		//! created or looked up by name and missing, or on Freeze. A module already added
+		//! is ignored, so registering the same module twice is safe.
+		//! Laziness is global rather than per module: the database doesn't know which
+		//! module describes which type, so the first miss runs every pending module.
+		//! Registration is deferred past startup, not avoided for unused modules.
+		//! @param	func		Registration function.
+		void AddModule( RegisterFunc func );
+		//! Register every module added and not yet registered.
+		void RegisterModules( void );
+		//! Get what registration has cost so far.
+		RegistrationStats GetRegistrationStats( void ) const;
 		
 	/***** Private Methods *****/
 	private:
@@ -79,14 +133,75 @@ namespace cbl
 		//! @return				Pointer to type info structure.
 		template< typename TYPE >
 		Type* CreateImpl( void );
+		//! Find or create a type in the registration tables, without publishing it.
+		template< typename TYPE >
+		Type& _Register( Uint16 index );
+		//! Publish a snapshot of the registration tables. mRegisterLock must be held once frozen.
+		void _Publish( void );
+		//! Map a type index to a type.
+		void _SetIndex( Uint16 index, Type* type );
+		//! Register pending modules before a type is created or found missing.
+		inline void _RegisterPending( void ) const { if( mModulesPending.load( std::memory_order_acquire ) ) const_cast< TypeDB* >( this )->RegisterModules(); }
+		//! Mark every type's flattened field table as out of date.
+		inline void _InvalidateFields( void ) { mFieldsVersion.fetch_add( 1, std::memory_order_release ); }
+		//! Mark the hierarchy numbers as out of date.
+		inline void _InvalidateHierarchy( void ) { mHierarchyValid.store( false, std::memory_order_release ); }
+		//! Number the hierarchy if it changed since it was last numbered.
+		inline void _ValidateHierarchy( void ) const { if( !mHierarchyValid.load( std::memory_order_acquire ) ) const_cast< TypeDB* >( this )->Finalise(); }
+		//! Number the hierarchy into intervals by type index; see Type::IsType.
+		void _NumberTypes( std::vector< std::pair< Uint32, Uint32 > >& order ) const;
+		//! Number a type and its derived types in depth-first order.
+		void _Number( const Type* type, const std::unordered_multimap< const Type*, const Type* >& children,
+			Uint32& counter, std::vector< std::pair< Uint32, Uint32 > >& order ) const;
 
 	/***** Private Types *****/
 	private:
-		typedef std::unordered_map<CName, Type*>	TypeMap;			//!< Type map.
+		typedef AllocUnorderedMap<CName, Type*>::Type	TypeMap;		//!< Type map.
+		typedef AllocVector<Type*>::Type				TypeList;		//!< Types by index.
+
+		//! Arena for types and field containers, which live as long as the database.
+		//! Deallocation is a no-op.
+		class Storage :
+			public Allocator
+		{
+		public:
+			Storage() : mArena( CBL_TYPEDB_ARENA_BLOCK ) {}
+			virtual void* Allocate( size_t size, size_t align );
+			virtual void Deallocate( void*, size_t, size_t ) {}
+			//! Get the bytes in use.
+			size_t GetUsed( void ) const;
+
+		private:
+			FrameArena			mArena;		//!< Memory.
+			mutable std::mutex	mLock;		//!< Guards the arena for late registration.
+		};
+
+		//! Immutable copy of the registration tables, read without locking once frozen.
+		struct Table
+		{
+			std::vector< Type* >				ByIndex;	//!< Types by index.
+			std::unordered_map< CName, Type* >	ByName;		//!< Types by name.
+			std::vector< std::pair< Uint32, Uint32 > >	Order;	//!< Hierarchy interval by type index, (0, 0) if none.
+		};
 
 	/***** Private Members *****/
 	private:
-		TypeMap			mTypes;				//!< Type map.
+		TypeMap			mTypes;				//!< Type map, for data-driven lookups by name.
+		TypeList		mTypeList;			//!< Types by index, for lookups by C++ type.
+		std::atomic<Uint32>	mFieldsVersion;	//!< Bumped whenever fields or base types are declared.
+		std::atomic<bool>	mHierarchyValid;	//!< Hierarchy numbers are up to date.
+		std::mutex		mLock;				//!< Guards building field tables and hierarchy numbers.
+		std::recursive_mutex	mRegisterLock;	//!< Guards mTypes and mTypeList once frozen. Taken before mLock.
+		std::atomic<const Table*>	mTable;	//!< Published table, NULL until frozen.
+		std::vector< const Table* >	mTables;	//!< Every published table, kept for readers until destruction.
+		Uint32			mRegisterDepth;		//!< Nested registrations in progress; the outermost publishes. Guarded by mRegisterLock.
+		Storage			mStorage;			//!< Type and field container memory.
+		std::vector< RegisterFunc >	mModules;	//!< Modules added, in order.
+		size_t			mModulesRun;		//!< Modules registered so far, the rest are pending.
+		std::atomic<bool>	mModulesPending;	//!< Some modules are not registered yet, or are running.
+		bool			mModulesRunning;	//!< Modules are being registered. Guarded by mRegisterLock.
+		TimeSpan		mRegisterTime;		//!< Time spent running modules.
+		friend class Type;					//!< Befriend type.
 	};
 }
 
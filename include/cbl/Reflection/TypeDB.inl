@@ -24,6 +24,19 @@
 
 namespace cbl
 {
+	namespace detail
+	{
+		//! Entities are copied and compared field by field, never as values.
+		template< typename TYPE >
+		inline void SetValueHooks( Type&, std::true_type ) {}
+
+		template< typename TYPE >
+		inline void SetValueHooks( Type& type, std::false_type ) {
+			type.Assign	= DefaultAssigner< TYPE >();
+			type.Equal	= DefaultComparer< TYPE >();
+		}
+	}
+
 	template< typename TYPE >
 	inline void TypeDB::ConstructEntity( void* ent ) {
 		new (ent) TYPE;
@@ -37,29 +50,87 @@ namespace cbl
 	template< typename TYPE >
 	inline Type& TypeDB::Create()
 	{
-		const CName& name = TypeCName<TYPE>();
-		TypeMap::iterator findit = mTypes.find( name );
-		return findit == mTypes.end() ? *(CreateImpl<TYPE>()) : *(findit->second);
+		const Uint16 index = TypeIndex<TYPE>();
+		if( const Type* type = GetByIndex( index ) )
+			return *const_cast< Type* >( type );
+		// A pending module may describe the type; let it rather than creating it bare.
+		_RegisterPending();
+		if( const Type* type = GetByIndex( index ) )
+			return *const_cast< Type* >( type );
+		if( !IsFrozen() )
+			return _Register<TYPE>( index );
+
+		// Late registration; may recurse for field types, hence the recursive lock.
+		// Published once, when the outermost registration returns.
+		std::lock_guard< std::recursive_mutex > lock( mRegisterLock );
+		++mRegisterDepth;
+		Type& type = _Register<TYPE>( index );
+		if( --mRegisterDepth == 0 )
+			_Publish();
+		return type;
+	}
+
+	template< typename TYPE >
+	inline Type& TypeDB::_Register( Uint16 index )
+	{
+		if( index < mTypeList.size() && mTypeList[index] )
+			return *mTypeList[index];
+
+		// Fall back on the name, in case the type was registered through another index
+		// (e.g. from another module).
+		TypeMap::iterator findit = mTypes.find( TypeCName<TYPE>() );
+		Type* type = findit == mTypes.end() ? CreateImpl<TYPE>() : findit->second;
+		_SetIndex( index, type );
+		return *type;
 	}
 
 	template< typename TYPE >
 	inline const Type* TypeDB::Get( void ) const
 	{
-		const Type* type = Get( TypeCName<TYPE>() );
-		return type ? type : const_cast<TypeDB*>( this )->CreateImpl<TYPE>();
+		const Type* type = GetByIndex( TypeIndex<TYPE>() );
+		return type ? type : &const_cast<TypeDB*>( this )->Create<TYPE>();
 	}
 
 	inline const Type* TypeDB::Get( const CName& name ) const
 	{
+		if( const Table* table = mTable.load( std::memory_order_acquire ) ) {
+			std::unordered_map< CName, Type* >::const_iterator findit = table->ByName.find( name );
+			if( findit != table->ByName.end() )
+				return findit->second;
+		}
+		else {
+			TypeMap::const_iterator findit = mTypes.find( name );
+			if( findit != mTypes.end() )
+				return findit->second;
+		}
+
+		// A module may be about to register the type, on this thread or another; wait
+		// for it and look again.
+		_RegisterPending();
+		std::lock_guard< std::recursive_mutex > lock( const_cast< TypeDB* >( this )->mRegisterLock );
 		TypeMap::const_iterator findit = mTypes.find( name );
 		return findit != mTypes.end() ? findit->second : NULL;
 	}
 
+	inline const Type* TypeDB::GetByIndex( Uint16 index ) const
+	{
+		if( const Table* table = mTable.load( std::memory_order_acquire ) )
+			return index < table->ByIndex.size() ? table->ByIndex[index] : NULL;
+		return index < mTypeList.size() ? mTypeList[index] : NULL;
+	}
+
 	template< typename TYPE >
 	inline Type* TypeDB::CreateImpl( void )
 	{
-		Type* type = new Type( TypeCName<TYPE>(), sizeof(TYPE), ConstructEntity<TYPE>, DestructEntity<TYPE>, this, IsConvertible<TYPE,Entity>::Value );
+		Type* type = new ( mStorage.Allocate( sizeof(Type), alignof(Type) ) ) Type( TypeCName<TYPE>(), sizeof(TYPE), ConstructEntity<TYPE>, DestructEntity<TYPE>, this, IsConvertible<TYPE,Entity>::Value );
+		type->Relocate = DefaultRelocator<TYPE>();
+		type->IsTrivial = std::is_trivially_copyable<TYPE>::value;
+		detail::SetValueHooks<TYPE>( *type, std::integral_constant< bool, IsConvertible<TYPE,Entity>::Value >() );
+		type->Index = TypeIndex<TYPE>();
+		_InvalidateHierarchy();
 		mTypes.insert( std::make_pair( TypeCName<TYPE>(), type ) );
+		// Types described with CBL_REFLECT get their runtime fields for free.
+		detail::RegisterStaticFields< TYPE >( *type, std::integral_constant< bool, Reflect< TYPE >::Defined >() );
 		return type;
 	}
 }
@@ -30,8 +30,10 @@
 #include "cbl/Util/CName.h"
 #include "cbl/Util/Hash.h"
 #include "cbl/Util/Noncopyable.h"
+#include "cbl/Reflection/Reflect.h"
 
 // External Libraries //
+#include <atomic>
 #include <vector>
 #include <set>
 #include <map>
@@ -107,6 +109,34 @@ namespace cbl
 		return _hash;
 	}
 
+	//! Invalid type index.
+	static const Uint16 InvalidTypeIndex = 0;
+
+	namespace detail
+	{
+		//! Dense index of a type, InvalidTypeIndex until assigned.
+		//! Constant initialised, so reading it needs no static init guard.
+		template< typename TYPE >
+		struct TypeIndexSlot { static std::atomic<Uint16> Value; };
+
+		template< typename TYPE >
+		std::atomic<Uint16> TypeIndexSlot<TYPE>::Value( InvalidTypeIndex );
+
+		//! Assign the next dense index to a slot unless it already has one.
+		//! @return		Index of the slot.
+		CBL_API Uint16 AssignTypeIndex( std::atomic<Uint16>& slot );
+	}
+
+	//! Dense type index, shared by every TypeDB and used to index its type array.
+	//! Assigned on first use and cached in a global, so hot lookups skip the hash and
+	//! the static guard of TypeCName.
+	template< typename TYPE >
+	inline Uint16 TypeIndex( void ) {
+		std::atomic<Uint16>& slot = detail::TypeIndexSlot< typename StripPtr<TYPE>::Type >::Value;
+		Uint16 index = slot.load( std::memory_order_relaxed );
+		return index != InvalidTypeIndex ? index : detail::AssignTypeIndex( slot );
+	}
+
 	namespace detail
 	{
 		//! Generated type name for arrays.
@@ -181,7 +211,8 @@ namespace cbl
 #define CBL_REFLECTABLE\
 	friend class cbl::EntityManager;\
 	friend class cbl::TypeDB;\
-	friend class cbl::Type;
+	friend class cbl::Type;\
+	template< typename > friend struct cbl::Reflect;
 
 /***** Default Integral Types *****/
 CBL_TYPE( cbl::Int8,	Int8 );
@@ -0,0 +1,120 @@
+/* This source file is part of the Chewable Framework.
+ * For the latest info, please visit http://chewable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file ValueOps.h
+ * @brief Default copy and comparison hooks for reflected types without fields.
+ */
+
+#ifndef __CBL_VALUEOPS_H_
+#define __CBL_VALUEOPS_H_
+
+// Chewable Headers //
+#include "cbl/Chewable.h"
+
+// External Dependencies //
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <set>
+#include <map>
+#include <unordered_set>
+#include <unordered_map>
+#include <deque>
+
+namespace cbl
+{
+	//! Copy assign the object at src to the object at dst.
+	typedef void (*AssignFunc)( void* dst, const void* src );
+	//! Compare two objects for equality.
+	typedef bool (*EqualFunc)( const void* lhs, const void* rhs );
+
+	namespace detail
+	{
+		//! Does TYPE have a usable operator ==?
+		//! Standard containers declare one for any element type, so they are checked
+		//! through their elements to avoid instantiating a comparison that doesn't compile.
+		template< typename TYPE >
+		struct HasEquality
+		{
+		private:
+			template< typename T >
+			static auto _Test( int ) -> decltype( std::declval< const T& >() == std::declval< const T& >(), std::true_type() );
+			template< typename T >
+			static std::false_type _Test( ... );
+
+		public:
+			static const bool Value = !std::is_array< TYPE >::value && decltype( _Test< TYPE >( 0 ) )::value;
+		};
+
+		template< typename TYPE, typename ALLOC >
+		struct HasEquality< std::vector< TYPE, ALLOC > > : HasEquality< TYPE > {};
+		template< typename TYPE, typename ALLOC >
+		struct HasEquality< std::deque< TYPE, ALLOC > > : HasEquality< TYPE > {};
+		template< typename TYPE, typename COMPARE, typename ALLOC >
+		struct HasEquality< std::set< TYPE, COMPARE, ALLOC > > : HasEquality< TYPE > {};
+		template< typename TYPE, typename HASH, typename EQUAL, typename ALLOC >
+		struct HasEquality< std::unordered_set< TYPE, HASH, EQUAL, ALLOC > > : HasEquality< TYPE > {};
+		template< typename KEY, typename VALUE, typename COMPARE, typename ALLOC >
+		struct HasEquality< std::map< KEY, VALUE, COMPARE, ALLOC > > {
+			static const bool Value = HasEquality< KEY >::Value && HasEquality< VALUE >::Value;
+		};
+		template< typename KEY, typename VALUE, typename HASH, typename EQUAL, typename ALLOC >
+		struct HasEquality< std::unordered_map< KEY, VALUE, HASH, EQUAL, ALLOC > > {
+			static const bool Value = HasEquality< KEY >::Value && HasEquality< VALUE >::Value;
+		};
+
+		template< typename TYPE >
+		inline void AssignValue( void* dst, const void* src ) {
+			*static_cast< TYPE* >( dst ) = *static_cast< const TYPE* >( src );
+		}
+
+		template< typename TYPE >
+		inline bool EqualValue( const void* lhs, const void* rhs ) {
+			return *static_cast< const TYPE* >( lhs ) == *static_cast< const TYPE* >( rhs );
+		}
+
+		template< typename TYPE >
+		inline AssignFunc GetAssigner( std::true_type ) { return &AssignValue< TYPE >; }
+
+		template< typename TYPE >
+		inline AssignFunc GetAssigner( std::false_type ) { return NULL; }
+
+		template< typename TYPE >
+		inline EqualFunc GetComparer( std::true_type ) { return &EqualValue< TYPE >; }
+
+		template< typename TYPE >
+		inline EqualFunc GetComparer( std::false_type ) { return NULL; }
+	}
+
+	//! Get the default assignment hook for a type.
+	//! @return		Copy assignment, or NULL if the type can't be copy assigned.
+	template< typename TYPE >
+	inline AssignFunc DefaultAssigner( void ) {
+		return detail::GetAssigner< TYPE >( typename std::is_copy_assignable< TYPE >::type() );
+	}
+
+	//! Get the default comparison hook for a type.
+	//! @return		operator ==, or NULL if the type doesn't have one.
+	template< typename TYPE >
+	inline EqualFunc DefaultComparer( void ) {
+		return detail::GetComparer< TYPE >( std::integral_constant< bool, detail::HasEquality< TYPE >::Value >() );
+	}
+}
+
+#endif // __CBL_VALUEOPS_H_
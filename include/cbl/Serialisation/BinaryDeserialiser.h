@@ -27,6 +27,7 @@
 // Chewable Headers //
 #include "cbl/Chewable.h"
 #include "cbl/Serialisation/LinearDeserialiser.h"
+#include "cbl/Serialisation/BinarySerialiser.h"
 
 namespace cbl
 {
@@ -59,6 +60,8 @@ namespace cbl
 		virtual StreamPtr OnType( StreamPtr s, HashValue& type );
 		//! Virtual method to write data of a type.
 		virtual StreamPtr OnValue( StreamPtr s, const Type* type, void* obj, const FieldAttr* attr );
+		//! Read a block of plain values written as raw bytes.
+		virtual StreamPtr OnValueBlock( StreamPtr s, const FieldContainer& container, void* obj, Uint32 count );
 		//! Called when the stream has been set.
 		virtual void OnStreamSet( void );
 	};
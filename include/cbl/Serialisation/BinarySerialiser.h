@@ -38,6 +38,12 @@ namespace cbl
 	private:
 		using cbl::Serialiser::StreamPtr;
 
+	/***** Static Members *****/
+	public:
+		//! Leads a block of raw values, in place of the byte telling whether a single
+		//! value was written as a string (1) or as bytes (0).
+		static const Uchar ValueBlockMarker = 2;
+
 	/***** Protected Methods *****/
 	protected:
 		//! Initialise the stream (implementation specific).
@@ -52,6 +58,8 @@ namespace cbl
 		virtual StreamPtr OnType( StreamPtr s, const Type* type );
 		//! Virtual method to write data of a type.
 		virtual StreamPtr OnValue( StreamPtr s, const Type* type, const void* obj, const FieldAttr* attr );
+		//! Write a block of plain values as raw bytes.
+		virtual StreamPtr OnValueBlock( StreamPtr s, const Type* type, const void* data, Uint32 count );
 		//! Called when the stream has been set.
 		virtual void OnStreamSet( void );
 	};
@@ -43,6 +43,13 @@ namespace cbl
 		virtual StreamPtr OnType( StreamPtr s, HashValue& type ) = 0;
 		//! Virtual method to write data of a type.
 		virtual StreamPtr OnValue( StreamPtr s, const Type* type, void* obj, const FieldAttr* attr ) = 0;
+		//! Called after OnContainer for a non-empty container of plain data laid out in one block.
+		//! Values are appended to the container, or written from the front of fixed size ones.
+		//! @param	container	Field container.
+		//! @param	obj			Container object.
+		//! @param	count		Value count.
+		//! @return				NULL if the values were read, otherwise they are read one by one.
+		virtual StreamPtr OnValueBlock( StreamPtr s, const FieldContainer& container, void* obj, Uint32 count ) { return s; }
 
 	/***** Protected Methods *****/
 	protected:
@@ -44,6 +44,11 @@ namespace cbl
 		virtual StreamPtr OnType( StreamPtr s, const Type* type ) = 0;
 		//! Virtual method to write data of a type.
 		virtual StreamPtr OnValue( StreamPtr s, const Type* type, const void* obj, const FieldAttr* attr ) = 0;
+		//! Called after OnContainer for a non-empty container of plain data laid out in one block.
+		//! @param	data	First value.
+		//! @param	count	Value count.
+		//! @return			NULL if the values were written, otherwise they are written one by one.
+		virtual StreamPtr OnValueBlock( StreamPtr s, const Type* type, const void* data, Uint32 count ) { return s; }
 
 	/***** Private Methods *****/
 	private:
@@ -0,0 +1,211 @@
+/* This source file is part of the Chewable Framework.
+ * For the latest info, please visit http://chewable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file StaticSerialiser.h
+ * @brief Compile-time generated serialisation for CBL_REFLECT types.
+ */
+
+#ifndef __CBL_STATICSERIALISER_H_
+#define __CBL_STATICSERIALISER_H_
+
+// Chewable Headers //
+#include "cbl/Chewable.h"
+#include "cbl/Reflection/Reflect.h"
+#include "cbl/Reflection/Field.h"
+#include "cbl/Util/ByteStream.h"
+
+// External Dependencies //
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
+namespace cbl
+{
+	//! Packed binary format for the static path.
+	//! Values are written as raw bytes, strings and vectors as a count followed by
+	//! their contents. There are no type or field headers, so the layout is only
+	//! readable by the same CBL_REFLECT description and is not interchangeable
+	//! with BinarySerialiser streams.
+	struct StaticBinary
+	{
+		//! Write raw bytes.
+		static inline void WriteBytes( ByteStream& stream, const void* src, Uint32 size ) {
+			stream.Write( static_cast< const Char* >( src ), size );
+		}
+		//! Read raw bytes.
+		//! @return		False if the stream is too short.
+		static inline bool ReadBytes( ByteStream& stream, void* dst, Uint32 size ) {
+			if( stream.GetSize() < size ) return false;
+			stream.Read( static_cast< Char* >( dst ), size );
+			return true;
+		}
+		//! Write an element count.
+		static inline void WriteCount( ByteStream& stream, Uint32 count ) {
+			WriteBytes( stream, &count, sizeof( count ) );
+		}
+		//! Read an element count.
+		static inline bool ReadCount( ByteStream& stream, Uint32& count ) {
+			return ReadBytes( stream, &count, sizeof( count ) );
+		}
+	};
+
+	//! Static (de)serialisation of one type in one format.
+	//! Specialise to support types that are neither primitives nor described with
+	//! CBL_REFLECT.
+	template< typename FORMAT, typename TYPE, typename ENABLE = void >
+	struct StaticCodec
+	{
+		static_assert( sizeof( TYPE ) == 0, "Type has no static serialisation; describe it with CBL_REFLECT or specialise StaticCodec." );
+	};
+
+	//! Arithmetic and enum values.
+	template< typename FORMAT, typename TYPE >
+	struct StaticCodec< FORMAT, TYPE, typename std::enable_if< std::is_arithmetic< TYPE >::value || std::is_enum< TYPE >::value >::type >
+	{
+		static inline void Write( ByteStream& stream, const TYPE& value ) {
+			FORMAT::WriteBytes( stream, &value, sizeof( TYPE ) );
+		}
+		static inline bool Read( ByteStream& stream, TYPE& value ) {
+			return FORMAT::ReadBytes( stream, &value, sizeof( TYPE ) );
+		}
+	};
+
+	//! Strings.
+	template< typename FORMAT >
+	struct StaticCodec< FORMAT, String >
+	{
+		static inline void Write( ByteStream& stream, const String& value ) {
+			FORMAT::WriteCount( stream, Uint32( value.length() ) );
+			FORMAT::WriteBytes( stream, value.data(), Uint32( value.length() ) );
+		}
+		static inline bool Read( ByteStream& stream, String& value ) {
+			Uint32 count = 0;
+			if( !FORMAT::ReadCount( stream, count ) || stream.GetSize() < count ) return false;
+			value.resize( count );
+			return count == 0 || FORMAT::ReadBytes( stream, &value[0], count );
+		}
+	};
+
+	//! Vectors. Arithmetic elements are copied as one block.
+	template< typename FORMAT, typename TYPE, typename ALLOC >
+	struct StaticCodec< FORMAT, std::vector< TYPE, ALLOC > >
+	{
+		typedef std::vector< TYPE, ALLOC > VectorType;
+		typedef std::integral_constant< bool, std::is_arithmetic< TYPE >::value && !std::is_same< TYPE, bool >::value > IsBlock;
+
+		static inline void Write( ByteStream& stream, const VectorType& value ) {
+			FORMAT::WriteCount( stream, Uint32( value.size() ) );
+			_Write( stream, value, IsBlock() );
+		}
+		static inline bool Read( ByteStream& stream, VectorType& value ) {
+			Uint32 count = 0;
+			if( !FORMAT::ReadCount( stream, count ) ) return false;
+			return _Read( stream, value, count, IsBlock() );
+		}
+
+	private:
+		static inline void _Write( ByteStream& stream, const VectorType& value, std::true_type ) {
+			if( !value.empty() ) FORMAT::WriteBytes( stream, &value[0], Uint32( value.size() * sizeof( TYPE ) ) );
+		}
+		static inline void _Write( ByteStream& stream, const VectorType& value, std::false_type ) {
+			for( size_t i = 0; i < value.size(); ++i )
+				StaticCodec< FORMAT, TYPE >::Write( stream, value[i] );
+		}
+		static inline bool _Read( ByteStream& stream, VectorType& value, Uint32 count, std::true_type ) {
+			if( count > stream.GetSize() / sizeof( TYPE ) ) return false;
+			value.resize( count );
+			return count == 0 || FORMAT::ReadBytes( stream, &value[0], count * Uint32( sizeof( TYPE ) ) );
+		}
+		static inline bool _Read( ByteStream& stream, VectorType& value, Uint32 count, std::false_type ) {
+			value.clear();
+			value.reserve( std::min< Uint32 >( count, stream.GetSize() ) );
+			for( Uint32 i = 0; i < count; ++i ) {
+				TYPE element;
+				if( !StaticCodec< FORMAT, TYPE >::Read( stream, element ) ) return false;
+				value.push_back( element );
+			}
+			return true;
+		}
+	};
+
+	namespace detail
+	{
+		template< typename FORMAT, typename TYPE >
+		struct StaticFieldWriter
+		{
+			ByteStream& Stream;
+			const TYPE& Obj;
+
+			template< typename CLASS, typename FIELD >
+			inline void operator () ( const StaticField< CLASS, FIELD >& field ) {
+				if( field.Attributes.Transient == 0 )
+					StaticCodec< FORMAT, FIELD >::Write( Stream, Obj.*field.Member );
+			}
+		};
+
+		template< typename FORMAT, typename TYPE >
+		struct StaticFieldReader
+		{
+			ByteStream& Stream;
+			TYPE& Obj;
+			bool Ok;
+
+			template< typename CLASS, typename FIELD >
+			inline void operator () ( const StaticField< CLASS, FIELD >& field ) {
+				if( Ok && field.Attributes.Transient == 0 )
+					Ok = StaticCodec< FORMAT, FIELD >::Read( Stream, Obj.*field.Member );
+			}
+		};
+	}
+
+	//! Types described with CBL_REFLECT, field by field in declaration order.
+	template< typename FORMAT, typename TYPE >
+	struct StaticCodec< FORMAT, TYPE, typename std::enable_if< Reflect< TYPE >::Defined >::type >
+	{
+		static inline void Write( ByteStream& stream, const TYPE& value ) {
+			detail::StaticFieldWriter< FORMAT, TYPE > writer = { stream, value };
+			ForEachStaticField< TYPE >( writer );
+		}
+		static inline bool Read( ByteStream& stream, TYPE& value ) {
+			detail::StaticFieldReader< FORMAT, TYPE > reader = { stream, value, true };
+			ForEachStaticField< TYPE >( reader );
+			return reader.Ok;
+		}
+	};
+
+	//! Serialise an object through its compile-time description.
+	//! Everything is resolved at compile time: no field lookups, no virtual calls.
+	//! @tparam	FORMAT	Stream format, StaticBinary by default.
+	//! @return		False if the stream has failed, e.g. the serialisation budget ran out;
+	//!				the written object is incomplete.
+	template< typename FORMAT = StaticBinary, typename TYPE >
+	inline bool StaticSerialise( ByteStream& stream, const TYPE& obj ) {
+		StaticCodec< FORMAT, TYPE >::Write( stream, obj );
+		return !stream.HasFailed();
+	}
+
+	//! Deserialise an object written by StaticSerialise with the same format.
+	//! @return		False if the stream ended early; obj may be partially read.
+	template< typename FORMAT = StaticBinary, typename TYPE >
+	inline bool StaticDeserialise( ByteStream& stream, TYPE& obj ) {
+		return StaticCodec< FORMAT, TYPE >::Read( stream, obj );
+	}
+}
+
+#endif // __CBL_STATICSERIALISER_H_
@@ -61,6 +61,12 @@
 #include "cbl/Math/Vector2.h"
 #include "cbl/Math/Vector3.h"
 #include "cbl/Math/Vector4.h"
+// Memory //
+#include "cbl/Memory/Allocator.h"
+#include "cbl/Memory/FrameArena.h"
+#include "cbl/Memory/MemBudget.h"
+#include "cbl/Memory/MemTracker.h"
+#include "cbl/Memory/PageArena.h"
 // Reflection //
 #include "cbl/Reflection/CblRegistrar.h"
 #include "cbl/Reflection/Typing.h"
@@ -79,6 +85,8 @@
 #include "cbl/Serialisation/Serialiser.h"
 #include "cbl/Reflection/Type.h"
 #include "cbl/Reflection/TypeDB.h"
+// Thread //
+#include "cbl/Thread/WorkerPool.h"
 // Util //
 #include "cbl/Util/ByteStream.h"
 #include "cbl/Util/Colour.h"
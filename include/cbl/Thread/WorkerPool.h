@@ -0,0 +1,121 @@
+/* This source file is part of the Chewable Framework.
+ * For the latest info, please visit http://chewable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file WorkerPool.h
+ * @brief Fixed-size pool of worker threads for fork-join style jobs.
+ */
+
+#ifndef __CBL_WORKERPOOL_H_
+#define __CBL_WORKERPOOL_H_
+
+// Chewable Headers //
+#include "cbl/Chewable.h"
+#include "cbl/Util/Noncopyable.h"
+#include "cbl/Util/Singleton.h"
+
+// External Dependencies //
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace cbl
+{
+	//! @brief Fixed-size pool of worker threads.
+	//!
+	//! Jobs are ranges of indices which are split into batches and handed out
+	//! to the workers and the calling thread. ParallelFor blocks until every
+	//! batch has completed, so the pool only ever runs a single job at a time.
+	class CBL_API WorkerPool :
+		Noncopyable
+	{
+	/***** Types *****/
+	public:
+		//! Declare as singleton.
+		CBL_DECL_SINGLETON( WorkerPool );
+
+		//! Range job function.
+		//! @param	context		User data passed to ParallelFor.
+		//! @param	begin		First index of the batch.
+		//! @param	end			One past the last index of the batch.
+		typedef void (*RangeFunc)( void* context, Uint32 begin, Uint32 end );
+
+	/***** Properties *****/
+	public:
+		//! Get the number of background worker threads (excluding the caller).
+		inline Uint32 GetWorkerCount( void ) const { return Uint32( mWorkers.size() ); }
+
+	/***** Public Methods *****/
+	public:
+		//! Destructor. Joins all worker threads.
+		~WorkerPool();
+		//! Run a function over [0, count) in batches across the pool.
+		//! Calls made from inside a running job execute serially on the calling thread.
+		//! @param	count		Number of indices.
+		//! @param	batchSize	Number of indices handed out per batch.
+		//! @param	func		Range function.
+		//! @param	context		User data passed to func.
+		void ParallelFor( Uint32 count, Uint32 batchSize, RangeFunc func, void* context );
+		//! Run a functor over [0, count) in batches across the pool.
+		//! @tparam	F			Functor type taking ( Uint32 begin, Uint32 end ).
+		//! @param	count		Number of indices.
+		//! @param	batchSize	Number of indices handed out per batch.
+		//! @param	func		Functor to call.
+		template< typename F >
+		inline void ParallelFor( Uint32 count, Uint32 batchSize, F& func )
+		{
+			ParallelFor( count, batchSize, &RangeStub<F>, &func );
+		}
+
+	/***** Private Methods *****/
+	private:
+		//! Constructor. Set as private to prevent instantiation.
+		WorkerPool();
+		//! Worker thread entry.
+		void WorkerMain( void );
+		//! Pull batches off the current job until it is exhausted.
+		void RunBatches( void );
+		//! Functor forwarding stub.
+		template< typename F >
+		static void RangeStub( void* context, Uint32 begin, Uint32 end )
+		{
+			( *static_cast< F* >( context ) )( begin, end );
+		}
+
+	/***** Private Members *****/
+	private:
+		typedef std::vector< std::thread > ThreadList;
+
+		ThreadList					mWorkers;		//!< Background worker threads.
+		std::mutex					mJobLock;		//!< Serialises ParallelFor callers.
+		std::mutex					mLock;			//!< Guards the job state below.
+		std::condition_variable		mWake;			//!< Signalled when a job is posted or on shutdown.
+		std::condition_variable		mDone;			//!< Signalled when the last worker leaves a job.
+		RangeFunc					mFunc;			//!< Current job function.
+		void*						mContext;		//!< Current job context.
+		Uint32						mCount;			//!< Current job index count.
+		Uint32						mBatchSize;		//!< Current job batch size.
+		std::atomic< Uint32 >		mNext;			//!< Next unclaimed index.
+		Uint32						mGeneration;	//!< Incremented per job so workers pick it up once.
+		Uint32						mActive;		//!< Workers still inside the current job.
+		bool						mShutdown;		//!< Set when workers should exit.
+	};
+}
+
+#endif // __CBL_WORKERPOOL_H_
@@ -32,6 +32,10 @@ namespace cbl
 {
 	//! Byte stream utility class.
 	//! Converts integral values into serialised bytes.
+	//! The buffer counts against the serialisation memory budget; writes that don't fit
+	//! in it are dropped and flag the stream as failed. Writers must check HasFailed.
+	//! The stream-based serialisers (Binary, Tree) write to a std::ostream owned by the
+	//! caller and are not covered by the budget.
 	//! WARNING: Does not check for Endian format!
 	class CBL_API ByteStream
 	{
@@ -64,10 +68,12 @@ namespace cbl
 		//! @return			Returns -1 if not found, otherwise returns
 		//!					the position of the first occurence.
 		Int32 Find( Char find ) const;
-		//! Clear stream data.
+		//! Clear stream data and the failed flag.
 		//! Note that this does not actually erase previously written data, but resets
 		//! the counters back to 0 to save on performance.
 		void Clear( void );
+		//! Check if a write was dropped because the serialisation budget ran out.
+		inline bool HasFailed( void ) const { return mFailed; }
 		//! Assignment operator.
 		ByteStream & operator = ( const ByteStream & rhs );
 		//! Insertion operator. Inserts bytes from an integral value.
@@ -95,7 +101,8 @@ namespace cbl
 		//! Shifts the data to back to the start of the storage array.
 		void Compress( void );
 		//! Reallocates memory for the byte stream using th specified size.
-		void Reallocate( Uint32 size );
+		//! @return		False if the serialisation budget refused the memory.
+		bool Reallocate( Uint32 size );
 
 	/***** Private Members *****/
 	private:
@@ -103,6 +110,7 @@ namespace cbl
 		Uint32		mSize;		//!< Current byte stream size.
 		Uint32		mMaxSize;	//!< Maximum byte stream size before reallocation.
 		Uint32		mStartMarker;
+		bool		mFailed;	//!< A write was dropped.
 	};
 
 	/***** Template Method Definitions *****/
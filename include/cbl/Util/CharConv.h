@@ -0,0 +1,152 @@
+/* This source file is part of the Chewable Framework.
+ * For the latest info, please visit http://chewable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file CharConv.h
+ * @brief Locale independent number to text conversion into caller buffers.
+ */
+
+#ifndef __CBL_CHARCONV_H_
+#define __CBL_CHARCONV_H_
+
+// Chewable Headers //
+#include "cbl/Chewable.h"
+
+// External Dependencies //
+#include <limits>
+#include <type_traits>
+
+namespace cbl
+{
+	namespace CharConv
+	{
+		/***** Static Variables *****/
+		//! Buffer size that fits any number written by ToChars.
+		static const Uint32 MaxChars = 32;
+
+		/***** Function Declarations *****/
+		//! Write an unsigned integer, or its 0x prefixed lowercase hex form.
+		//! @param	buf		Destination of at least MaxChars characters. Not null terminated.
+		//! @return			Number of characters written.
+		CBL_API Uint32 ToChars( Char* buf, Uint64 value, bool hex = false );
+		//! Write a signed integer.
+		//! @return			Number of characters written.
+		CBL_API Uint32 ToChars( Char* buf, Int64 value );
+		//! Write a float with the fewest significant digits that read back to the same value.
+		//! Currently found by formatting at increasing precision with snprintf and reading
+		//! each attempt back with strtod, mapping the locale's decimal point to '.'; a
+		//! dedicated shortest round-trip algorithm would need neither.
+		//! @return			Number of characters written.
+		CBL_API Uint32 ToChars( Char* buf, Float32 value );
+		//! Write a double with the fewest significant digits that read back to the same value.
+		//! @return			Number of characters written.
+		CBL_API Uint32 ToChars( Char* buf, Float64 value );
+		//! Read an unsigned integer. Leading white space is skipped and hex values may
+		//! start with 0x.
+		//! @return			Number of characters read, 0 if there was no number or it
+		//!					overflowed, in which case value is unchanged.
+		CBL_API Uint32 FromChars( const Char* first, const Char* last, Uint64& value, bool hex = false );
+		//! Read a signed integer.
+		//! @return			Number of characters read, 0 on failure.
+		CBL_API Uint32 FromChars( const Char* first, const Char* last, Int64& value );
+		//! Read a float, in fixed or exponent notation.
+		//! @return			Number of characters read, 0 on failure.
+		CBL_API Uint32 FromChars( const Char* first, const Char* last, Float32& value );
+		//! Read a double, in fixed or exponent notation.
+		//! @return			Number of characters read, 0 on failure.
+		CBL_API Uint32 FromChars( const Char* first, const Char* last, Float64& value );
+
+		//! Write any integer or floating point value. Hex is ignored for floating point
+		//! values; negative integers are written as their unsigned bit pattern.
+		//! @return			Number of characters written.
+		template< typename TYPE >
+		Uint32 Format( Char* buf, TYPE value, bool hex = false );
+		//! Read any integer or floating point value. Values out of the type's range fail.
+		//! @return			Number of characters read, 0 on failure.
+		template< typename TYPE >
+		Uint32 Parse( const Char* first, const Char* last, TYPE& value, bool hex = false );
+
+		namespace detail
+		{
+			//! Conversion kind used to dispatch Format and Parse.
+			template< typename TYPE >
+			struct Kind :
+				std::integral_constant< int, std::is_floating_point< TYPE >::value ? 2 : std::is_signed< TYPE >::value ? 1 : 0 > {};
+
+			template< typename TYPE >
+			inline Uint32 Format( Char* buf, TYPE value, bool hex, std::integral_constant< int, 0 > ) {
+				return ToChars( buf, Uint64( value ), hex );
+			}
+
+			template< typename TYPE >
+			inline Uint32 Format( Char* buf, TYPE value, bool hex, std::integral_constant< int, 1 > ) {
+				typedef typename std::make_unsigned< TYPE >::type Unsigned;
+				return hex ? ToChars( buf, Uint64( Unsigned( value ) ), true ) : ToChars( buf, Int64( value ) );
+			}
+
+			template< typename TYPE >
+			inline Uint32 Format( Char* buf, TYPE value, bool, std::integral_constant< int, 2 > ) {
+				return ToChars( buf, value );
+			}
+
+			template< typename TYPE >
+			inline Uint32 Parse( const Char* first, const Char* last, TYPE& value, bool hex, std::integral_constant< int, 0 > ) {
+				Uint64 v = 0;
+				Uint32 read = FromChars( first, last, v, hex );
+				if( !read || v > Uint64( std::numeric_limits< TYPE >::max() ) ) return 0;
+				value = TYPE( v );
+				return read;
+			}
+
+			template< typename TYPE >
+			inline Uint32 Parse( const Char* first, const Char* last, TYPE& value, bool hex, std::integral_constant< int, 1 > ) {
+				typedef typename std::make_unsigned< TYPE >::type Unsigned;
+				if( hex ) {
+					// Hex values are the unsigned bit pattern, as written by Format.
+					Unsigned u = 0;
+					Uint32 read = Parse( first, last, u, true, std::integral_constant< int, 0 >() );
+					if( read ) value = TYPE( u );
+					return read;
+				}
+				Int64 v = 0;
+				Uint32 read = FromChars( first, last, v );
+				if( !read || v < Int64( std::numeric_limits< TYPE >::min() ) || v > Int64( std::numeric_limits< TYPE >::max() ) ) return 0;
+				value = TYPE( v );
+				return read;
+			}
+
+			template< typename TYPE >
+			inline Uint32 Parse( const Char* first, const Char* last, TYPE& value, bool, std::integral_constant< int, 2 > ) {
+				return FromChars( first, last, value );
+			}
+		}
+
+		/***** Inline Functions *****/
+		template< typename TYPE >
+		inline Uint32 Format( Char* buf, TYPE value, bool hex ) {
+			return detail::Format( buf, value, hex, detail::Kind< TYPE >() );
+		}
+
+		template< typename TYPE >
+		inline Uint32 Parse( const Char* first, const Char* last, TYPE& value, bool hex ) {
+			return detail::Parse( first, last, value, hex, detail::Kind< TYPE >() );
+		}
+	}
+}
+
+#endif // __CBL_CHARCONV_H_
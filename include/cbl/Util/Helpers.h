@@ -24,6 +24,9 @@
 #ifndef __CBL_HELPER_H_
 #define __CBL_HELPER_H_
 
+//! Paste two tokens after expanding them, e.g. CBL_CONCAT( name, __COUNTER__ ).
+#define CBL_CONCAT( a, b )		CBL_CONCAT_IMPL( a, b )
+#define CBL_CONCAT_IMPL( a, b )	a##b
 
 #define CBL_FOREACH_IMPL( stl_container_type, iterator_type, iterator_name, container, beginFunc, endFunc )\
 	for( stl_container_type::iterator_type iterator_name = (container).beginFunc(), end = (container).endFunc(); (iterator_name) != end; ++(iterator_name) )
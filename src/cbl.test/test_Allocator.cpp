@@ -0,0 +1,81 @@
+/* This source file is part of the Chewable Framework.
+ * For the latest info, please visit http://chewable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file test_Allocator.cpp
+ * @brief Unit testing for allocator adapters.
+ */
+
+// Precompiled Headers //
+#include "cbl/StdAfx.h"
+
+// Chewable Headers //
+#include <cbl/Chewable.h>
+#include <cbl/Memory/Allocator.h>
+#include <cbl/Core/ObjectManager.h>
+#include <cbl/Reflection/TypeDB.h>
+
+// Google Test //
+#include <gtest/gtest.h>
+
+using namespace cbl;
+
+TEST( AllocatorFixture, Allocator_AlignTest )
+{
+	Allocator& heap = Allocator::GetDefault();
+	void* mem = heap.Allocate( 100, 64 );
+	ASSERT_EQ( reinterpret_cast<size_t>( mem ) % 64, 0 );
+	heap.Deallocate( mem, 100, 64 );
+}
+
+TEST( AllocatorFixture, Allocator_ContainerTest )
+{
+	CountingAllocator counter;
+	{
+		AllocVector<Uint32>::Type ids( counter );
+		for( Uint32 i = 0; i < 100; ++i )
+			ids.push_back( i );
+		ASSERT_GE( counter.GetLiveBytes(), 100 * sizeof(Uint32) );
+
+		AllocUnorderedMap<Uint32, Uint32>::Type table( 0, std::hash<Uint32>(), std::equal_to<Uint32>(), counter );
+		size_t before = counter.GetLiveCount();
+		table[1] = 2;
+		ASSERT_GT( counter.GetLiveCount(), before );
+	}
+	ASSERT_EQ( counter.GetLiveBytes(), 0 );
+	ASSERT_EQ( counter.GetLiveCount(), 0 );
+	ASSERT_GT( counter.GetAllocations(), 0 );
+}
+
+TEST( AllocatorFixture, Allocator_SubsystemTest )
+{
+	CountingAllocator counter;
+	{
+		TypeDB types( counter );
+		ASSERT_GT( counter.GetLiveBytes(), 0 );
+	}
+	ASSERT_EQ( counter.GetLiveBytes(), 0 );
+
+	{
+		ObjectManager objects( counter );
+		size_t before = counter.GetLiveCount();
+		ASSERT_TRUE( objects.Groups.Get( "Enemies" ).empty() );
+		ASSERT_GT( counter.GetLiveCount(), before );
+	}
+	ASSERT_EQ( counter.GetLiveBytes(), 0 );
+}
@@ -286,4 +286,128 @@ TEST( BinarySerialisationTest, EntityContainerTest )
 	}
 
 	ForceReconstructEntityManager_BinaryS();
-}
\ No newline at end of file
+}
+struct BinaryBlockTest
+{
+	std::vector<Float32>	Samples;
+	Uint16					Fixed[4];
+	std::vector<String>		Names;
+};
+
+CBL_TYPE( BinaryBlockTest, BinaryBlockTest );
+
+TEST( BinarySerialisationTest, ValueBlockTest )
+{
+	const Type& type = CBL_ENT.Types.Create<BinaryBlockTest>()
+		.CBL_FIELD( Samples, BinaryBlockTest )
+		.CBL_FIELD( Fixed, BinaryBlockTest )
+		.CBL_FIELD( Names, BinaryBlockTest );
+
+	ASSERT_TRUE( type.GetField( CName( "Samples" ) )->Container->IsPlainBlock() );
+	ASSERT_TRUE( type.GetField( CName( "Fixed" ) )->Container->IsPlainBlock() );
+	ASSERT_FALSE( type.GetField( CName( "Names" ) )->Container->IsPlainBlock() );
+
+	BinaryBlockTest out;
+	for( Uint32 i = 0; i < 1000; ++i )
+		out.Samples.push_back( i * 0.25f );
+	for( Uint16 i = 0; i < 4; ++i )
+		out.Fixed[i] = i * 3;
+	out.Names.push_back( "Block" );
+
+	std::stringstream stream( std::ios_base::in | std::ios_base::out | std::ios_base::binary );
+	BinarySerialiser b;
+	b
+		.SetStream( stream )
+		.Serialise( out );
+
+	// Plain values are written as one block each: count, marker, then the raw values.
+	const String bytes = stream.str();
+	Uint32 samples = 0;
+	for( size_t i = 0; i + sizeof( Uint32 ) < bytes.size(); ++i ) {
+		memcpy( &samples, &bytes[i], sizeof( Uint32 ) );
+		if( samples == 1000 ) {
+			ASSERT_EQ( BinarySerialiser::ValueBlockMarker, Uchar( bytes[i + sizeof( Uint32 )] ) );
+			ASSERT_EQ( 0, memcmp( &bytes[i + sizeof( Uint32 ) + 1], &out.Samples[0], 1000 * sizeof( Float32 ) ) );
+			break;
+		}
+	}
+	ASSERT_EQ( 1000, samples );
+
+	BinaryBlockTest in;
+	memset( in.Fixed, 0, sizeof( in.Fixed ) );
+	BinaryDeserialiser d;
+	d.SetStream( stream );
+	ASSERT_FALSE( d.IsStreamEnded() );
+	d.Deserialise( in );
+
+	ASSERT_EQ( out.Samples, in.Samples );
+	for( size_t i = 0; i < 4; ++i )
+		ASSERT_EQ( out.Fixed[i], in.Fixed[i] );
+	ASSERT_EQ( out.Names, in.Names );
+
+	// Clone, Equals and HashContents take the same block path.
+	BinaryBlockTest copy;
+	type.Clone( &copy, &out );
+	ASSERT_EQ( out.Samples, copy.Samples );
+	ASSERT_TRUE( type.Equals( &out, &copy ) );
+	ASSERT_EQ( type.HashContents( &out ), type.HashContents( &copy ) );
+	copy.Samples[999] = -1.0f;
+	ASSERT_FALSE( type.Equals( &out, &copy ) );
+
+	ForceReconstructEntityManager_BinaryS();
+}
+
+TEST( BinarySerialisationTest, TruncatedValueBlockTest )
+{
+	CBL_ENT.Types.Create<BinaryBlockTest>()
+		.CBL_FIELD( Samples, BinaryBlockTest )
+		.CBL_FIELD( Fixed, BinaryBlockTest )
+		.CBL_FIELD( Names, BinaryBlockTest );
+
+	BinaryBlockTest out;
+	for( Uint32 i = 0; i < 1000; ++i )
+		out.Samples.push_back( i * 0.25f );
+
+	std::stringstream stream( std::ios_base::in | std::ios_base::out | std::ios_base::binary );
+	BinarySerialiser b;
+	b
+		.SetStream( stream )
+		.Serialise( out );
+
+	const String bytes = stream.str();
+	size_t block = 0;
+	for( Uint32 samples = 0; block + sizeof( Uint32 ) < bytes.size(); ++block ) {
+		memcpy( &samples, &bytes[block], sizeof( Uint32 ) );
+		if( samples == 1000 )
+			break;
+	}
+	ASSERT_LT( block + sizeof( Uint32 ), bytes.size() );
+
+	// A stream cut off inside the block fails without growing the container.
+	{
+		std::stringstream cut( bytes.substr( 0, block + sizeof( Uint32 ) + 1 + 100 * sizeof( Float32 ) ),
+			std::ios_base::in | std::ios_base::binary );
+		BinaryBlockTest in;
+		BinaryDeserialiser d;
+		d.SetStream( cut );
+		d.Deserialise( in );
+		ASSERT_TRUE( cut.fail() );
+		ASSERT_TRUE( in.Samples.empty() );
+	}
+
+	// So does a count larger than the stream.
+	{
+		String forged = bytes;
+		const Uint32 count = 0xFFFFFFFF;
+		memcpy( &forged[block], &count, sizeof( Uint32 ) );
+		std::stringstream huge( forged, std::ios_base::in | std::ios_base::binary );
+		BinaryBlockTest in;
+		BinaryDeserialiser d;
+		d.SetStream( huge );
+		d.Deserialise( in );
+		ASSERT_TRUE( huge.fail() );
+		ASSERT_TRUE( in.Samples.empty() );
+	}
+
+	ForceReconstructEntityManager_BinaryS();
+}
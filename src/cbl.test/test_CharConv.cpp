@@ -0,0 +1,115 @@
+/* This source file is part of the Chewable Framework.
+ * For the latest info, please visit http://chewable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file test_CharConv.cpp
+ * @brief Unit testing for number to text conversion.
+ */
+
+// Precompiled Headers //
+#include "cbl/StdAfx.h"
+
+// Chewable Headers //
+#include <cbl/Chewable.h>
+#include <cbl/Util/CharConv.h>
+#include <cbl/Reflection/Typing.h>
+#include <cbl/Reflection/EntityManager.h>
+
+// Google Test //
+#include <gtest/gtest.h>
+
+using namespace cbl;
+
+namespace
+{
+	template< typename TYPE >
+	String Format( TYPE value, bool hex = false )
+	{
+		Char buf[CharConv::MaxChars];
+		return String( buf, CharConv::Format( buf, value, hex ) );
+	}
+
+	template< typename TYPE >
+	TYPE Parse( const String& str, bool hex = false, TYPE fallback = TYPE() )
+	{
+		TYPE value = fallback;
+		CharConv::Parse( str.c_str(), str.c_str() + str.length(), value, hex );
+		return value;
+	}
+}
+
+TEST( CharConvTest, IntegerTest )
+{
+	ASSERT_EQ( "0", Format( Uint32( 0 ) ) );
+	ASSERT_EQ( "123807", Format( Uint32( 123807 ) ) );
+	ASSERT_EQ( "-42", Format( Int8( -42 ) ) );
+	ASSERT_EQ( "-9223372036854775808", Format( std::numeric_limits< Int64 >::min() ) );
+	ASSERT_EQ( "18446744073709551615", Format( std::numeric_limits< Uint64 >::max() ) );
+	ASSERT_EQ( "0xff", Format( Uint16( 255 ), true ) );
+	ASSERT_EQ( "0xffffffff", Format( Int32( -1 ), true ) );
+
+	ASSERT_EQ( 50, Parse< Int8 >( " 50" ) );
+	ASSERT_EQ( -128, Parse< Int8 >( "-128" ) );
+	ASSERT_EQ( 7, Parse< Int8 >( "128", false, 7 ) );
+	ASSERT_EQ( 7u, Parse< Uint32 >( "-1", false, 7 ) );
+	ASSERT_EQ( 7u, Parse< Uint32 >( "x", false, 7 ) );
+	ASSERT_EQ( 255, Parse< Uint16 >( "0xff", true ) );
+	ASSERT_EQ( 255, Parse< Uint16 >( "FF", true ) );
+	ASSERT_EQ( -1, Parse< Int32 >( "0xffffffff", true ) );
+	ASSERT_EQ( std::numeric_limits< Int64 >::min(), Parse< Int64 >( "-9223372036854775808" ) );
+	ASSERT_EQ( 7u, Parse< Uint64 >( "18446744073709551616", false, 7 ) );
+}
+
+TEST( CharConvTest, FloatTest )
+{
+	// Short forms are kept, other values get the digits they need to read back.
+	ASSERT_EQ( "0.5", Format( 0.5f ) );
+	ASSERT_EQ( "0.1", Format( 0.1f ) );
+	ASSERT_EQ( "0.1", Format( 0.1 ) );
+	ASSERT_EQ( "-2", Format( -2.0 ) );
+
+	const Float32 floats[] = { 3.14159265f, 1.0f / 3.0f, 16777217.0f, 1e-38f, -123456.789f };
+	for( size_t i = 0; i < sizeof( floats ) / sizeof( floats[0] ); ++i )
+		ASSERT_EQ( floats[i], Parse< Float32 >( Format( floats[i] ) ) );
+
+	const Float64 doubles[] = { 3.141592653589793, 1.0 / 3.0, 9007199254740993.0, 1e-300, 0.1 + 0.2 };
+	for( size_t i = 0; i < sizeof( doubles ) / sizeof( doubles[0] ); ++i )
+		ASSERT_EQ( doubles[i], Parse< Float64 >( Format( doubles[i] ) ) );
+
+	ASSERT_EQ( 1.5f, Parse< Float32 >( " 1.5e0" ) );
+	ASSERT_EQ( 2.0f, Parse< Float32 >( "abc", false, 2.0f ) );
+}
+
+TEST( CharConvTest, StringifierTest )
+{
+	const Type* type = CBL_ENT.Types.Get<Float32>();
+	Float32 value = 1.0f / 3.0f, read = 0.0f;
+	String str;
+	type->ToString( str, type, &value, NULL );
+	type->FromString( str, type, &read, NULL );
+	ASSERT_EQ( value, read );
+
+	type = CBL_ENT.Types.Get<Uint32>();
+	Uint32 hex = 0xbeef;
+	FieldAttr attr( FieldAttr::F_HEX );
+	type->ToString( str, type, &hex, &attr );
+	ASSERT_EQ( "0xbeef", str );
+	hex = 0;
+	type->FromString( str, type, &hex, &attr );
+	ASSERT_EQ( 0xbeefu, hex );
+}
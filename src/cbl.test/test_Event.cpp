@@ -26,6 +26,7 @@
 
 // Chewable Headers //
 #include <cbl/Core/Event.h>
+#include <cbl/Util/Stopwatch.h>
 
 // Google Test //
 #include <gtest/gtest.h>
@@ -187,3 +188,108 @@ TEST_F( EventUnregisterFixture, EventCurrentUnregister )
 	ASSERT_EQ( ol2.tX, 0 );
 	ASSERT_EQ( ol2.tY, 0 );
 }
+
+//! Parallel raise fixture.
+class EventParallelFixture : public ::testing::Test
+{
+protected:
+
+	typedef Event< void( int work ) > WorkEvent;
+
+	//! Independent listener which does a configurable amount of busy work.
+	class WorkListener
+	{
+	public:
+		WorkListener() : calls( 0 ), result( 0 ) {}
+
+		void OnWork( int work )
+		{
+			Uint32 acc = result;
+			for( int i = 0; i < work; ++i )
+				acc = acc * 1664525u + 1013904223u;
+			result = acc;
+			++calls;
+		}
+
+		int		calls;
+		Uint32	result;
+	};
+
+	//! Register count listeners in parallel mode.
+	void Populate( Uint32 count )
+	{
+		evt.Clear();
+		listeners.assign( count, WorkListener() );
+		for( Uint32 i = 0; i < count; ++i )
+			evt.RegisterParallel( WorkEvent::Method<CBL_E_METHOD(WorkListener,OnWork)>(&listeners[i]) );
+	}
+
+protected:
+
+	std::vector< WorkListener >	listeners;
+	WorkEvent					evt;
+};
+
+TEST_F( EventParallelFixture, Event_RaiseParallelTest )
+{
+	Populate( CBL_EVENT_PARALLEL_MIN * 8 );
+	evt.RaiseParallel( 10 );
+	evt.RaiseParallel( 10 );
+	evt.Raise( 10 );
+
+	CBL_FOREACH( std::vector< WorkListener >, it, listeners )
+		ASSERT_EQ( it->calls, 3 );
+
+	// Unregistered parallel listeners are skipped and swept.
+	evt -= WorkEvent::Method<CBL_E_METHOD(WorkListener,OnWork)>(&listeners[3]);
+	evt.RaiseParallel( 10 );
+
+	for( size_t i = 0; i < listeners.size(); ++i )
+		ASSERT_EQ( listeners[i].calls, i == 3 ? 3 : 4 );
+}
+
+TEST_F( EventParallelFixture, Event_RaiseParallelSerialFirstTest )
+{
+	WorkListener serial;
+	Populate( CBL_EVENT_PARALLEL_MIN * 2 );
+	evt += WorkEvent::Method<CBL_E_METHOD(WorkListener,OnWork)>(&serial);
+	evt.RaiseParallel( 1 );
+
+	ASSERT_EQ( serial.calls, 1 );
+	CBL_FOREACH( std::vector< WorkListener >, it, listeners )
+		ASSERT_EQ( it->calls, 1 );
+}
+
+//! Prints serial vs. parallel raise timings to find the crossover point for
+//! CBL_EVENT_PARALLEL_MIN on the current machine.
+TEST_F( EventParallelFixture, DISABLED_Event_RaiseParallelCrossoverBenchmark )
+{
+	static const Uint32 Counts[] = { 16, 64, 256, 1024, 4096 };
+	static const int Work[] = { 0, 64, 1024 };
+	static const int Iterations = 50;
+
+	Stopwatch sw;
+	printf( "workers: %u\n", WorkerPool::Instance().GetWorkerCount() );
+	printf( "%8s %8s %12s %12s\n", "count", "work", "serial(us)", "parallel(us)" );
+	for( Uint32 c = 0; c < sizeof( Counts ) / sizeof( Counts[0] ); ++c ) {
+		Populate( Counts[c] );
+		for( Uint32 w = 0; w < sizeof( Work ) / sizeof( Work[0] ); ++w ) {
+			sw.Reset(); sw.Start();
+			for( int i = 0; i < Iterations; ++i )
+				evt.Raise( Work[w] );
+			sw.Stop();
+			Float64 serial = sw.GetElapsedTime().TotalSeconds() * 1e6 / Iterations;
+
+			sw.Reset(); sw.Start();
+			for( int i = 0; i < Iterations; ++i )
+				evt.RaiseParallel( Work[w] );
+			sw.Stop();
+			Float64 parallel = sw.GetElapsedTime().TotalSeconds() * 1e6 / Iterations;
+
+			printf( "%8u %8d %12.2f %12.2f\n", Counts[c], Work[w], serial, parallel );
+		}
+
+		CBL_FOREACH( std::vector< WorkListener >, it, listeners )
+			ASSERT_EQ( it->calls, Iterations * 2 * int( sizeof( Work ) / sizeof( Work[0] ) ) );
+	}
+}
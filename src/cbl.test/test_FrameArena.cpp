@@ -0,0 +1,95 @@
+/* This source file is part of the Chewable Framework.
+ * For the latest info, please visit http://chewable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file test_FrameArena.cpp
+ * @brief Unit testing for frame arena allocator.
+ */
+
+// Precompiled Headers //
+#include "cbl/StdAfx.h"
+
+// Chewable Headers //
+#include <cbl/Chewable.h>
+#include <cbl/Memory/FrameArena.h>
+
+// Google Test //
+#include <gtest/gtest.h>
+
+using namespace cbl;
+
+TEST( FrameArenaFixture, FrameArena_AllocateTest )
+{
+	FrameArena arena( 256 );
+
+	Char* a = static_cast<Char*>( arena.Allocate( 10, 1 ) );
+	Uint64* b = static_cast<Uint64*>( arena.Allocate( sizeof(Uint64), alignof(Uint64) ) );
+	ASSERT_TRUE( a != NULL );
+	ASSERT_EQ( reinterpret_cast<size_t>( b ) % alignof(Uint64), 0 );
+	ASSERT_GE( arena.GetUsed(), 10 + sizeof(Uint64) );
+
+	// Spill into a second block, then reset back to a single block that fits the peak.
+	arena.Allocate( 300, 1 );
+	ASSERT_GT( arena.GetCapacity(), 256 );
+	size_t peak = arena.GetHighWater();
+
+	arena.Reset();
+	ASSERT_EQ( arena.GetUsed(), 0 );
+	ASSERT_EQ( arena.GetHighWater(), peak );
+	ASSERT_EQ( arena.GetCapacity(), peak );
+}
+
+TEST( FrameArenaFixture, FrameArena_ScopeTest )
+{
+	FrameArena arena( 128 );
+	arena.Allocate( 16 );
+	size_t used = arena.GetUsed();
+	{
+		FrameScope outer( arena );
+		void* first = arena.Allocate( 32 );
+		{
+			FrameScope inner( arena );
+			arena.Allocate( 200 );
+		}
+		ASSERT_EQ( arena.GetUsed(), used + 32 );
+		// Memory released by the inner scope is handed out again.
+		FrameScope again( arena );
+		ASSERT_TRUE( arena.Allocate( 8 ) > first );
+	}
+	ASSERT_EQ( arena.GetUsed(), used );
+}
+
+TEST( FrameArenaFixture, FrameArena_AllocatorTest )
+{
+	FrameArena arena( 64 );
+	{
+		FrameScope scope( arena );
+		FrameVector< Uint32 >::Type values( ( FrameAllocator< Uint32 >( arena ) ) );
+		for( Uint32 i = 0; i < 1000; ++i )
+			values.push_back( i );
+
+		for( Uint32 i = 0; i < 1000; ++i )
+			ASSERT_EQ( values[i], i );
+		ASSERT_GE( arena.GetHighWater(), 1000 * sizeof(Uint32) );
+	}
+	ASSERT_EQ( arena.GetUsed(), 0 );
+
+	// The default allocator uses the calling thread's arena.
+	FrameAllocator< Uint32 > alloc;
+	ASSERT_EQ( alloc.GetArena(), &FrameArena::Get() );
+}
@@ -179,3 +179,63 @@ TEST_F( CompCollectionFixture, GameComponentCollection_Test )
 	ASSERT_EQ( drawablesAdded, 1 );
 	ASSERT_EQ( drawablesRemoved, 1 );
 }
+
+TEST_F( CompCollectionFixture, GameComponentCollection_SortTest )
+{
+	TestComponent c1( game ), c2( game ), c3( game );
+	c1.UpdateOrder = 3;
+	c2.UpdateOrder = 1;
+	c3.UpdateOrder = 2;
+
+	componentList.Add( &c1 );
+	componentList.Add( &c2 );
+	componentList.Add( &c3 );
+	componentList.Sort();
+
+	ASSERT_EQ( componentList.GetSlot( 0 ), &c2 );
+	ASSERT_EQ( componentList.GetSlot( 1 ), &c3 );
+	ASSERT_EQ( componentList.GetSlot( 2 ), &c1 );
+
+	// Changing an order is picked up on the next sort.
+	c1.UpdateOrder = 0;
+	componentList.Sort();
+	ASSERT_EQ( componentList.GetSlot( 0 ), &c1 );
+
+	componentList.clear();
+	ASSERT_EQ( componentList.size(), 0 );
+}
+
+TEST_F( CompCollectionFixture, GameComponentCollection_RemoveDuringIterationTest )
+{
+	TestComponent c1( game ), c2( game ), c3( game );
+	componentList.Add( &c1 );
+	componentList.Add( &c2 );
+	componentList.Add( drawcomponent );
+	componentList.Add( &c3 );
+
+	// Removing leaves the slot in place so indices and iterators stay valid.
+	Uint32 visited = 0;
+	GameComponentCollection::iterator it = componentList.begin();
+	componentList.Remove( &c2 );
+	componentList.Remove( static_cast< GameComponent * >( drawcomponent ) );
+	for( ; it != componentList.end(); ++it ) {
+		ASSERT_TRUE( *it != NULL );
+		++visited;
+	}
+
+	ASSERT_EQ( visited, 2 );
+	ASSERT_EQ( componentList.size(), 2 );
+	ASSERT_EQ( componentList.GetSlotCount(), 4 );
+	ASSERT_TRUE( componentList.GetSlot( 1 ) == NULL );
+	ASSERT_TRUE( componentList.GetDrawSlot( 0 ) == NULL );
+
+	componentList.Sort();
+	ASSERT_EQ( componentList.GetSlotCount(), 2 );
+	ASSERT_EQ( componentList.GetDrawSlotCount(), 0 );
+	ASSERT_EQ( *componentList.rbegin(), &c3 );
+
+	componentList.Remove( &c1 );
+	componentList.Remove( &c3 );
+	ASSERT_TRUE( componentList.begin() == componentList.end() );
+	ASSERT_TRUE( componentList.rbegin() == componentList.rend() );
+}
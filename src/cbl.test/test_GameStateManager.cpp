@@ -27,6 +27,7 @@
 // Chewable Headers //
 #include <cbl/Chewable.h>
 #include <cbl/Core/GameStateManager.h>
+#include <cbl/Core/ObjectManager.h>
 
 // Google Test //
 #include <gtest/gtest.h>
@@ -87,6 +88,36 @@ public:
 
 CBL_TYPE( TestGameState, TestGameState );
 
+class TestPreloadState : public GameState
+{
+protected:
+	TestPreloadState() : loaded( false ) {}
+
+public:
+	virtual void Preload( void )
+	{
+		SetLoadProgress( 0.5f );
+		loaded = true;
+		++preloadCount;
+	}
+
+	virtual void Activate( void )
+	{
+		activatedLoaded = loaded;
+	}
+
+	bool loaded;
+	static cbl::Uint32 preloadCount;
+	static bool activatedLoaded;
+
+	CBL_GAMESTATE_FRIENDS;
+};
+
+CBL_TYPE( TestPreloadState, TestPreloadState );
+
+cbl::Uint32 TestPreloadState::preloadCount	= 0;
+bool TestPreloadState::activatedLoaded		= false;
+
 cbl::Uint32 TestGameState::actCount		= 0;
 cbl::Uint32 TestGameState::deactCount	= 0;
 cbl::Uint32 TestGameState::pauseCount	= 0;
@@ -102,7 +133,11 @@ private:
 		TestGameState::pauseCount	= 0;
 		TestGameState::resumeCount	= 0;
 
+		TestPreloadState::preloadCount		= 0;
+		TestPreloadState::activatedLoaded	= false;
+
 		CBL_ENT.Types.Create<TestGameState>();
+		CBL_ENT.Types.Create<TestPreloadState>();
 	}
 
 	void TearDown( void )
@@ -229,3 +264,83 @@ TEST_F( GameStateManagerFixture, StateMultiTest )
 	ASSERT_EQ( TestGameState::pauseCount, 11 );
 	ASSERT_EQ( TestGameState::resumeCount, 11 );
 }
+
+TEST_F( GameStateManagerFixture, StatePreloadTest )
+{
+	ASSERT_FALSE( States.IsPreloaded<TestPreloadState>() );
+	ASSERT_EQ( States.GetPreloadProgress<TestPreloadState>(), 0 );
+
+	States.PreloadState<TestPreloadState>();
+	while( !States.IsPreloaded<TestPreloadState>() )
+		std::this_thread::yield();
+	ASSERT_EQ( States.GetPreloadProgress<TestPreloadState>(), 1 );
+	ASSERT_EQ( TestPreloadState::preloadCount, 1 );
+
+	// Push takes the preloaded state rather than creating a new one.
+	States.Push<TestPreloadState>();
+	ASSERT_FALSE( States.IsPreloaded<TestPreloadState>() );
+	States.Update();
+	ASSERT_TRUE( TestPreloadState::activatedLoaded );
+	ASSERT_EQ( TestPreloadState::preloadCount, 1 );
+
+	// Pushing without a preload still works, and Clear releases pending preloads.
+	States.Push<TestGameState>();
+	States.PreloadState<TestPreloadState>();
+	States.Clear();
+	States.Update();
+	ASSERT_EQ( TestGameState::deactCount, 1 );
+	ASSERT_EQ( TestPreloadState::preloadCount, 2 );
+}
+
+TEST_F( GameStateManagerFixture, StatePartitionTest )
+{
+	std::vector<GameState*> running;
+	std::vector<ObjectPtr> live;
+	ObjectManager objects;
+
+	States.Push<TestGameState>();
+	States.Update();
+	States.GetRunningStates( running );
+	ASSERT_EQ( running.size(), 1 );
+	GameState* gameplay = running[0];
+	ASSERT_TRUE( gameplay->IsRunning() );
+
+	ObjectPtr world = objects.Create<Object>( CName( "World" ) );
+	ObjectPtr player = objects.Create<Object>( CName( "Player" ) );
+	ObjectPtr enemy = objects.Create<Object>( CName( "Enemy" ) );
+	gameplay->AddObject( player );
+	gameplay->AddObject( enemy );
+	ASSERT_EQ( objects.GetUnownedObjects().size(), 1 );
+	objects.GetLiveObjects( live );
+	ASSERT_EQ( live.size(), 3 );
+
+	// Pushing a menu pauses gameplay, so its partition drops out.
+	States.Push<TestGameState>();
+	States.Add<TestGameState>( "TestPersistent" );
+	States.Update();
+	States.GetRunningStates( running );
+	ASSERT_EQ( running.size(), 2 );
+	ASSERT_FALSE( gameplay->IsRunning() );
+	ASSERT_TRUE( std::find( running.begin(), running.end(), gameplay ) == running.end() );
+	objects.GetLiveObjects( live );
+	ASSERT_EQ( live.size(), 1 );
+	ASSERT_EQ( live[0], world );
+	ASSERT_TRUE( player->IsDormant() );
+
+	States.Pop();
+	States.Update();
+	States.GetRunningStates( running );
+	ASSERT_EQ( running.size(), 2 );
+	ASSERT_TRUE( gameplay->IsRunning() );
+
+	// Released and destroyed objects leave the partition.
+	gameplay->RemoveObject( enemy );
+	objects.Destroy( player );
+	objects.Purge();
+	ASSERT_EQ( gameplay->GetObjects().size(), 0 );
+	objects.GetLiveObjects( live );
+	ASSERT_EQ( live.size(), 2 );
+	ASSERT_EQ( objects.GetUnownedObjects().size(), 2 );
+
+	States.Clear();
+}
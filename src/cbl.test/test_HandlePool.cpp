@@ -0,0 +1,132 @@
+/* This source file is part of the Chewable Framework.
+ * For the latest info, please visit http://chewable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/**
+ * @file test_HandlePool.cpp
+ * @brief Unit testing for handle-based compacting pool.
+ */
+
+// Precompiled Headers //
+#include "cbl/StdAfx.h"
+
+// Chewable Headers //
+#include <cbl/Chewable.h>
+#include <cbl/Memory/HandlePool.h>
+#include <cbl/Reflection/Typing.h>
+#include <cbl/Reflection/EntityManager.h>
+
+// Google Test //
+#include <gtest/gtest.h>
+
+using namespace cbl;
+
+struct HandlePoolTest {
+	cbl::Uint64 value;
+	std::vector<cbl::Uint32> data;
+
+	HandlePoolTest() : value( 0 ) {}
+	HandlePoolTest( cbl::Uint64 v ) : value( v ), data( 4, cbl::Uint32( v ) ) {}
+};
+
+CBL_TYPE( HandlePoolTest, HandlePoolTest );
+
+typedef HandlePool<HandlePoolTest,16> TestPool;
+
+TEST( HandlePoolFixture, HandlePool_CompactTest ) {
+	TestPool pool;
+	std::vector<TestPool::Handle> handles;
+
+	for( Uint64 i = 0; i < 256; ++i )
+		handles.push_back( pool.Allocate( i ) );
+	ASSERT_EQ( pool.GetPageCount(), 16 );
+
+	// Leave one object in every second slot.
+	for( size_t i = 0; i < handles.size(); i += 2 )
+		ASSERT_TRUE( pool.Deallocate( handles[i] ) );
+	ASSERT_EQ( pool.GetCount(), 128 );
+	ASSERT_EQ( pool.GetPageCount(), 16 );
+	ASSERT_EQ( pool.Get( handles[0] ), (HandlePoolTest*)NULL );
+	ASSERT_FALSE( pool.Deallocate( handles[0] ) );
+
+	Uint32 moved = pool.Compact( TimeSpan::FromSeconds( 10.0 ) );
+	ASSERT_GT( moved, 0u );
+	ASSERT_EQ( pool.GetPageCount(), 8 );
+	ASSERT_EQ( pool.Compact( TimeSpan::FromSeconds( 10.0 ) ), 0u );
+
+	for( size_t i = 1; i < handles.size(); i += 2 ) {
+		HandlePoolTest* obj = pool.Get( handles[i] );
+		ASSERT_NE( obj, (HandlePoolTest*)NULL );
+		ASSERT_EQ( obj->value, i );
+		ASSERT_EQ( obj->data.size(), 4u );
+		ASSERT_EQ( obj->data[3], Uint32( i ) );
+	}
+
+	// Stale handles don't alias reused entries.
+	TestPool::Handle reused = pool.Allocate( 1000 );
+	ASSERT_EQ( reused.Index, handles[254].Index );
+	ASSERT_EQ( pool.Get( handles[254] ), (HandlePoolTest*)NULL );
+	ASSERT_EQ( pool.Get( reused )->value, 1000u );
+}
+
+TEST( HandlePoolFixture, HandlePool_PinTest ) {
+	TestPool pool;
+	std::vector<TestPool::Handle> handles;
+
+	for( Uint64 i = 0; i < 64; ++i )
+		handles.push_back( pool.Allocate( i ) );
+	for( size_t i = 0; i < handles.size(); ++i )
+		if( i % 16 != 0 )
+			pool.Deallocate( handles[i] );
+	ASSERT_EQ( pool.GetPageCount(), 4 );
+
+	// Every page holds a single pinned object, so nothing can move.
+	std::vector<HandlePoolTest*> pinned;
+	for( size_t i = 0; i < handles.size(); i += 16 )
+		pinned.push_back( pool.Pin( handles[i] ) );
+	ASSERT_EQ( pool.Compact( TimeSpan::FromSeconds( 10.0 ) ), 0u );
+	ASSERT_EQ( pool.GetPageCount(), 4 );
+	for( size_t i = 0; i < pinned.size(); ++i )
+		ASSERT_EQ( pool.Get( handles[i * 16] ), pinned[i] );
+
+	for( size_t i = 0; i < handles.size(); i += 16 )
+		pool.Unpin( handles[i] );
+	ASSERT_EQ( pool.Compact( TimeSpan::FromSeconds( 10.0 ) ), 3u );
+	ASSERT_EQ( pool.GetPageCount(), 1 );
+	for( size_t i = 0; i < handles.size(); i += 16 )
+		ASSERT_EQ( pool.Get( handles[i] )->value, i );
+}
+
+TEST( HandlePoolFixture, HandlePool_TypeRelocateTest ) {
+	const Type& type = CBL_ENT.Types.Create<HandlePoolTest>();
+	ASSERT_NE( type.Relocate, (RelocateFunc)NULL );
+
+	TestPool pool( type.Relocate );
+	std::vector<TestPool::Handle> handles;
+	for( Uint64 i = 0; i < 32; ++i )
+		handles.push_back( pool.Allocate( i ) );
+	for( size_t i = 1; i < handles.size(); ++i )
+		if( i != 17 )
+			pool.Deallocate( handles[i] );
+	ASSERT_EQ( pool.GetPageCount(), 2 );
+
+	ASSERT_EQ( pool.Compact( TimeSpan::FromSeconds( 10.0 ) ), 1u );
+	ASSERT_EQ( pool.GetPageCount(), 1 );
+	ASSERT_EQ( pool.Get( handles[0] )->value, 0u );
+	ASSERT_EQ( pool.Get( handles[17] )->data[0], 17u );
+}
@@ -27,10 +27,14 @@
 // Chewable Headers //
 #include <cbl/Chewable.h>
 #include <cbl/Memory/Heap.h>
+#include <cbl/Util/Stopwatch.h>
 
 // Google Test //
 #include <gtest/gtest.h>
 
+// External Dependencies //
+#include <memory>
+
 using namespace cbl;
 
 struct HeapTest {
@@ -233,4 +237,85 @@ TEST( HeapFixtureTest, Heap_AllocDeallocNonPower2Test ) {
     for( cbl::Uint32 i = 0; i < amt; ++i ) {
         ASSERT_FALSE( heapTest.Deallocate( arr[i] ) );
     }
-}
\ No newline at end of file
+}
+
+struct HeapMoveTest {
+	std::unique_ptr<int> value;
+
+	explicit HeapMoveTest( std::unique_ptr<int>&& v ) : value( std::move( v ) ) {}
+};
+
+TEST( HeapFixtureTest, Heap_ForwardTest ) {
+	Heap<HeapMoveTest,40>	heapTest;
+
+	// Move-only arguments must be forwarded, not copied.
+	HeapMoveTest* obj = heapTest.Allocate( std::unique_ptr<int>( new int( 7 ) ) );
+	ASSERT_TRUE( obj != NULL );
+	ASSERT_EQ( *obj->value, 7 );
+	ASSERT_EQ( heapTest.GetFreeCount(), 39 );
+	ASSERT_TRUE( heapTest.Deallocate( obj ) );
+	ASSERT_TRUE( heapTest.IsEmpty() );
+}
+
+TEST( HeapFixtureTest, Heap_InvalidDeallocTest ) {
+	Heap<HeapTest,64>	heapTest;
+	HeapTest			outside;
+
+	HeapTest* a = heapTest.Allocate();
+	HeapTest* b = heapTest.Allocate();
+	ASSERT_TRUE( heapTest.Owns( a ) );
+	ASSERT_FALSE( heapTest.Owns( &outside ) );
+	ASSERT_FALSE( heapTest.Deallocate( &outside ) );
+	ASSERT_FALSE( heapTest.Deallocate( reinterpret_cast<HeapTest*>( reinterpret_cast<Char*>( b ) + 1 ) ) );
+	ASSERT_FALSE( heapTest.Deallocate( NULL ) );
+
+	ASSERT_TRUE( heapTest.Deallocate( a ) );
+	ASSERT_FALSE( heapTest.Deallocate( a ) );
+
+	// The freed slot is the lowest free one, so it's reused first.
+	ASSERT_EQ( heapTest.Allocate(), a );
+	ASSERT_EQ( heapTest.GetFreeCount(), 62 );
+}
+
+TEST( HeapFixtureTest, DISABLED_Heap_MallocBenchmark ) {
+	static const Uint32 amt = 32768;
+	static const int Iterations = 20;
+
+	Heap<HeapTest,amt>*	heapTest = new Heap<HeapTest,amt>;
+	std::vector<HeapTest*> arr( amt );
+	Stopwatch sw;
+
+	sw.Reset(); sw.Start();
+	for( int n = 0; n < Iterations; ++n ) {
+		for( Uint32 i = 0; i < amt; ++i )
+			arr[i] = heapTest->Allocate( int( i ) );
+		// Free every other object first to leave the heap fragmented.
+		for( Uint32 i = 0; i < amt; i += 2 )
+			heapTest->Deallocate( arr[i] );
+		for( Uint32 i = 1; i < amt; i += 2 )
+			heapTest->Deallocate( arr[i] );
+	}
+	sw.Stop();
+	Float64 heap = sw.GetElapsedTime().TotalSeconds() * 1e9 / ( Iterations * amt );
+
+	sw.Reset(); sw.Start();
+	for( int n = 0; n < Iterations; ++n ) {
+		for( Uint32 i = 0; i < amt; ++i )
+			arr[i] = new ( malloc( sizeof(HeapTest) ) ) HeapTest( int( i ) );
+		for( Uint32 i = 0; i < amt; i += 2 ) {
+			arr[i]->~HeapTest();
+			free( arr[i] );
+		}
+		for( Uint32 i = 1; i < amt; i += 2 ) {
+			arr[i]->~HeapTest();
+			free( arr[i] );
+		}
+	}
+	sw.Stop();
+	Float64 system = sw.GetElapsedTime().TotalSeconds() * 1e9 / ( Iterations * amt );
+
+	printf( "%12s %12s\n", "heap(ns)", "malloc(ns)" );
+	printf( "%12.2f %12.2f\n", heap, system );
+	ASSERT_TRUE( heapTest->IsEmpty() );
+	delete heapTest;
+}
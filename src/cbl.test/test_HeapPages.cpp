@@ -0,0 +1,116 @@
+/* This source file is part of the Chewable Framework.
+ * For the latest info, please visit http://chewable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file test_HeapPages.cpp
+ * @brief Unit testing for paged heap allocator.
+ */
+
+// Precompiled Headers //
+#include "cbl/StdAfx.h"
+
+// Chewable Headers //
+#include <cbl/Chewable.h>
+#include <cbl/Memory/HeapPages.h>
+
+// Google Test //
+#include <gtest/gtest.h>
+
+using namespace cbl;
+
+struct PageTest {
+	cbl::Uint32 value;
+	int* destroyed;
+
+	PageTest( cbl::Uint32 v, int* counter ) : value( v ), destroyed( counter ) {}
+	~PageTest() { ++*destroyed; }
+};
+
+TEST( HeapPagesFixtureTest, HeapPages_GrowTest ) {
+	static const Uint32 amt = 1000;
+	int destroyed = 0;
+
+	HeapPages<PageTest,64> pages( 0 );
+	std::vector<PageTest*> arr( amt );
+
+	for( Uint32 i = 0; i < amt; ++i ) {
+		arr[i] = pages.Allocate( i, &destroyed );
+		ASSERT_TRUE( arr[i] != NULL );
+	}
+	ASSERT_EQ( pages.GetPageCount(), ( amt + 63 ) / 64 );
+
+	for( Uint32 i = 0; i < amt; ++i ) {
+		ASSERT_TRUE( pages.Owns( arr[i] ) );
+		ASSERT_EQ( arr[i]->value, i );
+	}
+
+	for( Uint32 i = 0; i < amt; ++i )
+		ASSERT_TRUE( pages.Deallocate( arr[i] ) );
+	ASSERT_EQ( destroyed, amt );
+
+	// With no empty pages allowed, everything is released.
+	ASSERT_EQ( pages.GetPageCount(), 0 );
+	ASSERT_EQ( pages.GetEmptyPageCount(), 0 );
+}
+
+TEST( HeapPagesFixtureTest, HeapPages_InvalidDeallocTest ) {
+	int destroyed = 0;
+	HeapPages<PageTest,32> pages;
+	PageTest outside( 0, &destroyed );
+
+	PageTest* obj = pages.Allocate( 1u, &destroyed );
+	ASSERT_FALSE( pages.Owns( &outside ) );
+	ASSERT_FALSE( pages.Deallocate( &outside ) );
+	ASSERT_FALSE( pages.Deallocate( NULL ) );
+	ASSERT_TRUE( pages.Deallocate( obj ) );
+	ASSERT_FALSE( pages.Deallocate( obj ) );
+	ASSERT_EQ( destroyed, 1 );
+}
+
+TEST( HeapPagesFixtureTest, HeapPages_HighWaterTest ) {
+	int destroyed = 0;
+	HeapPages<PageTest,32> pages( 2 );
+	std::vector<PageTest*> arr;
+
+	for( Uint32 i = 0; i < 32 * 5; ++i )
+		arr.push_back( pages.Allocate( i, &destroyed ) );
+	ASSERT_EQ( pages.GetPageCount(), 5 );
+	ASSERT_EQ( pages.GetEmptyPageCount(), 0 );
+
+	// Free one slot in every page, then refill; no new pages should be needed.
+	for( Uint32 p = 0; p < 5; ++p )
+		ASSERT_TRUE( pages.Deallocate( arr[p * 32] ) );
+	for( Uint32 p = 0; p < 5; ++p )
+		arr[p * 32] = pages.Allocate( p, &destroyed );
+	ASSERT_EQ( pages.GetPageCount(), 5 );
+
+	// Empty everything; only the high-water mark of empty pages is kept.
+	for( size_t i = 0; i < arr.size(); ++i )
+		ASSERT_TRUE( pages.Deallocate( arr[i] ) );
+	ASSERT_EQ( pages.GetPageCount(), 2 );
+	ASSERT_EQ( pages.GetEmptyPageCount(), 2 );
+
+	pages.SetMaxEmptyPages( 1 );
+	ASSERT_EQ( pages.GetPageCount(), 1 );
+
+	// Kept pages are reused.
+	PageTest* obj = pages.Allocate( 7u, &destroyed );
+	ASSERT_EQ( pages.GetPageCount(), 1 );
+	ASSERT_EQ( pages.GetEmptyPageCount(), 0 );
+	ASSERT_TRUE( pages.Deallocate( obj ) );
+}
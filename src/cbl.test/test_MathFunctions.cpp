@@ -63,3 +63,15 @@ TEST( MathFunctions, Accuracy )
 	ASSERT_NEAR( Math::Clamp<Float64>( val1, val2, 1238.0 ), val1, tolerance );
 	ASSERT_NEAR( Math::Clamp<Float64>( val1, val2, 9.01 ), 9.01, tolerance );
 }
+
+TEST( MathFunctions, BitScan )
+{
+	ASSERT_EQ( Math::CountLeadingZeros32( 0 ), 32 );
+	ASSERT_EQ( Math::CountLeadingZeros32( 1 ), 31 );
+	ASSERT_EQ( Math::CountLeadingZeros32( 0x80000000 ), 0 );
+	ASSERT_EQ( Math::CountLeadingZeros32( 0x00F00000 ), 8 );
+	ASSERT_EQ( Math::CountTrailingZeros32( 0 ), 32 );
+	ASSERT_EQ( Math::CountTrailingZeros32( 1 ), 0 );
+	ASSERT_EQ( Math::CountTrailingZeros32( 0x80000000 ), 31 );
+	ASSERT_EQ( Math::CountTrailingZeros32( 0x00F00000 ), 20 );
+}
@@ -0,0 +1,198 @@
+/* This source file is part of the Chewable Framework.
+ * For the latest info, please visit http://chewable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/**
+ * @file test_MemBudget.cpp
+ * @brief Unit testing for memory budgets.
+ */
+
+// Precompiled Headers //
+#include "cbl/StdAfx.h"
+
+// Chewable Headers //
+#include <cbl/Chewable.h>
+#include <cbl/Core/Object.h>
+#include <cbl/Core/ObjectManager.h>
+#include <cbl/Memory/MemBudget.h>
+#include <cbl/Util/ByteStream.h>
+
+// Google Test //
+#include <gtest/gtest.h>
+
+using namespace cbl;
+
+class PressureListener
+{
+public:
+	PressureListener() : Soft( 0 ), Hard( 0 ), Cache( NULL ), CacheSize( 0 ) {}
+
+	void OnPressure( MemBudget& budget, MemPressure::Options pressure ) {
+		if( pressure == MemPressure::Soft ) {
+			++Soft;
+		}
+		else {
+			++Hard;
+			if( Cache ) {
+				budget.Deallocate( Cache, CacheSize, 1 );
+				Cache = NULL;
+			}
+		}
+	}
+
+	int		Soft;
+	int		Hard;
+	void*	Cache;
+	size_t	CacheSize;
+};
+
+class BudgetTestObject :
+	public Object
+{
+	CBL_OBJECT_FRIENDS;
+};
+
+CBL_TYPE( BudgetTestObject, BudgetTestObject );
+
+struct BudgetTestBase { Int32 Value; };
+struct BudgetTestDerived : BudgetTestBase { Int32 Extra; };
+
+CBL_TYPE( BudgetTestBase, BudgetTestBase );
+CBL_TYPE( BudgetTestDerived, BudgetTestDerived );
+
+TEST( MemBudgetFixture, MemBudget_LimitTest ) {
+	MemBudget budget( "Test" );
+	PressureListener listener;
+	budget.OnMemoryPressure += E::MemoryPressure::Method<CBL_E_METHOD(PressureListener,OnPressure)>( &listener );
+	budget.SetLimits( 1024, 2048 );
+
+	void* a = budget.Allocate( 512, 1 );
+	ASSERT_EQ( listener.Soft, 0 );
+	void* b = budget.Allocate( 600, 1 );
+	ASSERT_EQ( listener.Soft, 1 );
+	ASSERT_TRUE( budget.IsUnderPressure() );
+	void* c = budget.Allocate( 100, 1 );
+	ASSERT_EQ( listener.Soft, 1 );
+	ASSERT_EQ( budget.GetUsed(), 1212u );
+
+	// Over the hard limit: pressure is raised, then the request is refused.
+	ASSERT_EQ( budget.Allocate( 1000, 1 ), (void*)NULL );
+	ASSERT_EQ( listener.Hard, 1 );
+	ASSERT_EQ( budget.GetFailures(), 1u );
+	ASSERT_EQ( budget.GetUsed(), 1212u );
+
+	// Dropping below the soft limit re-arms the soft signal.
+	budget.Deallocate( b, 600, 1 );
+	ASSERT_FALSE( budget.IsUnderPressure() );
+	b = budget.Allocate( 600, 1 );
+	ASSERT_EQ( listener.Soft, 2 );
+	ASSERT_EQ( budget.GetPeak(), 1212u );
+
+	budget.Deallocate( a, 512, 1 );
+	budget.Deallocate( b, 600, 1 );
+	budget.Deallocate( c, 100, 1 );
+	ASSERT_EQ( budget.GetUsed(), 0u );
+	budget.ResetPeak();
+	ASSERT_EQ( budget.GetPeak(), 0u );
+}
+
+TEST( MemBudgetFixture, MemBudget_RecoveryTest ) {
+	MemBudget budget( "Test" );
+	PressureListener listener;
+	budget.OnMemoryPressure += E::MemoryPressure::Method<CBL_E_METHOD(PressureListener,OnPressure)>( &listener );
+	budget.SetLimits( 0, 1024 );
+
+	// A cache that the listener frees under hard pressure makes room for the request.
+	listener.CacheSize = 768;
+	listener.Cache = budget.Allocate( listener.CacheSize, 1 );
+	void* mem = budget.Allocate( 512, 1 );
+	ASSERT_NE( mem, (void*)NULL );
+	ASSERT_EQ( listener.Hard, 1 );
+	ASSERT_EQ( listener.Cache, (void*)NULL );
+	ASSERT_EQ( budget.GetFailures(), 0u );
+
+	// Containers get std::bad_alloc at the hard limit.
+	AllocVector<Uint8>::Type vec( budget );
+	ASSERT_THROW( vec.resize( 1024 ), std::bad_alloc );
+	budget.Deallocate( mem, 512, 1 );
+	ASSERT_EQ( budget.GetUsed(), 0u );
+}
+
+TEST( MemBudgetFixture, MemBudget_CategoryTest ) {
+	CBL_ENT.Types.Create<BudgetTestObject>()
+		.Base<cbl::Object>();
+	ObjectManager objects;
+
+	// Objects are charged to the objects budget through their base type.
+	MemBudget& objBudget = MemBudget::Get( MemCategory::Objects );
+	size_t used = objBudget.GetUsed();
+	ASSERT_NE( objects.Create<BudgetTestObject>( "Object1" ), (BudgetTestObject*)NULL );
+	ASSERT_EQ( objBudget.GetUsed(), used + sizeof(BudgetTestObject) );
+
+	objBudget.SetLimits( 0, objBudget.GetUsed() );
+	ASSERT_EQ( objects.Create<BudgetTestObject>( "Object2" ), (BudgetTestObject*)NULL );
+	ASSERT_EQ( objBudget.GetFailures(), 1u );
+	objBudget.SetLimits( 0, 0 );
+	objects.ForceFullPurge();
+	ASSERT_EQ( objBudget.GetUsed(), used );
+
+	// Byte streams drop writes past the serialisation budget.
+	MemBudget& serBudget = MemBudget::Get( MemCategory::Serialisation );
+	ByteStream stream;
+	serBudget.SetLimits( 0, serBudget.GetUsed() );
+	std::vector<Char> data( 8192, 'x' );
+	stream.Write( &data[0], 1024 );
+	ASSERT_FALSE( stream.HasFailed() );
+	stream.Write( &data[0], Uint32( data.size() ) );
+	ASSERT_TRUE( stream.HasFailed() );
+	ASSERT_EQ( stream.GetSize(), 1024u );
+	serBudget.SetLimits( 0, 0 );
+	stream.Write( &data[0], Uint32( data.size() ) );
+	ASSERT_EQ( stream.GetSize(), 1024u + 8192u );
+}
+
+TEST( MemBudgetFixture, MemBudget_InheritTest ) {
+	// The types outlive the test, and so must their allocators.
+	static MemBudget budget( "Inherit" );
+	static MemBudget own( "Own" );
+
+	// The derived type is registered before its base is given an allocator.
+	Type& derived = CBL_ENT.Types.Create<BudgetTestDerived>()
+		.Base<BudgetTestBase>();
+	ASSERT_TRUE( derived.GetAllocator() == NULL );
+	CBL_ENT.Types.Create<BudgetTestBase>()
+		.AllocateFrom( budget );
+	ASSERT_EQ( derived.GetAllocator(), &budget );
+
+	void* obj = derived.New();
+	ASSERT_NE( obj, (void*)NULL );
+	ASSERT_EQ( budget.GetUsed(), sizeof(BudgetTestDerived) );
+	derived.Delete( obj );
+	ASSERT_EQ( budget.GetUsed(), 0u );
+
+	// An allocator of its own takes precedence. It is set while no objects are alive,
+	// so each object is freed into the allocator it came from.
+	derived.AllocateFrom( own );
+	ASSERT_EQ( derived.GetAllocator(), &own );
+	obj = derived.New();
+	ASSERT_EQ( own.GetUsed(), sizeof(BudgetTestDerived) );
+	ASSERT_EQ( budget.GetUsed(), 0u );
+	derived.Delete( obj );
+	ASSERT_EQ( own.GetUsed(), 0u );
+	derived.AllocateFrom( budget );
+}
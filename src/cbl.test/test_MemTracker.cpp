@@ -0,0 +1,115 @@
+/* This source file is part of the Chewable Framework.
+ * For the latest info, please visit http://chewable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file test_MemTracker.cpp
+ * @brief Unit testing for allocation tracking.
+ */
+
+// Precompiled Headers //
+#include "cbl/StdAfx.h"
+
+// Chewable Headers //
+#include <cbl/Chewable.h>
+#include <cbl/Memory/MemTracker.h>
+#include <cbl/Reflection/EntityManager.h>
+
+// Google Test //
+#include <gtest/gtest.h>
+
+using namespace cbl;
+
+class MemTrackerFixture :
+	public ::testing::Test
+{
+protected:
+	virtual void SetUp( void ) {
+		MemTracker::Instance().Reset();
+	}
+
+	virtual void TearDown( void ) {
+		MemTracker::Instance().Reset();
+	}
+};
+
+TEST_F( MemTrackerFixture, MemTracker_TypeTest )
+{
+	MemTracker& tracker = MemTracker::Instance();
+	const Type* type = CBL_ENT.Types.Get<Uint32>();
+	ASSERT_TRUE( type != NULL );
+
+	Uint32 a, b;
+	{
+		MemTagScope tag( "Physics" );
+		ASSERT_EQ( *MemTracker::GetCurrentTag(), CName( "Physics" ) );
+		tracker.TrackAllocate( *type, &a );
+	}
+	ASSERT_TRUE( MemTracker::GetCurrentTag() == NULL );
+	tracker.TrackAllocate( *type, &b );
+	tracker.TrackFree( *type, &a );
+
+	MemTracker::Snapshot snapshot = tracker.TakeSnapshot();
+	const MemTracker::Stats& stats = snapshot.Types[ type->Name ];
+	ASSERT_EQ( stats.LiveCount, 1 );
+	ASSERT_EQ( stats.LiveBytes, Int64( sizeof(Uint32) ) );
+	ASSERT_EQ( stats.PeakCount, 2 );
+	ASSERT_EQ( stats.Allocations, 2 );
+	ASSERT_EQ( stats.Frees, 1 );
+
+	// The free is charged back to the tag the object was allocated under.
+	const MemTracker::Stats& physics = snapshot.Tags[ "Physics" ];
+	ASSERT_EQ( physics.LiveCount, 0 );
+	ASSERT_EQ( physics.PeakBytes, Int64( sizeof(Uint32) ) );
+}
+
+TEST_F( MemTrackerFixture, MemTracker_NestedTagTest )
+{
+	{
+		// Each tag declares its own scope object.
+		CBL_MEM_TAG( "Physics" );
+		CBL_MEM_TAG( "Collision" );
+#if CBL_MEMORY_TRACKING == CBL_ENABLED
+		ASSERT_EQ( *MemTracker::GetCurrentTag(), CName( "Collision" ) );
+#endif
+	}
+	ASSERT_TRUE( MemTracker::GetCurrentTag() == NULL );
+}
+
+TEST_F( MemTrackerFixture, MemTracker_DiffTest )
+{
+	MemTracker& tracker = MemTracker::Instance();
+	tracker.TrackAllocate( "Audio", 64 );
+	MemTracker::Snapshot before = tracker.TakeSnapshot();
+
+	tracker.TrackAllocate( "Audio", 32 );
+	tracker.TrackAllocate( "Render", 1024 );
+	tracker.TrackAllocate( "Render", 1024 );
+	tracker.TrackFree( "Render", 1024 );
+	MemTracker::Snapshot after = tracker.TakeSnapshot();
+	ASSERT_GE( after.Time, before.Time );
+
+	MemTracker::DeltaList deltas = MemTracker::Diff( before.Tags, after.Tags, 2.0 );
+	ASSERT_EQ( deltas.size(), 2 );
+	ASSERT_EQ( deltas[0].Name, CName( "Render" ) );
+	ASSERT_EQ( deltas[0].Bytes, 1024 );
+	ASSERT_EQ( deltas[0].Count, 1 );
+	ASSERT_DOUBLE_EQ( deltas[0].Rate, 1.0 );
+	ASSERT_EQ( deltas[1].Name, CName( "Audio" ) );
+	ASSERT_EQ( deltas[1].Bytes, 32 );
+	ASSERT_EQ( deltas[1].Allocations, 1 );
+}
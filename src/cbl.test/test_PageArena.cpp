@@ -0,0 +1,124 @@
+/* This source file is part of the Chewable Framework.
+ * For the latest info, please visit http://chewable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file test_PageArena.cpp
+ * @brief Unit testing for virtual memory page arena.
+ */
+
+// Precompiled Headers //
+#include "cbl/StdAfx.h"
+
+// Chewable Headers //
+#include <cbl/Chewable.h>
+#include <cbl/Memory/PageArena.h>
+#include <cbl/Util/Stopwatch.h>
+
+// External Dependencies //
+#include <random>
+
+// Google Test //
+#include <gtest/gtest.h>
+
+using namespace cbl;
+
+TEST( PageArenaFixture, PageArena_CommitTest )
+{
+	static const size_t commit = CBL_PAGE_ARENA_COMMIT;
+	PageArena arena( commit * 4 );
+	ASSERT_EQ( arena.GetReserved(), commit * 4 );
+	ASSERT_EQ( arena.GetCommitted(), 0 );
+
+	void* a = arena.Allocate( 1000, 16 );
+	ASSERT_TRUE( arena.Owns( a ) );
+	ASSERT_EQ( reinterpret_cast<size_t>( a ) % commit, 0 );
+	ASSERT_EQ( arena.GetCommitted(), commit );
+	ASSERT_EQ( arena.GetCommitCount(), 1 );
+
+	// Commits grow in whole commit sized steps.
+	void* b = arena.Allocate( commit + commit / 2, 64 );
+	ASSERT_TRUE( arena.Owns( b ) );
+	ASSERT_EQ( reinterpret_cast<size_t>( b ) % 64, 0 );
+	ASSERT_EQ( arena.GetCommitted(), commit * 2 );
+	ASSERT_EQ( arena.GetCommitCount(), 2 );
+	memset( b, 0xCD, commit + commit / 2 );
+
+	// Freed blocks are reused by allocations of the same size.
+	arena.Deallocate( a, 1000, 16 );
+	ASSERT_EQ( arena.Allocate( 1000, 16 ), a );
+	arena.Deallocate( a, 1000, 16 );
+	arena.Deallocate( b, commit + commit / 2, 64 );
+}
+
+TEST( PageArenaFixture, PageArena_FallbackTest )
+{
+	PageArena arena( CBL_PAGE_ARENA_COMMIT );
+	void* fits = arena.Allocate( CBL_PAGE_ARENA_COMMIT / 2, 16 );
+	void* spills = arena.Allocate( CBL_PAGE_ARENA_COMMIT, 16 );
+	ASSERT_TRUE( arena.Owns( fits ) );
+	ASSERT_FALSE( arena.Owns( spills ) );
+	ASSERT_EQ( arena.GetFallbackCount(), 1 );
+
+	memset( spills, 0, CBL_PAGE_ARENA_COMMIT );
+	arena.Deallocate( spills, CBL_PAGE_ARENA_COMMIT, 16 );
+	arena.Deallocate( fits, CBL_PAGE_ARENA_COMMIT / 2, 16 );
+}
+
+TEST( PageArenaFixture, DISABLED_PageArena_TlbBenchmark )
+{
+	struct Node { Node* Next; Uint64 Payload[7]; };
+	static const Uint32 amt = 1 << 18;
+	static const int Iterations = 4;
+
+	PageArena arena( amt * sizeof(Node) );
+	std::vector<Node*> arenaNodes( amt ), heapNodes( amt );
+	for( Uint32 i = 0; i < amt; ++i ) {
+		arenaNodes[i] = static_cast<Node*>( arena.Allocate( sizeof(Node), alignof(Node) ) );
+		heapNodes[i] = new Node;
+	}
+
+	// Link both sets in the same random order, so every hop lands somewhere else.
+	std::vector<Uint32> order( amt );
+	for( Uint32 i = 0; i < amt; ++i )
+		order[i] = i;
+	std::shuffle( order.begin(), order.end(), std::mt19937( 1234 ) );
+	for( Uint32 i = 0; i < amt; ++i ) {
+		arenaNodes[order[i]]->Next = arenaNodes[order[( i + 1 ) % amt]];
+		heapNodes[order[i]]->Next = heapNodes[order[( i + 1 ) % amt]];
+	}
+
+	Stopwatch sw;
+	Float64 times[2];
+	Node* starts[2] = { arenaNodes[0], heapNodes[0] };
+	for( int set = 0; set < 2; ++set ) {
+		Node* node = starts[set];
+		sw.Reset(); sw.Start();
+		for( Uint32 i = 0; i < amt * Iterations; ++i )
+			node = node->Next;
+		sw.Stop();
+		times[set] = sw.GetElapsedTime().TotalSeconds() * 1e9 / ( amt * Iterations );
+		ASSERT_TRUE( node == starts[set] );
+	}
+
+	printf( "%12s %12s %12s %12s\n", "arena(ns)", "heap(ns)", "commits", "hugepages" );
+	printf( "%12.2f %12.2f %12u %12s\n", times[0], times[1], arena.GetCommitCount(), arena.UsesHugePages() ? "yes" : "no" );
+	ASSERT_EQ( arena.GetFallbackCount(), 0 );
+
+	for( Uint32 i = 0; i < amt; ++i )
+		delete heapNodes[i];
+}
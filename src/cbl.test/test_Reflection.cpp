@@ -27,6 +27,11 @@
 // Chewable Headers //
 #include <cbl/Chewable.h>
 #include <cbl/Reflection/Typing.h>
+#include <cbl/Reflection/Patch.h>
+
+// External Dependencies //
+#include <atomic>
+#include <thread>
 
 // Google Test //
 #include <gtest/gtest.h>
@@ -120,6 +125,528 @@ TEST( ReflectionFixture, TypeBaseTest )
 	ForceReconstructEntityManager();
 }
 
+struct FieldBase
+{
+	Int32 a;
+	Int32 b;
+};
+
+struct FieldDerived :
+	public FieldBase
+{
+	Int32 c;
+};
+
+CBL_TYPE( FieldBase, FieldBase );
+CBL_TYPE( FieldDerived, FieldDerived );
+
+TEST( ReflectionFixture, FieldTableTest )
+{
+	CBL_ENT.Types.Create<FieldBase>()
+		.CBL_FIELD( a, FieldBase );
+	CBL_ENT.Types.Create<FieldDerived>()
+		.Base<FieldBase>()
+		.CBL_FIELD( c, FieldDerived );
+
+	const Type* derived = CBL_ENT.Types.Get<FieldDerived>();
+	const Type::FieldTable* fields = &derived->GetAllFields();
+	ASSERT_EQ( fields->size(), 2 );
+	ASSERT_STREQ( (*fields)[0]->Name.Text, "a" );
+	ASSERT_STREQ( (*fields)[1]->Name.Text, "c" );
+
+	// The table is reused until fields change.
+	const Field* first = (*fields)[0];
+	ASSERT_EQ( &derived->GetAllFields(), fields );
+	ASSERT_EQ( derived->GetAllFields()[0], first );
+
+	// Declaring a base type field rebuilds the derived table.
+	CBL_ENT.Types.Create<FieldBase>()
+		.CBL_FIELD( b, FieldBase );
+	fields = &derived->GetAllFields();
+	ASSERT_EQ( fields->size(), 3 );
+	ASSERT_STREQ( (*fields)[0]->Name.Text, "a" );
+	ASSERT_STREQ( (*fields)[1]->Name.Text, "b" );
+	ASSERT_STREQ( (*fields)[2]->Name.Text, "c" );
+	ASSERT_EQ( (*fields)[2], derived->GetField( CName( "c" ) ) );
+
+	ForceReconstructEntityManager();
+}
+
+TEST( ReflectionFixture, TypeIndexTest )
+{
+	Uint16 index = TypeIndex<FieldBase>();
+	ASSERT_NE( index, InvalidTypeIndex );
+	ASSERT_EQ( TypeIndex<FieldBase>(), index );
+	ASSERT_EQ( TypeIndex<FieldBase*>(), index );
+	ASSERT_NE( TypeIndex<FieldDerived>(), index );
+
+	const Type* type = CBL_ENT.Types.Get<FieldBase>();
+	ASSERT_EQ( type->Index, index );
+	ASSERT_EQ( CBL_ENT.Types.GetByIndex( index ), type );
+	ASSERT_EQ( CBL_ENT.Types.Get( TypeCName<FieldBase>() ), type );
+	ASSERT_EQ( CBL_ENT.Types.GetByIndex( InvalidTypeIndex ), (const Type*)NULL );
+
+	// Indices are stable across type databases.
+	ForceReconstructEntityManager();
+	ASSERT_EQ( CBL_ENT.Types.GetByIndex( index ), (const Type*)NULL );
+	type = &CBL_ENT.Types.Create<FieldBase>();
+	ASSERT_EQ( type->Index, index );
+	ASSERT_EQ( CBL_ENT.Types.GetByIndex( index ), type );
+
+	ForceReconstructEntityManager();
+}
+
+struct HierarchyRoot :
+	public Entity
+{
+	virtual Entity::OPTIONS OnPreChanged( void ) { return Entity::O_NORMAL; }
+	virtual void OnChanged( void ) {}
+	virtual Entity::OPTIONS OnPreSaved( void ) const { return Entity::O_NORMAL; }
+	virtual void OnSaved( void ) const {}
+};
+struct HierarchyA : public HierarchyRoot {};
+struct HierarchyB : public HierarchyRoot {};
+struct HierarchyAA : public HierarchyA {};
+
+CBL_TYPE( HierarchyRoot, HierarchyRoot );
+CBL_TYPE( HierarchyA, HierarchyA );
+CBL_TYPE( HierarchyB, HierarchyB );
+CBL_TYPE( HierarchyAA, HierarchyAA );
+
+TEST( ReflectionFixture, TypeHierarchyTest )
+{
+	TypeDB& db = CBL_ENT.Types;
+	db.Create<HierarchyRoot>();
+	db.Create<HierarchyA>().Base<HierarchyRoot>();
+	db.Create<HierarchyB>().Base<HierarchyRoot>();
+	db.Finalise();
+
+	const Type* root = db.Get<HierarchyRoot>();
+	const Type* a = db.Get<HierarchyA>();
+	const Type* b = db.Get<HierarchyB>();
+	ASSERT_TRUE( a->IsType( *root ) );
+	ASSERT_TRUE( a->IsType( *a ) );
+	ASSERT_FALSE( a->IsType( *b ) );
+	ASSERT_FALSE( root->IsType( *a ) );
+	ASSERT_TRUE( b->IsType<HierarchyRoot>() );
+	ASSERT_TRUE( b->IsType( CName( "HierarchyRoot" ) ) );
+	ASSERT_FALSE( b->IsType( CName( "HierarchyA" ) ) );
+
+	// Types declared after finalising are numbered on the next query.
+	db.Create<HierarchyAA>().Base<HierarchyA>();
+	const Type* aa = db.Get<HierarchyAA>();
+	ASSERT_TRUE( aa->IsType( *a ) );
+	ASSERT_TRUE( aa->IsType( *root ) );
+	ASSERT_FALSE( aa->IsType( *b ) );
+	ASSERT_FALSE( a->IsType( *aa ) );
+
+	// Checked casts.
+	HierarchyRoot* obj = CBL_ENT.New<HierarchyAA>();
+	Entity* ent = obj;
+	ASSERT_EQ( TypeCast<HierarchyA>( ent ), static_cast<HierarchyA*>( obj ) );
+	ASSERT_EQ( TypeCast<HierarchyAA>( ent ), static_cast<HierarchyAA*>( obj ) );
+	ASSERT_EQ( TypeCast<HierarchyB>( ent ), (HierarchyB*)NULL );
+	ASSERT_EQ( TypeCast<HierarchyRoot>( (const Entity*)ent ), (const HierarchyRoot*)obj );
+	ASSERT_EQ( TypeCast<HierarchyA>( (Entity*)NULL ), (HierarchyA*)NULL );
+	CBL_ENT.Delete( ent );
+
+	ForceReconstructEntityManager();
+}
+
+struct CloneLeaf
+{
+	Int32	A;
+	Int16	B;
+	Int16	C;
+	Float32	D;
+	Uint8	E;
+	Int32	F;
+};
+
+Uint32 sCloneNodesDeleted = 0;
+
+struct CloneNode :
+	public Entity
+{
+	String					Name;
+	CloneLeaf				Leaf;
+	std::vector<Int32>		Values;
+	std::vector<CloneLeaf>	Leaves;
+	CloneNode*				Child;
+	Uint32					Cache;
+
+	CloneNode() : Child( NULL ), Cache( 0 ) { ::memset( &Leaf, 0, sizeof( Leaf ) ); }
+	virtual ~CloneNode() { ++sCloneNodesDeleted; }
+	virtual Entity::OPTIONS OnPreChanged( void ) { return Entity::O_NORMAL; }
+	virtual void OnChanged( void ) {}
+	virtual Entity::OPTIONS OnPreSaved( void ) const { return Entity::O_NORMAL; }
+	virtual void OnSaved( void ) const {}
+};
+
+struct CloneOwner
+{
+	std::vector<CloneNode*>	Nodes;
+};
+
+CBL_TYPE( CloneLeaf, CloneLeaf );
+CBL_TYPE( CloneNode, CloneNode );
+CBL_TYPE( CloneOwner, CloneOwner );
+
+TEST( ReflectionFixture, CloneEqualsHashTest )
+{
+	CBL_ENT.Types.Create<CloneLeaf>()
+		.CBL_FIELD( A, CloneLeaf )
+		.CBL_FIELD( B, CloneLeaf )
+		.CBL_FIELD( C, CloneLeaf )
+		.CBL_FIELD( D, CloneLeaf )
+		.CBL_FIELD( E, CloneLeaf )
+		.CBL_FIELD( F, CloneLeaf );
+	const Type& type = CBL_ENT.Types.Create<CloneNode>()
+		.CBL_FIELD( Name, CloneNode )
+		.CBL_FIELD( Leaf, CloneNode )
+		.CBL_FIELD( Values, CloneNode )
+		.CBL_FIELD( Leaves, CloneNode )
+		.CBL_FIELD( Child, CloneNode )
+		.CBL_FIELD_ATTR( Cache, CloneNode, FieldAttr::F_TRANSIENT );
+
+	CloneLeaf leaf = { 1, 2, 3, 4.0f, 5, 6 };
+	CloneNode* src = CBL_ENT.New<CloneNode>();
+	src->Name = "root";
+	src->Leaf = leaf;
+	src->Values.push_back( 10 );
+	src->Values.push_back( 20 );
+	src->Leaves.push_back( leaf );
+	src->Cache = 42;
+	src->Child = CBL_ENT.New<CloneNode>();
+	src->Child->Name = "child";
+	src->Child->Values.push_back( 30 );
+
+	CloneNode* dst = CBL_ENT.New<CloneNode>();
+	dst->Values.push_back( 99 );
+	type.Clone( dst, src );
+	ASSERT_EQ( dst->Name, "root" );
+	ASSERT_EQ( dst->Leaf.C, 3 );
+	ASSERT_EQ( dst->Leaf.F, 6 );
+	ASSERT_EQ( dst->Values, src->Values );
+	ASSERT_EQ( dst->Leaves.size(), 1 );
+	ASSERT_EQ( dst->Leaves[0].D, 4.0f );
+	ASSERT_EQ( dst->Cache, 0 );
+	ASSERT_TRUE( dst->Child != NULL );
+	ASSERT_NE( dst->Child, src->Child );
+	ASSERT_EQ( dst->Child->Name, "child" );
+	ASSERT_EQ( dst->Child->Child, (CloneNode*)NULL );
+
+	ASSERT_TRUE( type.Equals( dst, src ) );
+	ASSERT_EQ( type.HashContents( dst ), type.HashContents( src ) );
+
+	// Transient fields don't count.
+	dst->Cache = 7;
+	ASSERT_TRUE( type.Equals( dst, src ) );
+
+	// Differences in plain data, nested containers and pointed to objects do.
+	dst->Leaf.E = 0;
+	ASSERT_FALSE( type.Equals( dst, src ) );
+	ASSERT_NE( type.HashContents( dst ), type.HashContents( src ) );
+	dst->Leaf.E = 5;
+	dst->Leaves[0].A = 0;
+	ASSERT_FALSE( type.Equals( dst, src ) );
+	dst->Leaves[0].A = 1;
+	dst->Child->Values[0] = 31;
+	ASSERT_FALSE( type.Equals( dst, src ) );
+	ASSERT_NE( type.HashContents( dst ), type.HashContents( src ) );
+
+	// Cloning again reuses the existing child.
+	CloneNode* child = dst->Child;
+	type.Clone( dst, src );
+	ASSERT_EQ( dst->Child, child );
+	ASSERT_TRUE( type.Equals( dst, src ) );
+
+	// Cloning a NULL pointer frees the object it replaces.
+	CloneNode* empty = CBL_ENT.New<CloneNode>();
+	Uint32 deleted = sCloneNodesDeleted;
+	type.Clone( dst, empty );
+	ASSERT_EQ( dst->Child, (CloneNode*)NULL );
+	ASSERT_EQ( deleted + 1, sCloneNodesDeleted );
+	ASSERT_FALSE( type.Equals( dst, src ) );
+	CBL_ENT.Delete( empty );
+	CBL_ENT.Delete( src->Child );
+	CBL_ENT.Delete( src );
+	CBL_ENT.Delete( dst );
+
+	// So does rebuilding a container of pointers.
+	const Type& ownerType = CBL_ENT.Types.Create<CloneOwner>()
+		.CBL_FIELD( Nodes, CloneOwner );
+	CloneOwner from, to;
+	from.Nodes.push_back( CBL_ENT.New<CloneNode>() );
+	ownerType.Clone( &to, &from );
+	ownerType.Clone( &to, &from );
+	ASSERT_EQ( to.Nodes.size(), 1 );
+	ASSERT_NE( to.Nodes[0], from.Nodes[0] );
+	deleted = sCloneNodesDeleted;
+	CBL_ENT.Delete( from.Nodes[0] );
+	from.Nodes.clear();
+	ownerType.Clone( &to, &from );
+	ASSERT_TRUE( to.Nodes.empty() );
+	ASSERT_EQ( deleted + 2, sCloneNodesDeleted );
+
+	ForceReconstructEntityManager();
+}
+
+struct PatchState
+{
+	Uint32					Tick;
+	String					Label;
+	std::map<String,Int32>	Scores;
+	std::set<Uint32>		Flags;
+	std::vector<CloneLeaf>	Items;
+	Float32					Weights[3];
+	CloneNode*				Owner;
+	Uint32					Cache;
+
+	PatchState() : Tick( 0 ), Owner( NULL ), Cache( 0 ) { Weights[0] = Weights[1] = Weights[2] = 0.0f; }
+};
+
+CBL_TYPE( PatchState, PatchState );
+
+TEST( ReflectionFixture, DiffApplyTest )
+{
+	TypeDB& db = CBL_ENT.Types;
+	db.Create<CloneLeaf>()
+		.CBL_FIELD( A, CloneLeaf )
+		.CBL_FIELD( B, CloneLeaf )
+		.CBL_FIELD( C, CloneLeaf )
+		.CBL_FIELD( D, CloneLeaf )
+		.CBL_FIELD( E, CloneLeaf )
+		.CBL_FIELD( F, CloneLeaf );
+	db.Create<CloneNode>()
+		.CBL_FIELD( Name, CloneNode )
+		.CBL_FIELD( Values, CloneNode );
+	const Type& type = db.Create<PatchState>()
+		.CBL_FIELD( Tick, PatchState )
+		.CBL_FIELD( Label, PatchState )
+		.CBL_FIELD( Scores, PatchState )
+		.CBL_FIELD( Flags, PatchState )
+		.CBL_FIELD( Items, PatchState )
+		.CBL_FIELD( Weights, PatchState )
+		.CBL_FIELD( Owner, PatchState )
+		.CBL_FIELD_ATTR( Cache, PatchState, FieldAttr::F_TRANSIENT );
+
+	PatchState a, b;
+	Patch patch;
+	ASSERT_TRUE( type.Diff( &a, &b, patch ) );
+	ASSERT_TRUE( patch.IsEmpty() );
+
+	CloneLeaf leaf = { 1, 2, 3, 4.0f, 5, 6 };
+	b.Tick = 10;
+	b.Label = "changed";
+	b.Scores["alice"] = 3;
+	b.Scores["bob"] = 4;
+	b.Flags.insert( 7 );
+	b.Items.push_back( leaf );
+	b.Items.push_back( leaf );
+	b.Weights[1] = 0.5f;
+	b.Owner = CBL_ENT.New<CloneNode>();
+	b.Owner->Name = "owner";
+	b.Owner->Values.push_back( 1 );
+	b.Cache = 99;
+
+	ASSERT_TRUE( type.Diff( &a, &b, patch ) );
+	ASSERT_FALSE( patch.IsEmpty() );
+	ASSERT_TRUE( type.Apply( &a, patch ) );
+	ASSERT_TRUE( type.Equals( &a, &b ) );
+	ASSERT_NE( a.Owner, b.Owner );
+	ASSERT_EQ( a.Cache, 0 );
+
+	// Small changes make small patches, and survive a trip through the wire format.
+	PatchState c;
+	type.Clone( &c, &b );
+	c.Tick = 11;
+	c.Scores["alice"] = 5;
+	c.Scores.erase( "bob" );
+	c.Scores["carol"] = 6;
+	c.Flags.erase( 7 );
+	c.Flags.insert( 8 );
+	c.Items.pop_back();
+	c.Items[0].C = 30;
+	c.Owner->Values.push_back( 2 );
+	ASSERT_TRUE( type.Diff( &b, &c, patch ) );
+	ASSERT_EQ( patch.GetCount(), 11 );
+
+	Patch received( patch.GetStream().GetBytes(), patch.GetStream().GetSize() );
+	ASSERT_TRUE( type.Apply( &a, received ) );
+	ASSERT_TRUE( type.Equals( &a, &c ) );
+	ASSERT_EQ( a.Scores.size(), 2 );
+	ASSERT_EQ( a.Scores["alice"], 5 );
+	ASSERT_EQ( a.Items.size(), 1 );
+	ASSERT_EQ( a.Items[0].C, 30 );
+	ASSERT_EQ( a.Owner->Values.size(), 2 );
+
+	// Clearing a pointer frees the object it pointed to.
+	Uint32 deleted = sCloneNodesDeleted;
+	PatchState d;
+	type.Clone( &d, &c );
+	CBL_ENT.Delete( d.Owner );
+	d.Owner = NULL;
+	ASSERT_TRUE( type.Diff( &c, &d, patch ) );
+	ASSERT_EQ( patch.GetCount(), 1 );
+	ASSERT_TRUE( type.Apply( &a, patch ) );
+	ASSERT_EQ( a.Owner, (CloneNode*)NULL );
+	ASSERT_EQ( deleted + 2, sCloneNodesDeleted );
+
+	// Patches that don't match the object fail.
+	Patch bad( "\x00\x01\xFF\xFF\xFF\xFF", 6 );
+	ASSERT_FALSE( type.Apply( &a, bad ) );
+
+	CBL_ENT.Delete( c.Owner );
+	CBL_ENT.Delete( b.Owner );
+
+	ForceReconstructEntityManager();
+}
+
+TEST( ReflectionFixture, ApplyDeletesTest )
+{
+	TypeDB& db = CBL_ENT.Types;
+	db.Create<CloneNode>()
+		.CBL_FIELD( Name, CloneNode )
+		.CBL_FIELD( Values, CloneNode );
+	const Type& type = db.Create<CloneOwner>()
+		.CBL_FIELD( Nodes, CloneOwner );
+
+	CloneOwner a, b, c;
+	for( Int32 i = 0; i < 3; ++i ) {
+		a.Nodes.push_back( CBL_ENT.New<CloneNode>() );
+		a.Nodes.back()->Values.push_back( i );
+	}
+	type.Clone( &b, &a );
+	type.Clone( &c, &a );
+	Patch patch;
+
+	// Erased pointer elements are freed.
+	Uint32 deleted = sCloneNodesDeleted;
+	CBL_ENT.Delete( b.Nodes[1] );
+	b.Nodes.erase( b.Nodes.begin() + 1 );
+	ASSERT_TRUE( type.Diff( &a, &b, patch ) );
+	ASSERT_TRUE( type.Apply( &c, patch ) );
+	ASSERT_TRUE( type.Equals( &c, &b ) );
+	ASSERT_EQ( deleted + 2, sCloneNodesDeleted );
+
+	// So are truncated ones.
+	type.Clone( &a, &b );
+	deleted = sCloneNodesDeleted;
+	CBL_ENT.Delete( b.Nodes[1] );
+	b.Nodes.pop_back();
+	ASSERT_TRUE( type.Diff( &a, &b, patch ) );
+	ASSERT_TRUE( type.Apply( &c, patch ) );
+	ASSERT_TRUE( type.Equals( &c, &b ) );
+	ASSERT_EQ( deleted + 2, sCloneNodesDeleted );
+
+	// And objects replaced by a new one.
+	CloneOwner empty, full;
+	empty.Nodes.push_back( NULL );
+	full.Nodes.push_back( CBL_ENT.New<CloneNode>() );
+	full.Nodes[0]->Name = "new";
+	deleted = sCloneNodesDeleted;
+	ASSERT_TRUE( type.Diff( &empty, &full, patch ) );
+	ASSERT_TRUE( type.Apply( &c, patch ) );
+	ASSERT_EQ( c.Nodes[0]->Name, "new" );
+	ASSERT_TRUE( type.Equals( &c, &full ) );
+	ASSERT_EQ( deleted + 1, sCloneNodesDeleted );
+
+	CloneOwner* owners[] = { &a, &b, &c, &full };
+	for( size_t i = 0; i < 4; ++i )
+		for( size_t j = 0; j < owners[i]->Nodes.size(); ++j )
+			CBL_ENT.Delete( owners[i]->Nodes[j] );
+
+	ForceReconstructEntityManager();
+}
+
+struct PatchKey
+{
+	Int32	X;
+	Int32	Y;
+
+	bool operator < ( const PatchKey& rhs ) const { return X < rhs.X || ( X == rhs.X && Y < rhs.Y ); }
+	bool operator == ( const PatchKey& rhs ) const { return X == rhs.X && Y == rhs.Y; }
+};
+
+struct PatchList
+{
+	std::vector<Int32>			Values;
+	std::vector<CloneLeaf>		Leaves;
+	std::map<PatchKey,Int32>	Keyed;
+};
+
+CBL_TYPE( PatchKey, PatchKey );
+CBL_TYPE( PatchList, PatchList );
+
+TEST( ReflectionFixture, DiffSequenceTest )
+{
+	TypeDB& db = CBL_ENT.Types;
+	db.Create<CloneLeaf>()
+		.CBL_FIELD( A, CloneLeaf )
+		.CBL_FIELD( B, CloneLeaf )
+		.CBL_FIELD( C, CloneLeaf )
+		.CBL_FIELD( D, CloneLeaf )
+		.CBL_FIELD( E, CloneLeaf )
+		.CBL_FIELD( F, CloneLeaf );
+	db.Create<PatchKey>()
+		.CBL_FIELD( X, PatchKey )
+		.CBL_FIELD( Y, PatchKey );
+	const Type& type = db.Create<PatchList>()
+		.CBL_FIELD( Values, PatchList )
+		.CBL_FIELD( Leaves, PatchList )
+		.CBL_FIELD( Keyed, PatchList );
+
+	PatchList a, b;
+	for( Int32 i = 1; i <= 8; ++i )
+		a.Values.push_back( i );
+	Patch patch;
+
+	// Inserting at the front doesn't rewrite the elements after it.
+	type.Clone( &b, &a );
+	b.Values.insert( b.Values.begin(), 0 );
+	ASSERT_TRUE( type.Diff( &a, &b, patch ) );
+	ASSERT_EQ( patch.GetCount(), 2 );
+	PatchList c;
+	type.Clone( &c, &a );
+	ASSERT_TRUE( type.Apply( &c, patch ) );
+	ASSERT_EQ( c.Values, b.Values );
+
+	// Neither does erasing from the middle.
+	type.Clone( &b, &a );
+	b.Values.erase( b.Values.begin() + 3 );
+	ASSERT_TRUE( type.Diff( &a, &b, patch ) );
+	ASSERT_EQ( patch.GetCount(), 1 );
+	type.Clone( &c, &a );
+	ASSERT_TRUE( type.Apply( &c, patch ) );
+	ASSERT_EQ( c.Values, b.Values );
+
+	// New elements in the middle are written out in full.
+	CloneLeaf leaf = { 1, 2, 3, 4.0f, 5, 6 };
+	a.Leaves.assign( 3, leaf );
+	type.Clone( &b, &a );
+	leaf.A = 9;
+	b.Leaves.insert( b.Leaves.begin() + 1, leaf );
+	ASSERT_TRUE( type.Diff( &a, &b, patch ) );
+	ASSERT_EQ( patch.GetCount(), 7 );
+	type.Clone( &c, &a );
+	ASSERT_TRUE( type.Apply( &c, patch ) );
+	ASSERT_TRUE( type.Equals( &c, &b ) );
+
+	// Out of range positions fail.
+	ASSERT_TRUE( type.Diff( &a, &b, patch ) );
+	type.Clone( &c, &a );
+	c.Leaves.clear();
+	ASSERT_FALSE( type.Apply( &c, patch ) );
+
+	// Keys with fields but no string form can't be encoded.
+	PatchKey key = { 1, 2 };
+	b.Keyed[key] = 3;
+	ASSERT_FALSE( type.Diff( &a, &b, patch ) );
+
+	ForceReconstructEntityManager();
+}
+
 TEST( ReflectionFixture, EntityInheritanceTest )
 {
 	const Type* entType = CBL_ENT.Types.Get<Object>();
@@ -256,6 +783,82 @@ TEST( ReflectionFixture, EnumTest )
 	ForceReconstructEntityManager();
 }
 
+namespace TestEnumTable
+{
+	enum Sparse { };
+	enum Access {
+		Read	= 0x01,
+		Write	= 0x02,
+		Exec	= 0x08,
+		All		= 0x0b,
+	};
+}
+
+CBL_TYPE( TestEnumTable::Sparse, TestEnumSparse );
+CBL_TYPE( TestEnumTable::Access, TestEnumAccess );
+
+TEST( ReflectionFixture, EnumTableTest )
+{
+	// Dense values go in a direct table, sparse ones are binary searched.
+	static const Char* names[] = { "Alpha", "Beta", "Gamma", "Delta", "Epsilon", "Zeta", "Eta", "Theta" };
+	Type& dense = CBL_ENT.Types.Create<TestEnum::Options>();
+	Type& sparse = CBL_ENT.Types.Create<TestEnumTable::Sparse>();
+	for( Uint32 i = 0; i < 8; ++i ) {
+		dense.Enum( names[i], 100 + i );
+		sparse.Enum( names[i], ( 7 - i ) * 7919 );
+	}
+	dense.Enum( "Again", 101 );
+	CBL_ENT.Types.Finalise();
+
+	for( Uint32 i = 0; i < 8; ++i ) {
+		ASSERT_STREQ( names[i], dense.GetEnum( 100 + i )->Name.Text );
+		ASSERT_STREQ( names[i], sparse.GetEnum( ( 7 - i ) * 7919 )->Name.Text );
+		ASSERT_EQ( ( 7 - i ) * 7919, sparse.GetEnum( CName( names[i] ) )->Value );
+	}
+	ASSERT_TRUE( dense.GetEnum( 99 ) == NULL );
+	ASSERT_TRUE( dense.GetEnum( 108 ) == NULL );
+	ASSERT_TRUE( sparse.GetEnum( 1 ) == NULL );
+	ASSERT_TRUE( sparse.GetEnum( CName( "Again" ) ) == NULL );
+	// The first declared of equal values wins.
+	ASSERT_STREQ( "Beta", dense.GetEnum( 101 )->Name.Text );
+	ASSERT_EQ( 101u, dense.GetEnum( CName( "Again" ) )->Value );
+
+	// Declaring more constants rebuilds the tables.
+	sparse.Enum( "Late", 3 );
+	ASSERT_STREQ( "Late", sparse.GetEnum( 3 )->Name.Text );
+
+	// Flags are written as their named bits.
+	const Type& access = CBL_ENT.Types.Create<TestEnumTable::Access>()
+		.CBL_ENUM( Read, TestEnumTable )
+		.CBL_ENUM( Write, TestEnumTable )
+		.CBL_ENUM( Exec, TestEnumTable )
+		.CBL_ENUM( All, TestEnumTable )
+		.EnumFlags();
+	ASSERT_STREQ( "Exec", access.GetEnumBit( 3 )->Name.Text );
+	ASSERT_TRUE( access.GetEnumBit( 2 ) == NULL );
+
+	Uint32 value = TestEnumTable::Read | TestEnumTable::Exec;
+	String str;
+	access.ToString( str, &access, &value, NULL );
+	ASSERT_EQ( "Read|Exec", str );
+	value = TestEnumTable::All;
+	access.ToString( str, &access, &value, NULL );
+	ASSERT_EQ( "All", str );
+	value = TestEnumTable::Write | 0x30;
+	access.ToString( str, &access, &value, NULL );
+	ASSERT_EQ( "Write|0x30", str );
+
+	value = 0;
+	access.FromString( "Write|0x30", &access, &value, NULL );
+	ASSERT_EQ( TestEnumTable::Write | 0x30u, value );
+	access.FromString( "Read | Exec", &access, &value, NULL );
+	ASSERT_EQ( Uint32( TestEnumTable::Read | TestEnumTable::Exec ), value );
+	access.FromString( "Read|Unknown", &access, &value, NULL );
+	ASSERT_EQ( Uint32( TestEnumTable::Read | TestEnumTable::Exec ), value );
+
+	ForceReconstructEntityManager();
+}
+
 const int ContainerSize = 15;
 
 struct ContainerTest
@@ -358,6 +961,16 @@ TEST_F( ReflectionFieldContainerTestFixture, VectorContainerTest )
 	ASSERT_TRUE(cont.Vector.back() != 0);
 	writeIter->AddEmpty();
 	ASSERT_TRUE(cont.Vector.back() == 0);
+
+	size_t size = cont.Vector.size();
+	ASSERT_TRUE(writeIter->InsertEmpty(1) != NULL);
+	ASSERT_EQ(cont.Vector.size(), size + 1);
+	ASSERT_EQ(cont.Vector[1], 0);
+	ASSERT_TRUE(writeIter->EraseAt(1));
+	ASSERT_EQ(cont.Vector.size(), size);
+	ASSERT_FALSE(writeIter->EraseAt(Uint32(size)));
+	ASSERT_TRUE(writeIter->Truncate(1));
+	ASSERT_EQ(cont.Vector.size(), 1);
 }
 
 TEST_F( ReflectionFieldContainerTestFixture, SetContainerTest )
@@ -445,6 +1058,12 @@ TEST_F( ReflectionFieldContainerTestFixture, MapContainerTest )
 	writeIter->AddEmpty(&key);
 	ASSERT_TRUE(cont.Map.find(0) != cont.Map.end());
 	ASSERT_EQ(cont.Map.find(0)->second, std::string());
+
+	ASSERT_TRUE(writeIter->Erase(&key));
+	ASSERT_TRUE(cont.Map.find(0) == cont.Map.end());
+	ASSERT_FALSE(writeIter->Erase(&key));
+	ASSERT_TRUE(writeIter->Truncate(1));
+	ASSERT_EQ(cont.Map.size(), 1);
 }
 
 TEST_F( ReflectionFieldContainerTestFixture, UMapContainerTest )
@@ -477,3 +1096,217 @@ TEST_F( ReflectionFieldContainerTestFixture, UMapContainerTest )
 	ASSERT_TRUE(cont.UMap.find(0) != cont.UMap.end());
 	ASSERT_EQ(cont.UMap.find(0)->second, std::string());
 }
+
+struct FrozenLate
+{
+	Int32				Value;
+	std::vector<Int64>	Values;
+};
+
+CBL_TYPE( FrozenLate, FrozenLate );
+
+TEST( ReflectionFixture, FreezeTest )
+{
+	CBL_ENT.Types.Create<Vector3f>();
+	ASSERT_FALSE( CBL_ENT.Types.IsFrozen() );
+	CBL_ENT.Types.Freeze();
+	ASSERT_TRUE( CBL_ENT.Types.IsFrozen() );
+
+	const Type* float32 = CBL_ENT.Types.Get<Float32>();
+	const Type* vector3f = CBL_ENT.Types.Get<Vector3f>();
+	std::atomic<int> errors( 0 );
+	std::atomic<const Type*> late( NULL );
+
+	// Readers look registered types up while one of them registers a new type.
+	std::vector<std::thread> threads;
+	for( Uint32 t = 0; t < 4; ++t ) {
+		threads.push_back( std::thread( [&, t]() {
+			for( Uint32 i = 0; i < 2000; ++i ) {
+				if( CBL_ENT.Types.Get<Float32>() != float32 ) ++errors;
+				if( CBL_ENT.Types.Get( CName( "Vector3f" ) ) != vector3f ) ++errors;
+				if( !CBL_ENT.Types.Get<Vector3f>()->IsType( *vector3f ) ) ++errors;
+				if( t == 0 && i == 1000 ) {
+					Type& type = CBL_ENT.Types.Create<FrozenLate>()
+						.CBL_FIELD( Value, FrozenLate )
+						.CBL_FIELD( Values, FrozenLate );
+					late.store( &type );
+				}
+			}
+		} ) );
+	}
+	for( size_t t = 0; t < threads.size(); ++t )
+		threads[t].join();
+
+	ASSERT_EQ( 0, errors.load() );
+	ASSERT_TRUE( late.load() != NULL );
+	ASSERT_EQ( late.load(), CBL_ENT.Types.Get<FrozenLate>() );
+	ASSERT_EQ( late.load(), CBL_ENT.Types.Get( CName( "FrozenLate" ) ) );
+	ASSERT_TRUE( CBL_ENT.Types.Get( CName( "Int64Vector" ) ) != NULL );
+	ASSERT_EQ( 2u, late.load()->GetAllFields().size() );
+
+	ForceReconstructEntityManager();
+	ASSERT_FALSE( CBL_ENT.Types.IsFrozen() );
+}
+
+struct FrozenDerived :
+	public CloneLeaf
+{
+	Int32	G;
+};
+
+CBL_TYPE( FrozenDerived, FrozenDerived );
+
+TEST( ReflectionFixture, FreezeCloneTest )
+{
+	const Type& leafType = CBL_ENT.Types.Create<CloneLeaf>()
+		.CBL_FIELD( A, CloneLeaf )
+		.CBL_FIELD( B, CloneLeaf )
+		.CBL_FIELD( C, CloneLeaf )
+		.CBL_FIELD( D, CloneLeaf )
+		.CBL_FIELD( E, CloneLeaf )
+		.CBL_FIELD( F, CloneLeaf );
+	CBL_ENT.Types.Freeze();
+
+	const Type::FieldTable* fields = &leafType.GetAllFields();
+	const CloneLeaf leaf = { 1, 2, 3, 4.0f, 5, 6 };
+	std::atomic<int> errors( 0 );
+	std::atomic<const Type*> late( NULL );
+
+	// Readers walk and clone with the field caches while a derived type is registered.
+	std::vector<std::thread> threads;
+	for( Uint32 t = 0; t < 4; ++t ) {
+		threads.push_back( std::thread( [&, t]() {
+			for( Uint32 i = 0; i < 2000; ++i ) {
+				const Type::FieldTable& all = leafType.GetAllFields();
+				if( all.size() != 6 || !( all[5]->Name == CName( "F" ) ) ) ++errors;
+				CloneLeaf copy = {};
+				leafType.Clone( &copy, &leaf );
+				if( !leafType.Equals( &copy, &leaf ) || copy.F != 6 ) ++errors;
+
+				if( const Type* derived = late.load() ) {
+					if( derived->GetAllFields().size() != 7 ) ++errors;
+					if( !derived->IsType( leafType ) || leafType.IsType( *derived ) ) ++errors;
+					FrozenDerived a, b;
+					static_cast< CloneLeaf& >( a ) = leaf;
+					a.G = Int32( i );
+					derived->Clone( &b, &a );
+					if( b.G != a.G || b.D != leaf.D ) ++errors;
+				}
+				if( t == 0 && i == 1000 ) {
+					Type& type = CBL_ENT.Types.Create<FrozenDerived>()
+						.CBL_FIELD( G, FrozenDerived )
+						.Base<CloneLeaf>();
+					late.store( &type );
+				}
+			}
+		} ) );
+	}
+	for( size_t t = 0; t < threads.size(); ++t )
+		threads[t].join();
+
+	ASSERT_EQ( 0, errors.load() );
+	ASSERT_TRUE( late.load() != NULL );
+	ASSERT_TRUE( late.load()->IsType<CloneLeaf>() );
+	// Unchanged tables are kept, so references handed out earlier stay current.
+	ASSERT_EQ( fields, &leafType.GetAllFields() );
+
+	ForceReconstructEntityManager();
+}
+
+struct ModuleType
+{
+	Int32				Value;
+	std::vector<Int32>	Values;
+};
+
+CBL_TYPE( ModuleType, ModuleType );
+
+namespace
+{
+	Uint32 sModuleRuns = 0;
+
+	void RegisterTestModule( TypeDB& types )
+	{
+		++sModuleRuns;
+		types.Create<ModuleType>()
+			.ReserveFields( 2 )
+			.CBL_FIELD( Value, ModuleType )
+			.CBL_FIELD( Values, ModuleType );
+	}
+}
+
+TEST( ReflectionFixture, ModuleTest )
+{
+	ForceReconstructEntityManager();
+	sModuleRuns = 0;
+
+	TypeDB::RegistrationStats before = CBL_ENT.Types.GetRegistrationStats();
+	ASSERT_TRUE( before.Types > 0 );
+	ASSERT_TRUE( before.StorageBytes > 0 );
+
+	// Nothing runs until a type the module might describe is asked for.
+	CBL_ENT.Types.AddModule( &RegisterTestModule );
+	CBL_ENT.Types.AddModule( &RegisterTestModule );
+	ASSERT_EQ( 0u, sModuleRuns );
+	ASSERT_TRUE( CBL_ENT.Types.Get<Vector3f>() != NULL );
+	ASSERT_EQ( 0u, sModuleRuns );
+
+	const Type* type = CBL_ENT.Types.Get( CName( "ModuleType" ) );
+	ASSERT_EQ( 1u, sModuleRuns );
+	ASSERT_TRUE( type != NULL );
+	ASSERT_EQ( type, CBL_ENT.Types.Get<ModuleType>() );
+	ASSERT_EQ( 2u, type->GetFields().size() );
+	ASSERT_TRUE( type->GetField( CName( "Values" ) )->Container != NULL );
+
+	// Registered modules are not run again.
+	CBL_ENT.Types.AddModule( &RegisterTestModule );
+	CBL_ENT.Types.RegisterModules();
+	CBL_ENT.Types.Freeze();
+	ASSERT_EQ( 1u, sModuleRuns );
+	ASSERT_EQ( 2u, CBL_ENT.Types.Get<ModuleType>()->GetFields().size() );
+
+	TypeDB::RegistrationStats after = CBL_ENT.Types.GetRegistrationStats();
+	ASSERT_EQ( before.Modules + 1, after.Modules );
+	ASSERT_TRUE( after.Types > before.Types );
+	ASSERT_TRUE( after.Fields >= before.Fields + 2 );
+	ASSERT_TRUE( after.StorageBytes > before.StorageBytes );
+	ASSERT_TRUE( after.RegisterTime >= before.RegisterTime );
+
+	ForceReconstructEntityManager();
+}
+
+namespace
+{
+	void RegisterFrozenModule( TypeDB& types )
+	{
+		types.Create<ModuleType>()
+			.CBL_FIELD( Value, ModuleType )
+			.CBL_FIELD( Values, ModuleType );
+		types.Create<CloneLeaf>()
+			.CBL_FIELD( A, CloneLeaf )
+			.CBL_FIELD( F, CloneLeaf );
+		types.Create<FrozenDerived>()
+			.CBL_FIELD( G, FrozenDerived )
+			.Base<CloneLeaf>();
+	}
+}
+
+TEST( ReflectionFixture, FrozenModuleTest )
+{
+	ForceReconstructEntityManager();
+	CBL_ENT.Types.Freeze();
+	TypeDB::RegistrationStats before = CBL_ENT.Types.GetRegistrationStats();
+
+	// Types registered late by a module are published together.
+	CBL_ENT.Types.AddModule( &RegisterFrozenModule );
+	const Type* derived = CBL_ENT.Types.Get( CName( "FrozenDerived" ) );
+	ASSERT_TRUE( derived != NULL );
+	ASSERT_TRUE( derived->IsType<CloneLeaf>() );
+	ASSERT_EQ( derived, CBL_ENT.Types.Get<FrozenDerived>() );
+	ASSERT_TRUE( CBL_ENT.Types.Get( CName( "ModuleType" ) ) != NULL );
+
+	TypeDB::RegistrationStats after = CBL_ENT.Types.GetRegistrationStats();
+	ASSERT_EQ( before.Tables + 1, after.Tables );
+
+	ForceReconstructEntityManager();
+}
@@ -47,14 +47,22 @@ public:
 	int testInteger;
 };
 
+class OtherService
+{
+public:
+	int value;
+};
+
 class ServicesFixture : public ::testing::Test
 {
 protected:
 	TestService		testService;
+	OtherService	otherService;
 	cbl::Services	_services;
 };
 	
 CBL_TYPE( TestService, TestService );
+CBL_TYPE( OtherService, OtherService );
 
 TEST_F( ServicesFixture, Services_Test )
 {
@@ -69,3 +77,33 @@ TEST_F( ServicesFixture, Services_Test )
 	service = _services.Get< TestService >();
 	ASSERT_TRUE( service == NULL );
 }
+
+TEST_F( ServicesFixture, Services_SlotTest )
+{
+	ASSERT_NE( Services::SlotIndex< TestService >(), Services::SlotIndex< OtherService >() );
+	ASSERT_EQ( Services::SlotIndex< TestService >(), Services::GetSlotIndex( TypeCName< TestService >() ) );
+
+	_services.Add< TestService >( &testService );
+	ASSERT_TRUE( _services.Get< OtherService >() == NULL );
+	_services.Add< OtherService >( &otherService );
+	ASSERT_EQ( _services.Get< TestService >(), &testService );
+	ASSERT_EQ( _services.Get< OtherService >(), &otherService );
+}
+
+TEST_F( ServicesFixture, Services_RefTest )
+{
+	ServiceRef< TestService > ref = _services.GetRef< TestService >();
+	ASSERT_TRUE( ref.IsBound() );
+	ASSERT_TRUE( ref.Get() == NULL );
+
+	_services.Add< TestService >( &testService );
+	ASSERT_EQ( ref.Get(), &testService );
+	ASSERT_EQ( ref->GetInteger(), testService.testInteger );
+
+	_services.Remove< TestService >();
+	ASSERT_TRUE( ref.Get() == NULL );
+
+	ServiceRef< TestService > unbound;
+	ASSERT_FALSE( unbound.IsBound() );
+	ASSERT_TRUE( unbound.Get() == NULL );
+}
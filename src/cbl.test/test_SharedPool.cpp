@@ -0,0 +1,134 @@
+/* This source file is part of the Chewable Framework.
+ * For the latest info, please visit http://chewable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file test_SharedPool.cpp
+ * @brief Unit testing for thread-safe pooled allocator.
+ */
+
+// Precompiled Headers //
+#include "cbl/StdAfx.h"
+
+// Chewable Headers //
+#include <cbl/Chewable.h>
+#include <cbl/Memory/SharedPool.h>
+
+// External Dependencies //
+#include <atomic>
+#include <thread>
+
+// Google Test //
+#include <gtest/gtest.h>
+
+using namespace cbl;
+
+struct SharedPoolTest {
+	cbl::Uint64 value;
+	std::atomic<int>* destroyed;
+
+	SharedPoolTest( cbl::Uint64 v, std::atomic<int>* counter ) : value( v ), destroyed( counter ) {}
+	~SharedPoolTest() { ++*destroyed; }
+};
+
+typedef SharedPool<SharedPoolTest,64,16> TestPool;
+
+TEST( SharedPoolFixture, SharedPool_MagazineTest ) {
+	std::atomic<int> destroyed( 0 );
+	TestPool pool( 0 );
+	std::vector<SharedPoolTest*> arr;
+
+	for( Uint64 i = 0; i < 100; ++i )
+		arr.push_back( pool.Allocate( i, &destroyed ) );
+	for( Uint64 i = 0; i < 100; ++i )
+		ASSERT_EQ( arr[i]->value, i );
+	ASSERT_EQ( pool.GetMagazineCount(), 1 );
+
+	for( size_t i = 0; i < arr.size(); ++i )
+		pool.Deallocate( arr[i] );
+	ASSERT_EQ( destroyed, 100 );
+
+	// The magazine still holds some slots until it's flushed.
+	ASSERT_GT( pool.GetPageCount(), 0 );
+	pool.Flush();
+	ASSERT_EQ( pool.GetPageCount(), 0 );
+}
+
+TEST( SharedPoolFixture, SharedPool_ThreadTest ) {
+	static const Uint32 threadCount = 4;
+	static const Uint32 amt = 2000;
+	std::atomic<int> destroyed( 0 );
+	std::atomic<int> errors( 0 );
+	TestPool pool( 0 );
+
+	std::vector<std::thread> threads;
+	for( Uint32 t = 0; t < threadCount; ++t ) {
+		threads.push_back( std::thread( [&pool, &destroyed, &errors, t]() {
+			std::vector<SharedPoolTest*> arr;
+			for( Uint32 round = 0; round < 4; ++round ) {
+				for( Uint64 i = 0; i < amt; ++i )
+					arr.push_back( pool.Allocate( t * amt + i, &destroyed ) );
+				for( Uint64 i = 0; i < amt; ++i ) {
+					if( arr[i]->value != t * amt + i ) ++errors;
+					pool.Deallocate( arr[i] );
+				}
+				arr.clear();
+			}
+		} ) );
+	}
+	for( size_t i = 0; i < threads.size(); ++i )
+		threads[i].join();
+
+	ASSERT_EQ( errors, 0 );
+	ASSERT_EQ( destroyed, int( threadCount * amt * 4 ) );
+
+	// Exited threads leave orphaned magazines behind until a slow path or Trim returns them.
+	ASSERT_LE( pool.GetMagazineCount(), threadCount );
+	pool.Trim();
+	ASSERT_EQ( pool.GetMagazineCount(), 0 );
+	ASSERT_EQ( pool.GetPageCount(), 0 );
+}
+
+TEST( SharedPoolFixture, SharedPool_RemoteFreeTest ) {
+	static const Uint32 amt = 500;
+	std::atomic<int> destroyed( 0 );
+	TestPool pool( 0 );
+
+	std::vector<SharedPoolTest*> arr;
+	for( Uint64 i = 0; i < amt; ++i )
+		arr.push_back( pool.Allocate( i, &destroyed ) );
+
+	// Free everything from a thread that never allocated from the pool.
+	std::thread remote( [&pool, &arr]() {
+		for( size_t i = 0; i < arr.size(); ++i )
+			pool.Deallocate( arr[i] );
+	} );
+	remote.join();
+	ASSERT_EQ( destroyed, int( amt ) );
+	ASSERT_EQ( pool.GetMagazineCount(), 1 );
+
+	// Remote frees are reused by the next refill, and the surplus returns to the pages.
+	pool.Flush();
+	Uint32 pages = pool.GetPageCount();
+	SharedPoolTest* obj = pool.Allocate( 1u, &destroyed );
+	ASSERT_LE( pool.GetPageCount(), pages );
+	pool.Deallocate( obj );
+
+	pool.Flush();
+	pool.Trim();
+	ASSERT_EQ( pool.GetPageCount(), 0 );
+}
@@ -0,0 +1,145 @@
+/* This source file is part of the Chewable Framework.
+ * For the latest info, please visit http://chewable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file test_StaticSerialiser.cpp
+ * @brief Unit testing for compile-time reflection and static serialisation.
+ */
+
+// Precompiled Headers //
+#include "cbl/StdAfx.h"
+
+// Chewable Headers //
+#include <cbl/Chewable.h>
+#include <cbl/Reflection/Typing.h>
+#include <cbl/Reflection/EntityManager.h>
+#include <cbl/Serialisation/StaticSerialiser.h>
+
+// Google Test //
+#include <gtest/gtest.h>
+
+using namespace cbl;
+
+struct StaticPoint {
+	Float32	X;
+	Float32	Y;
+	Int32	Id;
+};
+
+class StaticShape {
+public:
+	String						Name;
+	StaticPoint					Origin;
+	std::vector<Float32>		Weights;
+	std::vector<StaticPoint>	Points;
+	Uint32						Cache;
+	Uint32 GetFlags( void ) const { return mFlags; }
+	void SetFlags( Uint32 flags ) { mFlags = flags; }
+private:
+	CBL_REFLECTABLE;
+	Uint32						mFlags;
+};
+
+CBL_TYPE( StaticPoint, StaticPoint );
+CBL_TYPE( StaticShape, StaticShape );
+
+CBL_REFLECT( StaticPoint,
+	CBL_RFIELD( X, StaticPoint ),
+	CBL_RFIELD( Y, StaticPoint ),
+	CBL_RFIELD( Id, StaticPoint ) );
+
+CBL_REFLECT( StaticShape,
+	CBL_RFIELD( Name, StaticShape ),
+	CBL_RFIELD( Origin, StaticShape ),
+	CBL_RFIELD( Weights, StaticShape ),
+	CBL_RFIELD( Points, StaticShape ),
+	CBL_RFIELD_ATTR( Cache, StaticShape, FieldAttr( "Debug", FieldAttr::F_TRANSIENT ) ),
+	CBL_RFIELDM( Flags, StaticShape ) );
+
+static StaticPoint MakePoint( Float32 x, Float32 y, Int32 id ) {
+	StaticPoint p = { x, y, id };
+	return p;
+}
+
+TEST( StaticSerialiserTest, RoundTrip )
+{
+	StaticShape src;
+	src.Name = "triangle";
+	src.Origin = MakePoint( 1.0f, 2.0f, 3 );
+	src.Weights.push_back( 0.25f );
+	src.Weights.push_back( 0.75f );
+	src.Points.push_back( MakePoint( 0.0f, 0.0f, 10 ) );
+	src.Points.push_back( MakePoint( 1.0f, 0.0f, 11 ) );
+	src.Points.push_back( MakePoint( 0.0f, 1.0f, 12 ) );
+	src.Cache = 99;
+	src.SetFlags( 0xF00D );
+
+	ByteStream stream;
+	ASSERT_TRUE( StaticSerialise( stream, src ) );
+
+	StaticShape dst;
+	dst.Cache = 7;
+	ASSERT_TRUE( StaticDeserialise( stream, dst ) );
+	EXPECT_EQ( stream.GetSize(), 0 );
+	EXPECT_EQ( dst.Name, src.Name );
+	EXPECT_EQ( dst.Origin.X, 1.0f );
+	EXPECT_EQ( dst.Origin.Y, 2.0f );
+	EXPECT_EQ( dst.Origin.Id, 3 );
+	EXPECT_EQ( dst.Weights, src.Weights );
+	ASSERT_EQ( dst.Points.size(), 3 );
+	EXPECT_EQ( dst.Points[2].Y, 1.0f );
+	EXPECT_EQ( dst.Points[2].Id, 12 );
+	EXPECT_EQ( dst.GetFlags(), 0xF00D );
+	// Transient fields are skipped.
+	EXPECT_EQ( dst.Cache, 7 );
+}
+
+TEST( StaticSerialiserTest, TruncatedStream )
+{
+	StaticShape src;
+	src.Name = "square";
+	src.Origin = MakePoint( 4.0f, 5.0f, 6 );
+	src.Points.resize( 4, MakePoint( 1.0f, 1.0f, 1 ) );
+	src.SetFlags( 1 );
+
+	ByteStream full;
+	ASSERT_TRUE( StaticSerialise( full, src ) );
+
+	ByteStream truncated( full.GetBytes(), Int32( full.GetSize() - 2 ) );
+	StaticShape dst;
+	EXPECT_FALSE( StaticDeserialise( truncated, dst ) );
+}
+
+TEST( StaticSerialiserTest, RuntimeFields )
+{
+	Type& type = CBL_ENT.Types.Create<StaticShape>();
+	const Type::FieldTable& fields = type.GetAllFields();
+	ASSERT_EQ( fields.size(), 6 );
+	EXPECT_EQ( fields[0]->Name, CName( "Name" ) );
+	EXPECT_EQ( fields[1]->Name, CName( "Origin" ) );
+	EXPECT_EQ( fields[5]->Name, CName( "Flags" ) );
+	EXPECT_EQ( fields[4]->Attributes.Transient, 1 );
+	EXPECT_STREQ( fields[4]->Attributes.Group, "Debug" );
+
+	const Type* pointType = CBL_ENT.Types.Get<StaticPoint>();
+	ASSERT_TRUE( pointType != NULL );
+	EXPECT_EQ( pointType->GetAllFields().size(), 3 );
+
+	// Creating the type again must not declare the fields twice.
+	EXPECT_EQ( CBL_ENT.Types.Create<StaticShape>().GetAllFields().size(), 6 );
+}
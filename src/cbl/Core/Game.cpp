@@ -32,6 +32,7 @@
 #include "cbl/Core/IDrawable.h"
 #include "cbl/Core/IUpdatable.h"
 #include "cbl/Core/GameStateManager.h"
+#include "cbl/Memory/FrameArena.h"
 #include "cbl/Debug/Logging.h"
 #include "cbl/Debug/FileLogger.h"
 #include "cbl/Debug/Profiling.h"
@@ -44,7 +45,7 @@ using namespace cbl;
 const Int64	Game::sDropFrameLimit	= 10;
 Game*		Game::sInstance			= NULL;
 
-Game::Game( const Char * name )
+Game::Game( const Char * name, Allocator& allocator )
 : Active( true )
 , IsFixedTimeStep( true )
 , DropFrames( true )
@@ -53,6 +54,8 @@ Game::Game( const Char * name )
 , TargetElapsedTime( TimeSpan::TicksPerSecond/60 )
 , TargetElapsedDrawTime( TimeSpan::TicksPerSecond/60 )
 , InactiveSleepTime( 20 )
+, Objects( allocator )
+, States( allocator )
 , mName( name )
 , mShutdown( false )
 {
@@ -65,11 +68,6 @@ Game::Game( const Char * name )
 		new FileLogger( ( mName + "_Log.log" ).c_str(), mName.c_str() ) );
 #endif
 	LOG( "Creating game." );
-
-	Components.OnComponentAdded		+= E::Component::Method<Game, &Game::OnComponentAdded>(this);
-	Components.OnDrawableAdded		+= E::DrawComponent::Method<Game, &Game::OnDrawableAdded>(this);
-	Components.OnComponentRemoved	+= E::Component::Method<Game, &Game::OnComponentRemoved>(this);
-	Components.OnDrawableRemoved	+= E::DrawComponent::Method<Game, &Game::OnDrawableRemoved>(this);
 }
 
 //!  Destructor.
@@ -78,11 +76,6 @@ Game::~Game()
 	// Ensure only 1 instance of game.
 	CBL_ASSERT_TRUE( sInstance == this );
 	sInstance = NULL;
-	
-	Components.OnDrawableRemoved	-= E::DrawComponent::Method<Game, &Game::OnDrawableRemoved>(this);
-	Components.OnComponentRemoved	-= E::Component::Method<Game, &Game::OnComponentRemoved>(this);
-	Components.OnDrawableAdded		-= E::DrawComponent::Method<Game, &Game::OnDrawableAdded>(this);
-	Components.OnComponentAdded		-= E::Component::Method<Game, &Game::OnComponentAdded>(this);
 
 	LOG( "Destroying game." );
 	
@@ -152,18 +145,52 @@ bool SortUpdates( IUpdatable * lhs, IUpdatable * rhs ) {
 void Game::Update( const GameTime & time )
 {
 	CBL_PROFILE_FUNCTION;
-	mUpdatableRuns.clear();
+	Components.Sort();
+	// Partitions of paused or inactive states are skipped as a whole.
+	States.GetRunningStates( mStateRuns );
 
+	// The run list is scratch memory, released when Tick resets the frame arena.
+	// Sized up front, as a growing vector would leave its old buffers in the arena.
 	size_t size = mUpdatables.size();
+	size_t count = size;
+	for( size_t s = 0; s < mStateRuns.size(); ++s )
+		count += mStateRuns[s]->GetUpdatables().size();
+	UpdatableRunList runs;
+	runs.reserve( count );
+
 	for( cbl::Uint32 i = 0; i < size; ++i ) {
 		if( mUpdatables[i]->Enabled )
-			mUpdatableRuns.push_back( mUpdatables[i] );
+			runs.push_back( mUpdatables[i] );
 	}
 
-	size = mUpdatableRuns.size();
-	std::sort( mUpdatableRuns.begin(), mUpdatableRuns.end(), SortUpdates );
-	for( cbl::Uint32 i = 0; i < size; ++i ) {
-		mUpdatableRuns[i]->Update( time );
+	for( size_t s = 0; s < mStateRuns.size(); ++s ) {
+		const GameState::UpdatableList& updatables = mStateRuns[s]->GetUpdatables();
+		for( size_t i = 0; i < updatables.size(); ++i ) {
+			if( updatables[i]->Enabled )
+				runs.push_back( updatables[i] );
+		}
+	}
+	std::sort( runs.begin(), runs.end(), SortUpdates );
+
+	// Merge the sorted component slots with the sorted extra updatables.
+	// Components added during the update wait until the next frame; removed ones leave an empty slot.
+	const Uint32 slots = Components.GetSlotCount();
+	size = runs.size();
+	Uint32 i = 0;
+	size_t j = 0;
+	while( i < slots || j < size ) {
+		GameComponent * component = i < slots ? Components.GetSlot( i ) : NULL;
+		if( i < slots && !component ) {
+			++i;
+		}
+		else if( j < size && ( !component || runs[j]->UpdateOrder < component->UpdateOrder ) ) {
+			runs[j++]->Update( time );
+		}
+		else {
+			++i;
+			if( component->Enabled )
+				component->Update( time );
+		}
 	}
 }
 
@@ -203,18 +230,48 @@ bool SortDraws( IDrawable * lhs, IDrawable * rhs ) {
 void Game::Draw( const GameTime & time )
 {
 	CBL_PROFILE_FUNCTION;
-	mDrawableRuns.clear();
+	Components.Sort();
+	States.GetRunningStates( mStateRuns );
 
 	size_t size = mDrawables.size();
+	size_t count = size;
+	for( size_t s = 0; s < mStateRuns.size(); ++s )
+		count += mStateRuns[s]->GetDrawables().size();
+	DrawableRunList runs;
+	runs.reserve( count );
+
 	for( cbl::Uint32 i = 0; i < size; ++i ) {
 		if( mDrawables[i]->Visible )
-			mDrawableRuns.push_back( mDrawables[i] );
+			runs.push_back( mDrawables[i] );
 	}
 
-	size = mDrawableRuns.size();
-	std::sort( mDrawableRuns.begin(), mDrawableRuns.end(), SortDraws );
-	for( cbl::Uint32 i = 0; i < size; ++i ) {
-		mDrawableRuns[i]->Draw( time );
+	for( size_t s = 0; s < mStateRuns.size(); ++s ) {
+		const GameState::DrawableList& drawables = mStateRuns[s]->GetDrawables();
+		for( size_t i = 0; i < drawables.size(); ++i ) {
+			if( drawables[i]->Visible )
+				runs.push_back( drawables[i] );
+		}
+	}
+	std::sort( runs.begin(), runs.end(), SortDraws );
+
+	// Merge the sorted drawable component slots with the sorted extra drawables.
+	const Uint32 slots = Components.GetDrawSlotCount();
+	size = runs.size();
+	Uint32 i = 0;
+	size_t j = 0;
+	while( i < slots || j < size ) {
+		DrawableGameComponent * component = i < slots ? Components.GetDrawSlot( i ) : NULL;
+		if( i < slots && !component ) {
+			++i;
+		}
+		else if( j < size && ( !component || runs[j]->DrawOrder < component->DrawOrder ) ) {
+			runs[j++]->Draw( time );
+		}
+		else {
+			++i;
+			if( component->Visible )
+				component->Draw( time );
+		}
 	}
 }
 
@@ -222,28 +279,6 @@ void Game::EndDraw( void )
 {
 }
 
-void Game::OnComponentAdded( GameComponent * updatable )
-{
-	CBL_ASSERT_TRUE( updatable );
-	mUpdatables.insert( updatable );
-}
-
-void Game::OnComponentRemoved( GameComponent * updatable )
-{
-	mUpdatables.erase( updatable );
-}
-
-void Game::OnDrawableAdded( DrawableGameComponent * drawable )
-{
-	CBL_ASSERT_TRUE( drawable );
-	mDrawables.insert( drawable );
-}
-
-void Game::OnDrawableRemoved( DrawableGameComponent * drawable )
-{
-	mDrawables.erase( drawable );
-}
-
 void Game::Tick( void )
 {
 	TimeSpan elapsed 	= mStopwatch.GetLapTime();
@@ -280,6 +315,7 @@ void Game::Tick( void )
 				States.Update();
 				Update( mGameTime );
 				Objects.Purge();
+				FrameArena::Get().Reset();
 			}
 			mGameTime.ElapsedReal = mAccumTime;
 		}
@@ -291,6 +327,7 @@ void Game::Tick( void )
 			States.Update();
 			Update( mGameTime );
 			Objects.Purge();
+			FrameArena::Get().Reset();
 
 			mGameTime.Elapsed = 0;
 			mGameTime.ElapsedReal = 0;
@@ -306,6 +343,7 @@ void Game::Tick( void )
 			mDrawTime.ElapsedReal = mDrawAccumTime;
 			Draw( mGameTime );
 			EndDraw();
+			FrameArena::Get().Reset();
 			mDrawTime.Elapsed = 0;
 			mDrawTime.ElapsedReal = 0;
 			mDrawAccumTime = 0;
@@ -26,12 +26,15 @@
 
 // Chewable Headers //
 #include "cbl/Core/GameComponent.h"
+#include "cbl/Core/GameComponentCollection.h"
 #include "cbl/Debug/Assert.h"
 
 using namespace cbl;
 
 GameComponent::GameComponent( cbl::Game & game )
 : Game( game )
+, mSlot( GameComponentCollection::InvalidSlot )
+, mDrawSlot( GameComponentCollection::InvalidSlot )
 {
 }
 
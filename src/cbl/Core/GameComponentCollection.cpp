@@ -32,7 +32,38 @@
 
 using namespace cbl;
 
+const Uint32 GameComponentCollection::InvalidSlot;
+
+namespace
+{
+	bool SortUpdates( const GameComponent * lhs, const GameComponent * rhs ) {
+		return lhs->UpdateOrder < rhs->UpdateOrder;
+	}
+
+	bool SortDraws( const DrawableGameComponent * lhs, const DrawableGameComponent * rhs ) {
+		return lhs->DrawOrder < rhs->DrawOrder;
+	}
+
+	//! Drop cleared slots and restore ordering. Returns true if any slot moved.
+	template< typename List, typename Pred >
+	bool CompactAndSort( List & list, Uint32 & removed, Pred pred ) {
+		bool moved = false;
+		if( removed > 0 ) {
+			list.erase( std::remove( list.begin(), list.end(), typename List::value_type( NULL ) ), list.end() );
+			removed = 0;
+			moved = true;
+		}
+		if( !std::is_sorted( list.begin(), list.end(), pred ) ) {
+			std::stable_sort( list.begin(), list.end(), pred );
+			moved = true;
+		}
+		return moved;
+	}
+}
+
 GameComponentCollection::GameComponentCollection()
+: mRemoved( 0 )
+, mDrawRemoved( 0 )
 {
 }
 
@@ -43,6 +74,8 @@ GameComponentCollection::~GameComponentCollection()
 void GameComponentCollection::Add( GameComponent * const component, bool init )
 {
 	CBL_ASSERT_TRUE( component );
+	CBL_ASSERT( component->mSlot == InvalidSlot, "Component already belongs to a collection." );
+	component->mSlot = Uint32( mComponentList.size() );
 	mComponentList.push_back( component );
 	
 	// Raise component added event.
@@ -55,7 +88,11 @@ void GameComponentCollection::Add( GameComponent * const component, bool init )
 void GameComponentCollection::Add( DrawableGameComponent * const component, bool init )
 {
 	CBL_ASSERT_TRUE( component );
+	CBL_ASSERT( component->mSlot == InvalidSlot, "Component already belongs to a collection." );
+	component->mSlot = Uint32( mComponentList.size() );
 	mComponentList.push_back( component );
+	component->mDrawSlot = Uint32( mDrawableList.size() );
+	mDrawableList.push_back( component );
 	
 	// Raise component added event.
 	OnComponentAdded( component );
@@ -72,7 +109,14 @@ void GameComponentCollection::Remove( GameComponent * const component, bool shut
 		component->Shutdown();
 
 	CBL_ASSERT_TRUE( component );
-	mComponentList.remove( component );
+
+	// Only drawable components are given a draw slot.
+	if( component->mDrawSlot != InvalidSlot ) {
+		Remove( static_cast< DrawableGameComponent * >( component ) );
+		return;
+	}
+
+	ClearSlot( component );
 
 	// Raise component removed event.
 	OnComponentRemoved( component );
@@ -84,7 +128,8 @@ void GameComponentCollection::Remove( DrawableGameComponent * const component, b
 		component->Shutdown();
 
 	CBL_ASSERT_TRUE( component );
-	mComponentList.remove( component );
+	ClearSlot( component );
+	ClearDrawSlot( component );
 
 	// Raise component removed event.
 	OnComponentRemoved( component );
@@ -92,8 +137,53 @@ void GameComponentCollection::Remove( DrawableGameComponent * const component, b
 	OnDrawableRemoved( component );
 }
 
+void GameComponentCollection::Sort( void )
+{
+	if( CompactAndSort( mComponentList, mRemoved, &SortUpdates ) ) {
+		for( Uint32 i = 0; i < mComponentList.size(); ++i )
+			mComponentList[i]->mSlot = i;
+	}
+
+	if( CompactAndSort( mDrawableList, mDrawRemoved, &SortDraws ) ) {
+		for( Uint32 i = 0; i < mDrawableList.size(); ++i )
+			mDrawableList[i]->mDrawSlot = i;
+	}
+}
+
 //! @brief Clear the component collection of all components.
 void GameComponentCollection::clear( void )
 {
+	CBL_FOREACH( ComponentList, it, mComponentList ) {
+		if( *it ) {
+			( *it )->mSlot = InvalidSlot;
+			( *it )->mDrawSlot = InvalidSlot;
+		}
+	}
+
 	mComponentList.clear();
+	mDrawableList.clear();
+	mRemoved = 0;
+	mDrawRemoved = 0;
+}
+
+void GameComponentCollection::ClearSlot( GameComponent * const component )
+{
+	const Uint32 slot = component->mSlot;
+	CBL_ASSERT( slot < mComponentList.size() && mComponentList[ slot ] == component,
+		"Component does not belong to this collection." );
+
+	mComponentList[ slot ] = NULL;
+	component->mSlot = InvalidSlot;
+	++mRemoved;
+}
+
+void GameComponentCollection::ClearDrawSlot( DrawableGameComponent * const component )
+{
+	const Uint32 slot = component->mDrawSlot;
+	CBL_ASSERT( slot < mDrawableList.size() && mDrawableList[ slot ] == component,
+		"Component does not belong to this collection." );
+
+	mDrawableList[ slot ] = NULL;
+	component->mDrawSlot = InvalidSlot;
+	++mDrawRemoved;
 }
@@ -26,17 +26,27 @@
 
 // Chewable Headers //
 #include "cbl/Core/GameState.h"
+#include "cbl/Core/Object.h"
+#include "cbl/Core/ObjectManager.h"
 
 using namespace cbl;
 
 GameState::GameState()
 : mActive( false )
 , mPaused( true )
+, mLoadProgress( 0 )
 {
 }
 
 GameState::~GameState()
 {
+	// Objects outlive their state; they just stop being owned.
+	for( size_t i = 0; i < mObjects.size(); ++i ) {
+		Object* object = mObjects[i];
+		object->mOwner = NULL;
+		if( object->mObjectManager )
+			object->mObjectManager->_Reown( object, this );
+	}
 }
 
 Entity::OPTIONS GameState::OnPreChanged( void )
@@ -56,3 +66,59 @@ Entity::OPTIONS GameState::OnPreSaved( void ) const
 void GameState::OnSaved( void ) const
 {
 }
+
+Real GameState::GetLoadProgress( void ) const
+{
+	return mLoadProgress.load( std::memory_order_acquire );
+}
+
+void GameState::SetLoadProgress( Real progress )
+{
+	mLoadProgress.store( progress, std::memory_order_release );
+}
+
+void GameState::AddUpdatable( IUpdatable* updatable )
+{
+	mUpdatables.insert( updatable );
+}
+
+void GameState::RemoveUpdatable( IUpdatable* updatable )
+{
+	mUpdatables.erase( updatable );
+}
+
+void GameState::AddDrawable( IDrawable* drawable )
+{
+	mDrawables.insert( drawable );
+}
+
+void GameState::RemoveDrawable( IDrawable* drawable )
+{
+	mDrawables.erase( drawable );
+}
+
+void GameState::AddObject( Object* object )
+{
+	CBL_ASSERT_TRUE( object );
+	GameState* oldOwner = object->mOwner;
+	if( oldOwner == this )
+		return;
+	if( oldOwner )
+		oldOwner->mObjects.erase( object );
+
+	object->mOwner = this;
+	mObjects.insert( object );
+	if( object->mObjectManager )
+		object->mObjectManager->_Reown( object, oldOwner );
+}
+
+void GameState::RemoveObject( Object* object )
+{
+	if( object->mOwner != this )
+		return;
+
+	object->mOwner = NULL;
+	mObjects.erase( object );
+	if( object->mObjectManager )
+		object->mObjectManager->_Reown( object, this );
+}
@@ -31,7 +31,12 @@
 
 using namespace cbl;
 
-GameStateManager::GameStateManager()
+GameStateManager::GameStateManager( Allocator& allocator )
+: mStateActions( allocator )
+, mStateStack( allocator )
+, mToDelete( allocator )
+, mStates( 0, StateMap::hasher(), StateMap::key_equal(), allocator )
+, mPreloads( 0, PreloadMap::hasher(), PreloadMap::key_equal(), allocator )
 {
 }
 
@@ -43,9 +48,13 @@ GameStateManager::~GameStateManager()
 
 void GameStateManager::Push( const CName& type )
 {
-	if( EntityPtr newEnt = (EntityPtr)CBL_ENT.New( type ) ) {
-		GameState* state = static_cast<GameState*>( newEnt );
+	GameState* state = TakePreload( type );
+	if( !state ) {
+		if( EntityPtr newEnt = (EntityPtr)CBL_ENT.New( type ) )
+			state = static_cast<GameState*>( newEnt );
+	}
 
+	if( state ) {
 		// Pause the current state on the top of the stack.
 		if( !mStateStack.empty() )
 			mStateActions.push_back( StateAction( mStateStack.back(), PauseState ) );
@@ -78,6 +87,52 @@ void GameStateManager::Pop( void )
 	mToDelete.push_back( state );
 }
 
+void GameStateManager::PreloadState( const CName& type )
+{
+	if( mPreloads.find( type ) != mPreloads.end() ) {
+		LOG_ERROR( "State (" << type << ") is already preloading." );
+		return;
+	}
+
+	// Entity creation isn't thread safe, so only Preload runs on the worker.
+	if( EntityPtr newEnt = (EntityPtr)CBL_ENT.New( type ) ) {
+		Preload* preload = new Preload;
+		preload->State = static_cast<GameState*>( newEnt );
+		preload->Done.store( false );
+		preload->State->SetLoadProgress( 0 );
+		preload->Worker = std::thread( &GameStateManager::PreloadMain, preload->State, &preload->Done );
+		mPreloads.insert( std::make_pair( type, preload ) );
+	}
+}
+
+bool GameStateManager::IsPreloaded( const CName& type ) const
+{
+	PreloadMap::const_iterator findit = mPreloads.find( type );
+	return findit != mPreloads.end() && findit->second->Done.load( std::memory_order_acquire );
+}
+
+Real GameStateManager::GetPreloadProgress( const CName& type ) const
+{
+	PreloadMap::const_iterator findit = mPreloads.find( type );
+	return findit != mPreloads.end() ? findit->second->State->GetLoadProgress() : 0;
+}
+
+GameState* GameStateManager::TakePreload( const CName& type )
+{
+	PreloadMap::iterator findit = mPreloads.find( type );
+	if( findit == mPreloads.end() )
+		return NULL;
+
+	Preload* preload = findit->second;
+	mPreloads.erase( findit );
+
+	// Blocks if the state hasn't finished loading yet.
+	preload->Worker.join();
+	GameState* state = preload->State;
+	delete preload;
+	return state;
+}
+
 void GameStateManager::Add( const CName& type, const Hash& name )
 {
 	if( mStates.find( name ) != mStates.end() ) {
@@ -127,10 +182,28 @@ void GameStateManager::Clear( void )
 		mToDelete.push_back( it->second );
 	}
 
+	// Preloaded states were never activated, so they only need deleting.
+	while( !mPreloads.empty() )
+		mToDelete.push_back( TakePreload( mPreloads.begin()->first ) );
+
 	mStateStack.clear();
 	mStates.clear();
 }
 
+void GameStateManager::GetRunningStates( std::vector<GameState*>& states ) const
+{
+	states.clear();
+	for( size_t i = 0; i < mStateStack.size(); ++i ) {
+		if( mStateStack[i]->IsRunning() )
+			states.push_back( mStateStack[i] );
+	}
+
+	CBL_FOREACH_CONST( StateMap, it, mStates ) {
+		if( it->second->IsRunning() )
+			states.push_back( it->second );
+	}
+}
+
 void GameStateManager::Update( void )
 {
 	for( size_t i = 0; i < mStateActions.size(); ++i )
@@ -177,3 +250,10 @@ void GameStateManager::PauseState( GameState* state )
 		state->Pause();
 	}
 }
+
+void GameStateManager::PreloadMain( GameState* state, std::atomic< bool >* done )
+{
+	state->Preload();
+	state->SetLoadProgress( 1 );
+	done->store( true, std::memory_order_release );
+}
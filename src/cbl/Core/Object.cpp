@@ -26,6 +26,7 @@
 
 // Chewable Headers //
 #include "cbl/Core/Object.h"
+#include "cbl/Core/GameState.h"
 #include "cbl/Debug/Assert.h"
 
 using namespace cbl;
@@ -35,15 +36,22 @@ Object::Object()
 , mInitialised( false )
 , mID(UINT_MAX)
 , mObjectManager( NULL )
+, mOwner( NULL )
 {
 	Parts.mParent = this;
 }
 
 Object::~Object() 
 {
+	if( mOwner ) mOwner->RemoveObject( this );
 	Parts.clear();
 }
 
+bool Object::IsDormant( void ) const
+{
+	return mOwner && !mOwner->IsRunning();
+}
+
 void Object::Initialise( void )
 {
 }
@@ -32,8 +32,9 @@
 
 using namespace cbl;
 
-ObjectGroups::ObjectGroups()
+ObjectGroups::ObjectGroups( Allocator& allocator )
 : mObjectMgr( NULL )
+, mGroups( 0, GroupTable::hasher(), GroupTable::key_equal(), allocator )
 {
 }
 
@@ -53,10 +54,7 @@ void ObjectGroups::Add( const Hash& groupName, Object* obj )
 	// Make sure the objects are the same and that the object exists in the mgr.
 	ObjectID id = obj->GetID();
 	if( mObjectMgr->Get( id ) == obj ) {
-		GroupTable::iterator result = mGroups.find( groupName );
-		if( result == mGroups.end() )
-			result = mGroups.insert( std::make_pair( groupName, ObjectIDList() ) ).first;
-
+		GroupTable::iterator result = _GetGroup( groupName );
 		for( size_t i = 0; i < result->second.size(); ++i ) {
 			if( result->second[i] == id ) {
 				LOG_WARNING( "Object " << obj->GetName() << " is already in group: " << groupName.GetText() );
@@ -106,7 +104,7 @@ void ObjectGroups::Remove( const Hash& groupName, ObjectID id )
 
 const ObjectIDList& ObjectGroups::Get( const Hash& groupName ) const
 {
-	return mGroups[ groupName ];
+	return _GetGroup( groupName )->second;
 }
 
 void ObjectGroups::Ungroup( const CName& objName )
@@ -122,7 +120,7 @@ void ObjectGroups::Ungroup( Object* obj )
 	// Make sure the object exists.
 	if( mObjectMgr->Get( id ) == obj ) {
 		CBL_FOREACH( Object::GroupNames, it, obj->mGroups ) {
-			ObjectIDList& idlist = mGroups[*it];
+			ObjectIDList& idlist = _GetGroup( *it )->second;
 			for( size_t i = 0; i < idlist.size(); ++i ) {
 				if( idlist[i] == id ) {
 					idlist[i] = idlist[idlist.size()-1];
@@ -167,3 +165,13 @@ void ObjectGroups::Clear( const Hash& groupName )
 	}
 	idlist.clear();
 }
+
+ObjectGroups::GroupTable::iterator ObjectGroups::_GetGroup( const Hash& groupName ) const
+{
+	GroupTable::iterator findit = mGroups.find( groupName );
+	if( findit == mGroups.end() ) {
+		// Group lists share the table's allocator.
+		findit = mGroups.insert( GroupTable::value_type( groupName, ObjectIDList( mGroups.get_allocator() ) ) ).first;
+	}
+	return findit;
+}
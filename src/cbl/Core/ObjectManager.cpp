@@ -26,6 +26,7 @@
 
 // Chewable Headers //
 #include "cbl/Core/ObjectManager.h"
+#include "cbl/Core/GameState.h"
 #include "cbl/Util/FileSystem.h"
 #include "cbl/Reflection/EntityManager.h"
 #include "cbl/Debug/Assert.h"
@@ -38,8 +39,14 @@ using namespace cbl;
 
 const Char* ObjectManager::sDefaultObjectName = "NewObject";
 
-ObjectManager::ObjectManager()
-: mDestroyAll( false )
+ObjectManager::ObjectManager( Allocator& allocator )
+: Groups( allocator )
+, mDestroyAll( false )
+, mObjectList( allocator )
+, mObjectNameTable( 0, ObjectNameTable::hasher(), ObjectNameTable::key_equal(), allocator )
+, mUnusedIDs( allocator )
+, mObjectsToDestroy( allocator )
+, mPartitions( 0, PartitionTable::hasher(), PartitionTable::key_equal(), allocator )
 {
 	Groups.mObjectMgr = this;
 }
@@ -53,7 +60,7 @@ ObjectPtr ObjectManager::Create( const CName& type, const CName& name, bool init
 {
 	EntityPtr newEnt = (EntityPtr)CBL_ENT.New( type );
 	if( !newEnt ) {
-		LOG_ERROR( "Cannot create object (" << name << "): Invalid type (" << type << ")." );
+		LOG_ERROR( "Cannot create object (" << name << "): Invalid type (" << type << ") or object budget exhausted." );
 		return NULL;
 	}
 
@@ -148,6 +155,7 @@ void ObjectManager::Purge( void )
 				// Delete the object.
 				del->Parts.clear();
 				del->Shutdown();
+				_Detach( del );
 				CBL_ENT.Delete( (EntityPtr)del );
 				// Put the ID in the unused list.
 				mUnusedIDs.push_back( id );
@@ -167,6 +175,7 @@ void ObjectManager::ForceFullPurge( void )
 			OnObjectDestroy( mObjectList[i] );
 			mObjectList[i]->Parts.clear();
 			mObjectList[i]->Shutdown();
+			_Detach( mObjectList[i] );
 			CBL_ENT.Delete( (EntityPtr)mObjectList[i] );
 			mObjectList[i] = NULL;
 		}
@@ -176,6 +185,8 @@ void ObjectManager::ForceFullPurge( void )
 	mUnusedIDs.clear();
 	mObjectsToDestroy.clear();
 	mObjectNameTable.clear();
+	mUnowned.clear();
+	mPartitions.clear();
 	mDestroyAll = false;
 }
 
@@ -226,12 +237,64 @@ bool ObjectManager::Add( ObjectPtr obj )
 	AssignAvailableObjectName( obj->mName );
 
 	obj->mObjectManager = this;
+	if( obj->mOwner )
+		++mPartitions[obj->mOwner];
+	else
+		mUnowned.insert( obj );
 	mObjectNameTable.insert( std::make_pair( CName( obj->mName ), obj->GetID() ) );
 	OnObjectCreate( obj );
 
 	return true;
 }
 
+void ObjectManager::GetLiveObjects( std::vector<ObjectPtr>& objects ) const
+{
+	objects.assign( mUnowned.begin(), mUnowned.end() );
+
+	CBL_FOREACH_CONST( PartitionTable, it, mPartitions ) {
+		if( !it->first->IsRunning() )
+			continue;
+
+		// A state may own objects of other managers too.
+		const GameState::ObjectList& owned = it->first->GetObjects();
+		for( size_t i = 0; i < owned.size(); ++i ) {
+			if( owned[i]->mObjectManager == this )
+				objects.push_back( owned[i] );
+		}
+	}
+}
+
+void ObjectManager::_Reown( ObjectPtr obj, GameState* oldOwner )
+{
+	if( oldOwner ) {
+		PartitionTable::iterator findit = mPartitions.find( oldOwner );
+		if( findit != mPartitions.end() && --findit->second == 0 )
+			mPartitions.erase( findit );
+	}
+	else {
+		mUnowned.erase( obj );
+	}
+
+	if( obj->mOwner )
+		++mPartitions[obj->mOwner];
+	else
+		mUnowned.insert( obj );
+}
+
+void ObjectManager::_Detach( ObjectPtr obj )
+{
+	if( obj->mOwner ) {
+		PartitionTable::iterator findit = mPartitions.find( obj->mOwner );
+		if( findit != mPartitions.end() && --findit->second == 0 )
+			mPartitions.erase( findit );
+	}
+	else {
+		mUnowned.erase( obj );
+	}
+	// The owner still releases the object when it is deleted, without telling us.
+	obj->mObjectManager = NULL;
+}
+
 void ObjectManager::PreRename( ObjectPtr obj )
 {
 	mObjectNameTable.erase( CName( obj->mName ) );
@@ -50,7 +50,7 @@ ObjectPart* ObjectPartTable::Add( const CName& type, bool init )
 
 	if( !part ) part = static_cast< ObjectPart* >( CBL_ENT.New( type ) );
 	if( !part ) {
-		LOG_ERROR( "Unable to create object part: " << type.Text << ". Type not registered." );
+		LOG_ERROR( "Unable to create object part: " << type.Text << ". Type not registered or part budget exhausted." );
 		return NULL;
 	}
 
@@ -0,0 +1,77 @@
+/* This source file is part of the Chewable Framework.
+ * For the latest info, please visit http://chewable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file Services.cpp
+ * @brief Game services.
+ */
+
+// Precompiled Headers //
+#include "cbl/StdAfx.h"
+
+// Chewable Headers //
+#include "cbl/Core/Services.h"
+
+// External Libraries //
+#include <mutex>
+
+using namespace cbl;
+
+namespace
+{
+	typedef std::unordered_map< CName, Uint32 > SlotTable;
+
+	//! Slot table, created on first use so static initialisation order doesn't matter.
+	SlotTable& GetSlotTable( void )
+	{
+		static SlotTable sTable;
+		return sTable;
+	}
+
+	std::mutex& GetSlotLock( void )
+	{
+		static std::mutex sLock;
+		return sLock;
+	}
+}
+
+Uint32 Services::GetSlotIndex( const CName& type )
+{
+	std::lock_guard< std::mutex > lock( GetSlotLock() );
+	SlotTable& table = GetSlotTable();
+
+	SlotTable::const_iterator findIt = table.find( type );
+	if( findIt != table.end() )
+		return findIt->second;
+
+	Uint32 index = Uint32( table.size() );
+	// Checked in every build: the slot index is used unchecked on every lookup.
+	if( index >= CBL_SERVICE_SLOTS ) {
+		CBL_FAIL( "Too many service types; increase CBL_SERVICE_SLOTS." );
+		::fprintf( stderr, "cbl::Services: more than %d service types; increase CBL_SERVICE_SLOTS.\n", CBL_SERVICE_SLOTS );
+		::abort();
+	}
+	table.insert( std::make_pair( type, index ) );
+	return index;
+}
+
+Services::Services()
+{
+	for( Uint32 i = 0; i < CBL_SERVICE_SLOTS; ++i )
+		mSlots[i].store( NULL, std::memory_order_relaxed );
+}
@@ -37,6 +37,7 @@ using namespace cbl;
 LogManager::LogManager()
 : Threshold( LogLevel::All )
 , mWriteThreshold( LogLevel::Info )
+, mDropped( 0 )
 {
 }
 
@@ -103,11 +104,23 @@ LogManager & LogManager::operator << ( LogLevel::Options logLevel )
 
 void LogManager::OutputMessage( const Char * file, Uint32 line )
 {
-	Write( mBuffer.str().c_str(), mWriteThreshold, file, line );
+	// A message that ran out of logging budget is dropped rather than failing the caller.
+	if( mBuffer.fail() ) {
+		++mDropped;
+	}
+	else {
+		try {
+			Write( mBuffer.str().c_str(), mWriteThreshold, file, line );
+		}
+		catch( const std::bad_alloc& ) {
+			++mDropped;
+		}
+	}
 	
 	// Reset the buffer and threshold.
 	{
 		mBuffer.str("");
+		mBuffer.clear();
 		mWriteThreshold = LogLevel::Info;
 	}
 }
@@ -32,6 +32,7 @@
 #include "cbl/Debug/ProfileManager.h"
 #include "cbl/Debug/Assert.h"
 #include "cbl/Debug/Logging.h"
+#include "cbl/Memory/Allocator.h"
 
 #include <unordered_map>
 #include <intsafe.h>
@@ -40,9 +41,9 @@ using namespace cbl;
 
 namespace cbl {
 struct Profile {
-	typedef std::unordered_map<Hash,Profile> Children;
+	typedef AllocUnorderedMap<Hash,Profile>::Type Children;
 
-	Profile();
+	explicit Profile( Allocator& allocator );
 
 	cbl::Hash	ID;
 	Profile*	Parent;
@@ -56,8 +57,9 @@ struct Profile {
 };
 }
 
-inline Profile::Profile()
+inline Profile::Profile( Allocator& allocator )
 : Parent(NULL)
+, ChildList( 0, Children::hasher(), Children::key_equal(), allocator )
 , StartTime(0)
 , TotalTime(0)
 , MinTime(INT64_MAX)
@@ -70,7 +72,8 @@ inline Profile::Profile()
 ProfileManager::ProfileManager()
 : mStackCount(0)
 , mLongestLine(30)
-, mRoot( new Profile() )
+, mAllocator( &Allocator::GetDefault() )
+, mRoot( new Profile( Allocator::GetDefault() ) )
 {
 	mCurrent = mRoot;
 }
@@ -94,7 +97,12 @@ void ProfileManager::Enter( const Char* id )
 		return;
 	}
 
-	Profile * profile	= &mCurrent->ChildList[id];
+	Profile::Children & c = mCurrent->ChildList;
+	Profile::Children::iterator findit = c.find( id );
+	if( findit == c.end() )
+		findit = c.insert( Profile::Children::value_type( id, Profile( *mAllocator ) ) ).first;
+
+	Profile * profile	= &findit->second;
 	profile->ID			= id;
 	profile->Parent		= mCurrent;
 	++(profile->Samples);
@@ -121,6 +129,16 @@ void ProfileManager::Exit( void )
 	mCurrent = mCurrent->Parent;
 }
 
+void ProfileManager::SetAllocator( Allocator& allocator )
+{
+	CBL_ASSERT( mStackCount == 0, "Cannot change the profile allocator while profiling." );
+
+	CBL_DELETE( mRoot );
+	mAllocator	= &allocator;
+	mRoot		= new Profile( *mAllocator );
+	mCurrent	= mRoot;
+}
+
 void ProfileManager::GenerateStatistics(const char* filename)
 {
 	std::ofstream file;
@@ -0,0 +1,101 @@
+/* This source file is part of the Chewable Framework.
+ * For the latest info, please visit http://chewable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file Allocator.cpp
+ * @brief Allocator interface and STL adapters for framework containers.
+ */
+
+// Precompiled Headers //
+#include "cbl/StdAfx.h"
+
+// Chewable Headers //
+#include "cbl/Memory/Allocator.h"
+#include "cbl/Memory/PageArena.h"
+
+// External Dependencies //
+#include <new>
+
+using namespace cbl;
+
+namespace
+{
+	//! Alignment that operator new already guarantees.
+	const size_t sNewAlign = alignof( std::max_align_t );
+}
+
+Allocator& Allocator::GetDefault( void )
+{
+	static HeapAllocator sHeap;
+	return sHeap;
+}
+
+Allocator& Allocator::GetPool( void )
+{
+#if CBL_POOL_PAGE_ARENA == CBL_ENABLED
+	static PageArena sArena( CBL_POOL_ARENA_RESERVE );
+	return sArena;
+#else
+	return GetDefault();
+#endif
+}
+
+void* HeapAllocator::Allocate( size_t size, size_t align )
+{
+	if( align <= sNewAlign )
+		return ::operator new( size );
+
+	// Over-allocate and keep the original pointer just before the aligned block.
+	Char* raw = static_cast< Char* >( ::operator new( size + align + sizeof(void*) ) );
+	size_t aligned = ( reinterpret_cast< size_t >( raw + sizeof(void*) ) + align - 1 ) & ~( align - 1 );
+	reinterpret_cast< void** >( aligned )[-1] = raw;
+	return reinterpret_cast< void* >( aligned );
+}
+
+void HeapAllocator::Deallocate( void* mem, size_t, size_t align )
+{
+	if( mem == NULL )
+		return;
+	::operator delete( align <= sNewAlign ? mem : static_cast< void** >( mem )[-1] );
+}
+
+CountingAllocator::CountingAllocator( Allocator& parent )
+: mParent( parent )
+, mLiveBytes( 0 )
+, mLiveCount( 0 )
+, mAllocations( 0 )
+{
+}
+
+void* CountingAllocator::Allocate( size_t size, size_t align )
+{
+	void* mem = mParent.Allocate( size, align );
+	mLiveBytes.fetch_add( size, std::memory_order_relaxed );
+	mLiveCount.fetch_add( 1, std::memory_order_relaxed );
+	mAllocations.fetch_add( 1, std::memory_order_relaxed );
+	return mem;
+}
+
+void CountingAllocator::Deallocate( void* mem, size_t size, size_t align )
+{
+	if( mem == NULL )
+		return;
+	mParent.Deallocate( mem, size, align );
+	mLiveBytes.fetch_sub( size, std::memory_order_relaxed );
+	mLiveCount.fetch_sub( 1, std::memory_order_relaxed );
+}
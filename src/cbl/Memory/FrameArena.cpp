@@ -0,0 +1,133 @@
+/* This source file is part of the Chewable Framework.
+ * For the latest info, please visit http://chewable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file FrameArena.cpp
+ * @brief Per-thread linear allocator for scratch memory that lives for one frame.
+ */
+
+// Precompiled Headers //
+#include "cbl/StdAfx.h"
+
+// Chewable Headers //
+#include "cbl/Memory/FrameArena.h"
+#include "cbl/Memory/MemTracker.h"
+#include "cbl/Debug/Assert.h"
+
+using namespace cbl;
+
+FrameArena& FrameArena::Get( void )
+{
+	static thread_local FrameArena sArena;
+	return sArena;
+}
+
+FrameArena::FrameArena( size_t blockSize )
+: mBlock( 0 )
+, mOffset( 0 )
+, mUsed( 0 )
+, mHighWater( 0 )
+, mBlockSize( blockSize )
+{
+	Block block = { new Char[ blockSize ], blockSize };
+	mBlocks.push_back( block );
+	CBL_MEM_TRACK_ALLOC( "FrameArena", blockSize );
+}
+
+FrameArena::~FrameArena()
+{
+	for( size_t i = 0; i < mBlocks.size(); ++i ) {
+		CBL_MEM_TRACK_FREE( "FrameArena", mBlocks[i].Size );
+		delete [] mBlocks[i].Data;
+	}
+}
+
+void* FrameArena::Allocate( size_t size, size_t align )
+{
+	CBL_ASSERT( ( align & ( align - 1 ) ) == 0, "Alignment must be a power of 2." );
+
+	for( ;; ) {
+		Block& block = mBlocks[mBlock];
+		size_t start = ( reinterpret_cast<size_t>( block.Data ) + mOffset + align - 1 ) & ~( align - 1 );
+		size_t end = start - reinterpret_cast<size_t>( block.Data ) + size;
+		if( end <= block.Size ) {
+			mUsed += end - mOffset;
+			mOffset = end;
+			if( mUsed > mHighWater )
+				mHighWater = mUsed;
+			return reinterpret_cast<void*>( start );
+		}
+
+		// Count the unused tail so the high-water mark reflects what a single block needs.
+		mUsed += block.Size - mOffset;
+		mOffset = 0;
+		++mBlock;
+
+		// Reuse a spare block if it's big enough, otherwise slot in a new one.
+		if( mBlock == mBlocks.size() || mBlocks[mBlock].Size < size + align ) {
+			size_t blockSize = size + align > mBlockSize ? size + align : mBlockSize;
+			Block newBlock = { new Char[ blockSize ], blockSize };
+			mBlocks.insert( mBlocks.begin() + mBlock, newBlock );
+			CBL_MEM_TRACK_ALLOC( "FrameArena", blockSize );
+		}
+	}
+}
+
+FrameArena::Marker FrameArena::GetMarker( void ) const
+{
+	Marker marker = { mBlock, mOffset, mUsed };
+	return marker;
+}
+
+void FrameArena::Release( const Marker& marker )
+{
+	CBL_ASSERT( marker.Block < mBlock || ( marker.Block == mBlock && marker.Offset <= mOffset ), "Releasing past the current position." );
+	mBlock	= marker.Block;
+	mOffset	= marker.Offset;
+	mUsed	= marker.Used;
+}
+
+void FrameArena::Reset( void )
+{
+	mBlock	= 0;
+	mOffset	= 0;
+	mUsed	= 0;
+
+	if( mBlocks.size() == 1 )
+		return;
+
+	// The frame spilled over; replace the blocks with one that fits the peak.
+	size_t blockSize = mHighWater > mBlockSize ? mHighWater : mBlockSize;
+	for( size_t i = 0; i < mBlocks.size(); ++i ) {
+		CBL_MEM_TRACK_FREE( "FrameArena", mBlocks[i].Size );
+		delete [] mBlocks[i].Data;
+	}
+	mBlocks.clear();
+
+	Block block = { new Char[ blockSize ], blockSize };
+	mBlocks.push_back( block );
+	CBL_MEM_TRACK_ALLOC( "FrameArena", blockSize );
+}
+
+size_t FrameArena::GetCapacity( void ) const
+{
+	size_t capacity = 0;
+	for( size_t i = 0; i < mBlocks.size(); ++i )
+		capacity += mBlocks[i].Size;
+	return capacity;
+}
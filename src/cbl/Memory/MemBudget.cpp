@@ -0,0 +1,141 @@
+/* This source file is part of the Chewable Framework.
+ * For the latest info, please visit http://chewable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file MemBudget.cpp
+ * @brief Memory budgets per subsystem with soft and hard limits.
+ */
+
+// Precompiled Headers //
+#include "cbl/StdAfx.h"
+
+// Chewable Headers //
+#include "cbl/Memory/MemBudget.h"
+#include "cbl/Debug/Assert.h"
+
+using namespace cbl;
+
+namespace
+{
+	//! Budget whose pressure event the thread is currently raising.
+	thread_local const MemBudget* sRaising = NULL;
+}
+
+MemBudget& MemBudget::Get( MemCategory::Options category )
+{
+	static MemBudget sObjects( "Objects" );
+	static MemBudget sParts( "Parts" );
+	static MemBudget sSerialisation( "Serialisation" );
+	static MemBudget sLogging( "Logging" );
+
+	switch( category ) {
+	case MemCategory::Parts:			return sParts;
+	case MemCategory::Serialisation:	return sSerialisation;
+	case MemCategory::Logging:			return sLogging;
+	default:							return sObjects;
+	}
+}
+
+MemBudget::MemBudget( const Char* name, Allocator& parent )
+: mName( name )
+, mParent( parent )
+, mUsed( 0 )
+, mPeak( 0 )
+, mSoftLimit( 0 )
+, mHardLimit( 0 )
+, mFailures( 0 )
+, mSoftRaised( false )
+{
+}
+
+void* MemBudget::Allocate( size_t size, size_t align )
+{
+	size_t used;
+	if( !_Reserve( size, used ) ) {
+		// Give listeners a chance to free memory before refusing.
+		_RaisePressure( MemPressure::Hard );
+		if( !_Reserve( size, used ) ) {
+			mFailures.fetch_add( 1, std::memory_order_relaxed );
+			return NULL;
+		}
+	}
+
+	void* mem = mParent.Allocate( size, align );
+	if( mem == NULL ) {
+		mUsed.fetch_sub( size, std::memory_order_relaxed );
+		mFailures.fetch_add( 1, std::memory_order_relaxed );
+		return NULL;
+	}
+
+	size_t soft = GetSoftLimit();
+	if( soft > 0 && used >= soft && !mSoftRaised.exchange( true, std::memory_order_relaxed ) )
+		_RaisePressure( MemPressure::Soft );
+
+	return mem;
+}
+
+void MemBudget::Deallocate( void* mem, size_t size, size_t align )
+{
+	if( mem == NULL )
+		return;
+
+	mParent.Deallocate( mem, size, align );
+	size_t used = mUsed.fetch_sub( size, std::memory_order_relaxed ) - size;
+
+	// Re-arm the soft signal once usage drops back below the limit.
+	if( mSoftRaised.load( std::memory_order_relaxed ) && used < GetSoftLimit() )
+		mSoftRaised.store( false, std::memory_order_relaxed );
+}
+
+void MemBudget::SetLimits( size_t soft, size_t hard )
+{
+	CBL_ASSERT( hard == 0 || soft <= hard, "Soft limit above the hard limit." );
+	mSoftLimit.store( soft, std::memory_order_relaxed );
+	mHardLimit.store( hard, std::memory_order_relaxed );
+	mSoftRaised.store( soft > 0 && GetUsed() >= soft, std::memory_order_relaxed );
+}
+
+void MemBudget::ResetPeak( void )
+{
+	mPeak.store( GetUsed(), std::memory_order_relaxed );
+}
+
+bool MemBudget::_Reserve( size_t size, size_t& used )
+{
+	used = mUsed.fetch_add( size, std::memory_order_relaxed ) + size;
+	size_t hard = GetHardLimit();
+	if( hard > 0 && used > hard ) {
+		mUsed.fetch_sub( size, std::memory_order_relaxed );
+		return false;
+	}
+
+	size_t peak = mPeak.load( std::memory_order_relaxed );
+	while( used > peak && !mPeak.compare_exchange_weak( peak, used, std::memory_order_relaxed ) ) {}
+	return true;
+}
+
+void MemBudget::_RaisePressure( MemPressure::Options pressure )
+{
+	if( sRaising == this )
+		return;
+
+	const MemBudget* previous = sRaising;
+	sRaising = this;
+	OnMemoryPressure( *this, pressure );
+	sRaising = previous;
+}
@@ -0,0 +1,171 @@
+/* This source file is part of the Chewable Framework.
+ * For the latest info, please visit http://chewable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file MemTracker.cpp
+ * @brief Allocation tracking per reflected type and per subsystem tag.
+ */
+
+// Precompiled Headers //
+#include "cbl/StdAfx.h"
+
+// Chewable Headers //
+#include "cbl/Memory/MemTracker.h"
+#include "cbl/Reflection/Type.h"
+
+// External Dependencies //
+#include <chrono>
+
+using namespace cbl;
+
+namespace
+{
+	//! Current tag of each thread.
+	thread_local const CName* sCurrentTag = NULL;
+
+	bool DeltaGreater( const MemTracker::Delta& lhs, const MemTracker::Delta& rhs )
+	{
+		return lhs.Bytes > rhs.Bytes;
+	}
+}
+
+MemTracker::MemTracker()
+: mStart( std::chrono::steady_clock::now().time_since_epoch().count() )
+{
+}
+
+void MemTracker::TrackAllocate( const Type& type, const void* obj )
+{
+	std::lock_guard< std::mutex > lock( mLock );
+	Add( mTypes, type.Name, type.Size );
+	if( sCurrentTag ) {
+		Add( mTags, *sCurrentTag, type.Size );
+		mObjectTags[obj] = *sCurrentTag;
+	}
+}
+
+void MemTracker::TrackFree( const Type& type, const void* obj )
+{
+	std::lock_guard< std::mutex > lock( mLock );
+	Remove( mTypes, type.Name, type.Size );
+
+	TagTable::iterator findIt = mObjectTags.find( obj );
+	if( findIt != mObjectTags.end() ) {
+		Remove( mTags, findIt->second, type.Size );
+		mObjectTags.erase( findIt );
+	}
+}
+
+void MemTracker::TrackAllocate( const CName& tag, size_t bytes )
+{
+	std::lock_guard< std::mutex > lock( mLock );
+	Add( mTags, tag, bytes );
+}
+
+void MemTracker::TrackFree( const CName& tag, size_t bytes )
+{
+	std::lock_guard< std::mutex > lock( mLock );
+	Remove( mTags, tag, bytes );
+}
+
+MemTracker::Snapshot MemTracker::TakeSnapshot( void ) const
+{
+	Snapshot snapshot;
+	{
+		std::lock_guard< std::mutex > lock( mLock );
+		snapshot.Types	= mTypes;
+		snapshot.Tags	= mTags;
+	}
+	snapshot.Time = GetTime();
+	return snapshot;
+}
+
+void MemTracker::Reset( void )
+{
+	std::lock_guard< std::mutex > lock( mLock );
+	mTypes.clear();
+	mTags.clear();
+	mObjectTags.clear();
+}
+
+MemTracker::DeltaList MemTracker::Diff( const StatsTable& before, const StatsTable& after, Float64 seconds )
+{
+	DeltaList deltas;
+	static const Stats sEmpty;
+
+	CBL_FOREACH_CONST( StatsTable, it, after ) {
+		StatsTable::const_iterator findIt = before.find( it->first );
+		const Stats& old = findIt != before.end() ? findIt->second : sEmpty;
+
+		Delta delta;
+		delta.Name			= it->first;
+		delta.Count			= it->second.LiveCount - old.LiveCount;
+		delta.Bytes			= it->second.LiveBytes - old.LiveBytes;
+		delta.Allocations	= it->second.Allocations - old.Allocations;
+		delta.Rate			= seconds > 0 ? Float64( delta.Allocations ) / seconds : 0;
+		if( delta.Count != 0 || delta.Bytes != 0 || delta.Allocations != 0 )
+			deltas.push_back( delta );
+	}
+
+	std::stable_sort( deltas.begin(), deltas.end(), DeltaGreater );
+	return deltas;
+}
+
+const CName* MemTracker::GetCurrentTag( void )
+{
+	return sCurrentTag;
+}
+
+void MemTracker::Add( StatsTable& table, const CName& name, size_t bytes )
+{
+	Stats& stats = table[name];
+	++stats.Allocations;
+	++stats.LiveCount;
+	stats.LiveBytes += Int64( bytes );
+	if( stats.LiveCount > stats.PeakCount )
+		stats.PeakCount = stats.LiveCount;
+	if( stats.LiveBytes > stats.PeakBytes )
+		stats.PeakBytes = stats.LiveBytes;
+}
+
+void MemTracker::Remove( StatsTable& table, const CName& name, size_t bytes )
+{
+	Stats& stats = table[name];
+	++stats.Frees;
+	--stats.LiveCount;
+	stats.LiveBytes -= Int64( bytes );
+}
+
+Float64 MemTracker::GetTime( void ) const
+{
+	typedef std::chrono::steady_clock Clock;
+	Int64 ticks = Clock::now().time_since_epoch().count() - mStart;
+	return Float64( ticks ) * Clock::period::num / Clock::period::den;
+}
+
+MemTagScope::MemTagScope( const CName& tag )
+: mTag( tag )
+, mPrevious( sCurrentTag )
+{
+	sCurrentTag = &mTag;
+}
+
+MemTagScope::~MemTagScope()
+{
+	sCurrentTag = mPrevious;
+}
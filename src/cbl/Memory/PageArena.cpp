@@ -0,0 +1,201 @@
+/* This source file is part of the Chewable Framework.
+ * For the latest info, please visit http://chewable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file PageArena.cpp
+ * @brief Virtual memory arena that commits pages on demand, optionally as huge pages.
+ */
+
+// Precompiled Headers //
+#include "cbl/StdAfx.h"
+
+// Chewable Headers //
+#include "cbl/Memory/PageArena.h"
+#include "cbl/Debug/Assert.h"
+
+// External Dependencies //
+#if ( CBL_PLATFORM == CBL_PLATFORM_WIN32 ) || ( CBL_PLATFORM == CBL_PLATFORM_WIN64 )
+#	include <windows.h>
+#else
+#	include <sys/mman.h>
+#endif
+
+using namespace cbl;
+
+namespace
+{
+	//! Reserve address space without committing it.
+	void* ReserveRange( size_t size )
+	{
+	#if ( CBL_PLATFORM == CBL_PLATFORM_WIN32 ) || ( CBL_PLATFORM == CBL_PLATFORM_WIN64 )
+		return VirtualAlloc( NULL, size, MEM_RESERVE, PAGE_NOACCESS );
+	#else
+		void* mem = mmap( NULL, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0 );
+		return mem != MAP_FAILED ? mem : NULL;
+	#endif
+	}
+
+	//! Commit part of a reserved range.
+	//! @param	hugePages	Ask for huge pages, cleared if the OS doesn't support them.
+	bool CommitRange( void* mem, size_t size, bool& hugePages )
+	{
+	#if ( CBL_PLATFORM == CBL_PLATFORM_WIN32 ) || ( CBL_PLATFORM == CBL_PLATFORM_WIN64 )
+		hugePages = false;
+		return VirtualAlloc( mem, size, MEM_COMMIT, PAGE_READWRITE ) != NULL;
+	#else
+		if( mprotect( mem, size, PROT_READ | PROT_WRITE ) != 0 )
+			return false;
+	#	ifdef MADV_HUGEPAGE
+		if( hugePages && madvise( mem, size, MADV_HUGEPAGE ) != 0 )
+			hugePages = false;
+	#	else
+		hugePages = false;
+	#	endif
+		return true;
+	#endif
+	}
+
+	//! Release a whole reserved range.
+	void ReleaseRange( void* mem, size_t size )
+	{
+	#if ( CBL_PLATFORM == CBL_PLATFORM_WIN32 ) || ( CBL_PLATFORM == CBL_PLATFORM_WIN64 )
+		(void)size;
+		VirtualFree( mem, 0, MEM_RELEASE );
+	#else
+		munmap( mem, size );
+	#endif
+	}
+}
+
+PageArena::PageArena( size_t reserve, bool hugePages )
+: mMapping( NULL )
+, mMappingSize( 0 )
+, mBase( NULL )
+, mReserved( 0 )
+, mCommitted( 0 )
+, mOffset( 0 )
+, mCommits( 0 )
+, mFallbacks( 0 )
+, mHugePages( hugePages )
+{
+	// Round up to whole commits, and reserve one extra so the range can start on a
+	// commit boundary; huge pages need 2MB aligned addresses.
+	const size_t commit = CBL_PAGE_ARENA_COMMIT;
+	reserve = ( reserve + commit - 1 ) / commit * commit;
+
+	mMapping = ReserveRange( reserve + commit );
+	if( !mMapping ) {
+		mHugePages = false;
+		return;
+	}
+
+	mMappingSize	= reserve + commit;
+	mBase			= reinterpret_cast< Char* >( ( reinterpret_cast< size_t >( mMapping ) + commit - 1 ) & ~( commit - 1 ) );
+	mReserved		= reserve;
+}
+
+PageArena::~PageArena()
+{
+	if( mMapping )
+		ReleaseRange( mMapping, mMappingSize );
+}
+
+void* PageArena::Allocate( size_t size, size_t align )
+{
+	{
+		std::lock_guard< std::mutex > lock( mLock );
+
+		FreeLists::iterator findIt = mFree.find( size );
+		if( findIt != mFree.end() && !findIt->second.empty() ) {
+			void* mem = findIt->second.back();
+			if( ( reinterpret_cast< size_t >( mem ) & ( align - 1 ) ) == 0 ) {
+				findIt->second.pop_back();
+				return mem;
+			}
+		}
+
+		size_t offset = ( mOffset + align - 1 ) & ~( align - 1 );
+		if( mBase && offset + size <= mReserved && _CommitTo( offset + size ) ) {
+			mOffset = offset + size;
+			return mBase + offset;
+		}
+
+		++mFallbacks;
+	}
+
+	return Allocator::GetDefault().Allocate( size, align );
+}
+
+void PageArena::Deallocate( void* mem, size_t size, size_t align )
+{
+	if( mem == NULL )
+		return;
+
+	if( !Owns( mem ) ) {
+		Allocator::GetDefault().Deallocate( mem, size, align );
+		return;
+	}
+
+	std::lock_guard< std::mutex > lock( mLock );
+	mFree[size].push_back( mem );
+}
+
+bool PageArena::Owns( const void* mem ) const
+{
+	const Char* ptr = static_cast< const Char* >( mem );
+	return ptr >= mBase && ptr < mBase + mReserved;
+}
+
+size_t PageArena::GetCommitted( void ) const
+{
+	std::lock_guard< std::mutex > lock( mLock );
+	return mCommitted;
+}
+
+size_t PageArena::GetUsed( void ) const
+{
+	std::lock_guard< std::mutex > lock( mLock );
+	return mOffset;
+}
+
+Uint32 PageArena::GetCommitCount( void ) const
+{
+	std::lock_guard< std::mutex > lock( mLock );
+	return mCommits;
+}
+
+Uint32 PageArena::GetFallbackCount( void ) const
+{
+	std::lock_guard< std::mutex > lock( mLock );
+	return mFallbacks;
+}
+
+bool PageArena::_CommitTo( size_t offset )
+{
+	if( offset <= mCommitted )
+		return true;
+
+	const size_t commit = CBL_PAGE_ARENA_COMMIT;
+	size_t target = ( offset + commit - 1 ) / commit * commit;
+	if( !CommitRange( mBase + mCommitted, target - mCommitted, mHugePages ) )
+		return false;
+
+	mCommitted = target;
+	++mCommits;
+	return true;
+}
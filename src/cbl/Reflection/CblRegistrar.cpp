@@ -30,11 +30,17 @@ CblRegistrar CblRegistrar::_sInstance = CblRegistrar();
 
 void CblRegistrar::RegisterCblTypes( void )
 {
-	TypeDB& typedb = CBL_ENT.Types;
+	CBL_ENT.Types.AddModule( &CblRegistrar::_Register );
+	CBL_ENT.Types.RegisterModules();
+}
 
+void CblRegistrar::_Register( TypeDB& typedb )
+{
 	// Create all basic Chewable types.
-	typedb.Create<ObjectPart>();
+	typedb.Create<ObjectPart>()
+		.AllocateFrom( MemBudget::Get( MemCategory::Parts ) );
 	typedb.Create<Object>()
+		.AllocateFrom( MemBudget::Get( MemCategory::Objects ) )
 		.CBL_FIELDM( Name, Object )
 		.CBL_FIELDM( Parts, Object );
 	typedb.Create<GameState>();
@@ -100,6 +106,6 @@ void CblRegistrar::RegisterCblTypes( void )
 
 CblRegistrar::CblRegistrar()
 {
-	// Automatically register cbl types.
-	RegisterCblTypes();
+	// Register cbl types on first use, keeping the work out of static initialisation.
+	CBL_ENT.Types.AddModule( &CblRegistrar::_Register );
 }
@@ -0,0 +1,516 @@
+/* This source file is part of the Chewable Framework.
+ * For the latest info, please visit http://chewable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file Patch.cpp
+ * @brief Structural difference between two objects of a reflected type.
+ */
+
+// Precompiled Headers //
+#include "cbl/StdAfx.h"
+
+// Chewable Headers //
+#include "cbl/Reflection/Patch.h"
+#include "cbl/Reflection/Typing.h"
+#include "cbl/Reflection/EntityManager.h"
+
+// External Dependencies //
+#include <algorithm>
+#include <unordered_map>
+
+using namespace cbl;
+
+namespace
+{
+	//! Multimap of element hashes to element positions.
+	typedef std::unordered_multimap< HashValue, size_t >	ElementIndex;
+
+	inline void AppendBytes( String& out, const void* src, size_t size )
+	{
+		out.append( static_cast< const Char* >( src ), size );
+	}
+
+	inline bool ReadBytes( ByteStream& stream, void* dst, Uint32 size )
+	{
+		if( stream.GetSize() < size )
+			return false;
+		stream.Read( static_cast< Char* >( dst ), size );
+		return true;
+	}
+
+	template< typename TYPE >
+	inline bool ReadValue( ByteStream& stream, TYPE& value )
+	{
+		return ReadBytes( stream, &value, sizeof( TYPE ) );
+	}
+
+	template< typename TYPE >
+	inline String EncodeValue( const TYPE& value )
+	{
+		return String( reinterpret_cast< const Char* >( &value ), sizeof( TYPE ) );
+	}
+
+	//! Get the value at a position in a sequence, indexing directly into contiguous ones.
+	//! @return		Value, NULL if the position is past the end.
+	void* ElementAt( FieldContainer* container, const void* obj, Uint32 index )
+	{
+		if( container->IsContiguous ) {
+			if( index >= container->GetCount( obj ) )
+				return NULL;
+			return static_cast< Uint8* >( container->GetData( obj ) ) + size_t( index ) * container->Stride;
+		}
+
+		void* element = NULL;
+		Uint32 position = 0;
+		CBL_FOREACH_READ_FIELD_BEGIN( container, it, obj ) {
+			if( position++ == index ) {
+				element = const_cast< void* >( it->GetValue() );
+				break;
+			}
+		}
+		CBL_FOREACH_FIELD_END( container, it );
+		return element;
+	}
+
+	//! Encode a value without fields, or a key.
+	//! @return		False if the value is neither plain data nor has a string form, as it
+	//!				couldn't be read back.
+	bool WriteLeaf( String& out, const Type& type, const void* obj )
+	{
+		if( type.IsPlain() ) {
+			AppendBytes( out, obj, type.Size );
+			return true;
+		}
+		if( !type.ToString || !type.FromString )
+			return false;
+
+		String str;
+		type.ToString( str, &type, obj, NULL );
+		const Uint32 length = Uint32( str.length() );
+		AppendBytes( out, &length, sizeof( length ) );
+		out.append( str );
+		return true;
+	}
+
+	//! Decode a value written by WriteLeaf.
+	bool ReadLeaf( ByteStream& stream, const Type& type, void* obj )
+	{
+		if( type.IsPlain() )
+			return ReadBytes( stream, obj, Uint32( type.Size ) );
+
+		Uint32 length = 0;
+		if( !ReadValue( stream, length ) || stream.GetSize() < length || !type.FromString )
+			return false;
+		String str( length, '\0' );
+		if( length > 0 )
+			stream.Read( &str[0], length );
+		type.FromString( str, &type, obj, NULL );
+		return true;
+	}
+
+	//! Collect the key and value addresses of a container's elements.
+	void CollectElements( const Field& field, const void* container, std::vector< std::pair< const void*, const void* > >& elements )
+	{
+		CBL_FOREACH_READ_FIELD_BEGIN( field.Container, it, container ) {
+			elements.push_back( std::make_pair( it->GetKey(), it->GetValue() ) );
+		}
+		CBL_FOREACH_FIELD_END( field.Container, it );
+	}
+
+	//! Index elements by the hash of their key (or value, for sets).
+	void IndexElements( const Type& type, const std::vector< std::pair< const void*, const void* > >& elements, bool byKey, ElementIndex& index )
+	{
+		for( size_t i = 0; i < elements.size(); ++i )
+			index.insert( std::make_pair( type.HashContents( byKey ? elements[i].first : elements[i].second ), i ) );
+	}
+
+	//! Find an element by key (or value, for sets).
+	//! @return		Position of the element, or elements.size() if there's none.
+	size_t FindElement( const Type& type, const std::vector< std::pair< const void*, const void* > >& elements, bool byKey, const ElementIndex& index, const void* key )
+	{
+		std::pair< ElementIndex::const_iterator, ElementIndex::const_iterator > range = index.equal_range( type.HashContents( key ) );
+		for( ElementIndex::const_iterator it = range.first; it != range.second; ++it )
+			if( type.Equals( byKey ? elements[it->second].first : elements[it->second].second, key ) )
+				return it->second;
+		return elements.size();
+	}
+}
+
+Patch::Patch()
+: mCount( 0 )
+{
+}
+
+Patch::Patch( const Char* bytes, Uint32 size )
+: mStream( bytes, Int32( size ) ), mCount( 0 )
+{
+}
+
+void Patch::Clear( void )
+{
+	mStream.Clear();
+	mCount = 0;
+	mPath.clear();
+}
+
+bool Patch::_Diff( const Type& type, const void* a, const void* b )
+{
+	Clear();
+	return _DiffObject( type, a, b ) && !mStream.HasFailed();
+}
+
+bool Patch::_DiffSlot( const Type& type, bool isPointer, const void* a, const void* b )
+{
+	if( !isPointer )
+		return _DiffObject( type, a, b );
+
+	const void* pa = a ? *static_cast< void* const* >( a ) : NULL;
+	const void* pb = *static_cast< void* const* >( b );
+	if( !pb ) {
+		// Without a previous value, the pointer may not start out as NULL.
+		return pa || !a ? _Emit( P_CLEAR, String() ) : true;
+	}
+
+	const Type& actual = type._GetObjectType( pb );
+	if( pa && &type._GetObjectType( pa ) == &actual )
+		return _DiffObject( actual, pa, pb );
+
+	return _Emit( P_NEW, EncodeValue( actual.Name.Hash ) ) && _DiffObject( actual, NULL, pb );
+}
+
+bool Patch::_DiffObject( const Type& type, const void* a, const void* b )
+{
+	if( a && type.Equals( a, b ) )
+		return true;
+
+	if( !type.HasFields() ) {
+		String payload;
+		return WriteLeaf( payload, type, b ) && _Emit( P_SET, payload );
+	}
+
+	const Type::FieldTable& fields = type.GetAllFields();
+	for( size_t i = 0; i < fields.size(); ++i ) {
+		const Field& field = *fields[i];
+		if( field.Attributes.Transient != 0 )
+			continue;
+
+		mPath.push_back( EncodeValue( field.Name.Hash ) );
+		const void* fa = a ? field.GetPtr( a ) : NULL;
+		const bool written = field.Container
+			? _DiffContainer( field, fa, field.GetPtr( b ) )
+			: _DiffSlot( *field.Type, field.IsPointer, fa, field.GetPtr( b ) );
+		mPath.pop_back();
+		if( !written )
+			return false;
+	}
+	return true;
+}
+
+bool Patch::_DiffContainer( const Field& field, const void* a, const void* b )
+{
+	const FieldContainer& container = *field.Container;
+	if( a && Type::_EqualContainer( field, a, b ) )
+		return true;
+
+	Elements ea, eb;
+	if( a )
+		CollectElements( field, a, ea );
+	CollectElements( field, b, eb );
+
+	// Arrays always have all their elements. Other containers are emptied first when
+	// there's nothing to compare to, as they may not start out empty.
+	if( !a && !container.IsFixedSize && !_Emit( P_RESIZE, EncodeValue( Uint32( 0 ) ) ) )
+		return false;
+
+	return container.IsKeyed ? _DiffKeyed( field, ea, eb ) : _DiffSequence( field, ea, eb );
+}
+
+bool Patch::_DiffSequence( const Field& field, const Elements& ea, const Elements& eb )
+{
+	const FieldContainer& container = *field.Container;
+	const bool fixed = container.IsFixedSize;
+	auto equal = [&container]( const void* a, const void* b ) {
+		return container.IsValuePointer
+			? Type::_EqualPointer( *container.ValueType, *static_cast< void* const* >( a ), *static_cast< void* const* >( b ) )
+			: container.ValueType->Equals( a, b );
+	};
+
+	// Only the middle between the unchanged ends is written.
+	const size_t common = std::min( ea.size(), eb.size() );
+	size_t prefix = 0, suffix = 0;
+	while( prefix < common && equal( ea[prefix].second, eb[prefix].second ) )
+		++prefix;
+	while( suffix < common - prefix && equal( ea[ea.size() - 1 - suffix].second, eb[eb.size() - 1 - suffix].second ) )
+		++suffix;
+	const size_t changedA = ea.size() - prefix - suffix;
+	const size_t changedB = eb.size() - prefix - suffix;
+
+	// Elements both sides have are diffed in place, the rest of b's are inserted before
+	// the unchanged end (or appended, if there's none).
+	for( size_t i = prefix; i < prefix + changedB; ++i ) {
+		const Uint32 index = Uint32( i );
+		const bool exists = i < prefix + changedA;
+		if( !exists && !fixed && !( suffix > 0 ? _Emit( P_INSERT, EncodeValue( index ) ) : _Emit( P_APPEND, String() ) ) )
+			return false;
+		mPath.push_back( EncodeValue( index ) );
+		const bool written = _DiffSlot( *container.ValueType, container.IsValuePointer, exists ? ea[i].second : NULL, eb[i].second );
+		mPath.pop_back();
+		if( !written )
+			return false;
+	}
+
+	// The rest of a's are erased, or cut off in one go if they're at the end.
+	if( changedA > changedB ) {
+		const Uint32 index = Uint32( prefix + changedB );
+		if( suffix == 0 )
+			return _Emit( P_RESIZE, EncodeValue( index ) );
+		for( size_t i = changedB; i < changedA; ++i )
+			if( !_Emit( P_ERASE, EncodeValue( index ) ) )
+				return false;
+	}
+	return true;
+}
+
+bool Patch::_DiffKeyed( const Field& field, const Elements& ea, const Elements& eb )
+{
+	const FieldContainer& container = *field.Container;
+	const bool isMap = container.KeyType != NULL;
+	const Type& keyType = isMap ? *container.KeyType : *container.ValueType;
+
+	ElementIndex index;
+	IndexElements( keyType, ea, isMap, index );
+	std::vector< bool > matched( ea.size(), false );
+
+	for( size_t j = 0; j < eb.size(); ++j ) {
+		const void* key = isMap ? eb[j].first : eb[j].second;
+		const size_t i = FindElement( keyType, ea, isMap, index, key );
+		String encodedKey;
+		if( !WriteLeaf( encodedKey, keyType, key ) )
+			return false;
+
+		if( i < ea.size() )
+			matched[i] = true;
+		else if( !_Emit( P_INSERT, encodedKey ) )
+			return false;
+
+		// Set values are their own keys, only map values can change.
+		if( isMap ) {
+			mPath.push_back( encodedKey );
+			const bool written = _DiffSlot( *container.ValueType, container.IsValuePointer, i < ea.size() ? ea[i].second : NULL, eb[j].second );
+			mPath.pop_back();
+			if( !written )
+				return false;
+		}
+	}
+
+	for( size_t i = 0; i < ea.size(); ++i ) {
+		if( matched[i] )
+			continue;
+		String encodedKey;
+		if( !WriteLeaf( encodedKey, keyType, isMap ? ea[i].first : ea[i].second ) || !_Emit( P_ERASE, encodedKey ) )
+			return false;
+	}
+	return true;
+}
+
+bool Patch::_Emit( OPERATION op, const String& payload )
+{
+	CBL_ASSERT( mPath.size() <= 0xFF, "Patch path is too deep." );
+	mStream << Uint8( op ) << Uint8( mPath.size() );
+	for( size_t i = 0; i < mPath.size(); ++i )
+		mStream.Write( mPath[i].data(), Uint32( mPath[i].length() ) );
+	mStream.Write( payload.data(), Uint32( payload.length() ) );
+	++mCount;
+	return !mStream.HasFailed();
+}
+
+bool Patch::_Apply( const Type& type, void* obj ) const
+{
+	// Reading consumes the stream, so read a copy; it may not have fit in the budget.
+	ByteStream stream( mStream );
+	if( mStream.HasFailed() || stream.HasFailed() )
+		return false;
+
+	while( stream.GetSize() > 0 ) {
+		Uint8 op = 0, depth = 0;
+		if( !ReadValue( stream, op ) || !ReadValue( stream, depth ) || op >= P_COUNT )
+			return false;
+
+		Cursor cursor = { &type, obj, NULL, false };
+		if( !_Seek( stream, depth, cursor ) )
+			return false;
+
+		switch( op ) {
+		case P_SET:
+			if( cursor.Container || cursor.IsPointer || !ReadLeaf( stream, *cursor.Type, cursor.Addr ) )
+				return false;
+			break;
+		case P_CLEAR:
+			if( !cursor.IsPointer )
+				return false;
+			Type::_DeletePointer( *cursor.Type, *static_cast< void** >( cursor.Addr ) );
+			*static_cast< void** >( cursor.Addr ) = NULL;
+			break;
+		case P_NEW: {
+				HashValue hash = 0;
+				const Type* actual = ReadValue( stream, hash ) ? type.DB->Get( CName( hash ) ) : NULL;
+				if( !cursor.IsPointer || !actual || !actual->IsType( *cursor.Type ) )
+					return false;
+				Type::_DeletePointer( *cursor.Type, *static_cast< void** >( cursor.Addr ) );
+				*static_cast< void** >( cursor.Addr ) = actual->_NewObject();
+			}
+			break;
+		case P_RESIZE: {
+				Uint32 count = 0;
+				if( !cursor.Container || !ReadValue( stream, count ) )
+					return false;
+				const FieldContainer& container = *cursor.Container->Container;
+				if( container.IsValuePointer ) {
+					// Free the pointed to objects of the elements being dropped.
+					Uint32 position = 0;
+					CBL_FOREACH_READ_FIELD_BEGIN( cursor.Container->Container, it, cursor.Addr ) {
+						if( position++ >= count )
+							Type::_DeletePointer( *container.ValueType, *static_cast< void* const* >( it->GetValue() ) );
+					}
+					CBL_FOREACH_FIELD_END( cursor.Container->Container, it );
+				}
+				FieldWriteIterator* it = CBL_NEW_FIELD_WRITEIT( cursor.Container->Container, cursor.Addr );
+				const bool resized = it->Truncate( count );
+				CBL_DEL_FIELD_IT( cursor.Container->Container, it );
+				if( !resized )
+					return false;
+			}
+			break;
+		case P_APPEND: {
+				if( !cursor.Container || cursor.Container->Container->IsKeyed || cursor.Container->Container->IsFixedSize )
+					return false;
+				FieldWriteIterator* it = CBL_NEW_FIELD_WRITEIT( cursor.Container->Container, cursor.Addr );
+				it->AddEmpty();
+				CBL_DEL_FIELD_IT( cursor.Container->Container, it );
+			}
+			break;
+		case P_INSERT:
+		case P_ERASE: {
+				if( !cursor.Container || cursor.Container->Container->IsFixedSize )
+					return false;
+				const FieldContainer& container = *cursor.Container->Container;
+				if( !container.IsKeyed ) {
+					// Sequences insert and erase by position.
+					Uint32 index = 0;
+					if( !ReadValue( stream, index ) )
+						return false;
+					if( op == P_ERASE && container.IsValuePointer ) {
+						if( void* element = ElementAt( cursor.Container->Container, cursor.Addr, index ) )
+							Type::_DeletePointer( *container.ValueType, *static_cast< void** >( element ) );
+					}
+					FieldWriteIterator* it = CBL_NEW_FIELD_WRITEIT( cursor.Container->Container, cursor.Addr );
+					const bool done = op == P_ERASE ? it->EraseAt( index ) : it->InsertEmpty( index ) != NULL;
+					CBL_DEL_FIELD_IT( cursor.Container->Container, it );
+					if( !done )
+						return false;
+					break;
+				}
+
+				const Type& keyType = container.KeyType ? *container.KeyType : *container.ValueType;
+				void* key = keyType._NewObject();
+				bool read = key && ReadLeaf( stream, keyType, key );
+				if( read ) {
+					FieldWriteIterator* it = CBL_NEW_FIELD_WRITEIT( cursor.Container->Container, cursor.Addr );
+					if( op == P_ERASE ) {
+						// Keys can't be pointers, but map values can.
+						const void* value = container.IsValuePointer ? container.Find( cursor.Addr, key ) : NULL;
+						if( value )
+							Type::_DeletePointer( *container.ValueType, *static_cast< void* const* >( value ) );
+						it->Erase( key );
+					}
+					else if( container.KeyType )
+						it->AddEmpty( key );
+					else
+						it->Add( key );
+					CBL_DEL_FIELD_IT( cursor.Container->Container, it );
+				}
+				if( key )
+					keyType.Delete( key );
+				if( !read )
+					return false;
+			}
+			break;
+		}
+	}
+	return true;
+}
+
+bool Patch::_Seek( ByteStream& stream, Uint32 depth, Cursor& cursor ) const
+{
+	for( Uint32 step = 0; step < depth; ++step ) {
+		if( cursor.Container ) {
+			// Step into a container element, by key for maps and position otherwise.
+			const FieldContainer& container = *cursor.Container->Container;
+			void* element = NULL;
+			if( container.KeyType ) {
+				void* key = container.KeyType->_NewObject();
+				if( key && ReadLeaf( stream, *container.KeyType, key ) )
+					element = const_cast< void* >( container.Find( cursor.Addr, key ) );
+				if( key )
+					container.KeyType->Delete( key );
+			} else if( !container.IsKeyed ) {
+				Uint32 index = 0;
+				if( ReadValue( stream, index ) )
+					element = ElementAt( cursor.Container->Container, cursor.Addr, index );
+			}
+			if( !element )
+				return false;
+
+			cursor.Type = container.ValueType;
+			cursor.Addr = element;
+			cursor.Container = NULL;
+			cursor.IsPointer = container.IsValuePointer;
+			continue;
+		}
+
+		// Step into a field, through the pointer if there is one.
+		if( cursor.IsPointer ) {
+			cursor.Addr = *static_cast< void** >( cursor.Addr );
+			if( !cursor.Addr )
+				return false;
+			cursor.Type = &cursor.Type->_GetObjectType( cursor.Addr );
+			cursor.IsPointer = false;
+		}
+
+		HashValue hash = 0;
+		if( !ReadValue( stream, hash ) )
+			return false;
+
+		const Type::FieldTable& fields = cursor.Type->GetAllFields();
+		const Field* field = NULL;
+		for( size_t i = 0; i < fields.size() && !field; ++i )
+			if( fields[i]->Name.Hash == hash )
+				field = fields[i];
+		if( !field )
+			return false;
+
+		cursor.Addr = field->GetPtr( cursor.Addr );
+		if( field->Container ) {
+			cursor.Container = field;
+		} else {
+			cursor.Type = field->Type;
+			cursor.IsPointer = field->IsPointer;
+		}
+	}
+	return true;
+}
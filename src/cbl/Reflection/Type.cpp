@@ -26,23 +26,88 @@
 
 // Chewable Headers //
 #include "cbl/Reflection/Type.h"
+#include "cbl/Reflection/TypeDB.h"
+#include "cbl/Reflection/EntityManager.h"
+#include "cbl/Reflection/Patch.h"
+#include "cbl/Math/Functions.h"
 
 using namespace cbl;
 
+namespace
+{
+	//! Mix a value into a running hash.
+	inline HashValue CombineHash( HashValue seed, HashValue value )
+	{
+		return seed ^ ( value + 0x9e3779b9 + ( seed << 6 ) + ( seed >> 2 ) );
+	}
+
+	inline HashValue HashBytes( const void* data, size_t size )
+	{
+		return Hash::Generate( static_cast< const Char* >( data ), Int32( size ) );
+	}
+
+	//! Copy an object without fields, through its string form if it can't be assigned.
+	void AssignValue( const Type& type, void* dst, const void* src )
+	{
+		if( type.Assign ) {
+			type.Assign( dst, src );
+		} else if( type.ToString && type.FromString ) {
+			String str;
+			type.ToString( str, &type, src, NULL );
+			type.FromString( str, &type, dst, NULL );
+		}
+	}
+
+	//! Compare objects without fields, through their string form if they have no
+	//! operator ==. Values that have neither can't be compared and are never equal.
+	bool EqualValue( const Type& type, const void* lhs, const void* rhs )
+	{
+		if( type.Equal )
+			return type.Equal( lhs, rhs );
+		if( type.ToString ) {
+			String lhsStr, rhsStr;
+			type.ToString( lhsStr, &type, lhs, NULL );
+			type.ToString( rhsStr, &type, rhs, NULL );
+			return lhsStr == rhsStr;
+		}
+		return false;
+	}
+
+	HashValue HashValueOf( const Type& type, const void* obj )
+	{
+		if( type.ToString ) {
+			String str;
+			type.ToString( str, &type, obj, NULL );
+			return Hash::Generate( str );
+		}
+		return type.IsTrivial ? HashBytes( obj, type.Size ) : 0;
+	}
+}
+
 const EnumConst* Type::GetEnum( cbl::Uint32 value ) const
 {
-	for( size_t i = 0; i < mEnums.size(); ++i )
-		if( mEnums[i].Value == value )
-			return &mEnums[i];
-	return NULL;
+	const EnumIndex& index = _GetEnumIndex();
+	if( !index.Dense.empty() ) {
+		const Uint32 offset = value - index.Min;
+		return offset < index.Dense.size() && index.Dense[offset] ? &mEnums[index.Dense[offset] - 1] : NULL;
+	}
+
+	std::vector< Uint32 >::const_iterator it = std::lower_bound( index.ByValue.begin(), index.ByValue.end(), value,
+		[this]( Uint32 i, Uint32 v ) { return mEnums[i].Value < v; } );
+	return it != index.ByValue.end() && mEnums[*it].Value == value ? &mEnums[*it] : NULL;
 }
 
 const EnumConst* Type::GetEnum( const CName& name ) const 
 {
-	for( size_t i = 0; i < mEnums.size(); ++i )
-		if( mEnums[i].Name == name )
-			return &mEnums[i];
-	return NULL;
+	const EnumIndex& index = _GetEnumIndex();
+	std::unordered_map< HashValue, Uint32 >::const_iterator it = index.ByName.find( name.Hash );
+	return it != index.ByName.end() ? &mEnums[it->second] : NULL;
+}
+
+const EnumConst* Type::GetEnumBit( cbl::Uint32 bit ) const
+{
+	const EnumIndex& index = _GetEnumIndex();
+	return bit < 32 && index.Bits[bit] ? &mEnums[index.Bits[bit] - 1] : NULL;
 }
 
 const Field* Type::GetField( const CName& name ) const
@@ -56,6 +121,7 @@ const Field* Type::GetField( const CName& name ) const
 Type& Type::Enum( const Char* name, Uint32 value )
 {
 	mEnums.push_back( EnumConst( name, value ) );
+	mEnumsIndexed.store( false, std::memory_order_release );
 
 	if( ToString == NULL )
 		ToString = &Stringifiers::ToStringEnum;
@@ -65,6 +131,18 @@ Type& Type::Enum( const Char* name, Uint32 value )
 	return *this;
 }
 
+Type& Type::EnumFlags( void )
+{
+	mEnumFlags = true;
+	return *this;
+}
+
+Type& Type::ReserveFields( Uint32 count )
+{
+	mFields.reserve( mFields.size() + count );
+	return *this;
+}
+
 bool Type::HasFields( void ) const
 {
 	const Type* type = this;
@@ -76,24 +154,491 @@ bool Type::HasFields( void ) const
 	return false;
 }
 
-std::stack<const Type::Fields*> Type::GetAllFields( void ) const
+const Type::FieldTable& Type::GetAllFields( void ) const
 {
-	std::stack<const Type::Fields*> fieldStack;
-	const cbl::Type* type = this;
-	while( type ) {
-		if( type->GetFields().size() > 0 )
-			fieldStack.push( &(type->GetFields()) );
-		type = type->BaseType;
+	const Uint32 version = DB->mFieldsVersion.load( std::memory_order_acquire );
+	if( const FieldTable* table = mAllFields.Get( version ) )
+		return *table;
+
+	std::lock_guard< std::mutex > lock( DB->mLock );
+	if( const FieldTable* table = mAllFields.Get( version ) )
+		return *table;
+
+	// Build a new table rather than refilling the current one, which callers may be iterating.
+	FieldTable* table = new FieldTable;
+	_AppendFields( *table );
+	return mAllFields.Publish( table, version );
+}
+
+void Type::Clone( void* dst, const void* src ) const
+{
+	if( dst == src )
+		return;
+
+	Char* to = static_cast< Char* >( dst );
+	const Char* from = static_cast< const Char* >( src );
+	const MemberOps& ops = _GetMemberOps();
+
+	for( size_t i = 0; i < ops.size(); ++i ) {
+		const MemberOp& op = ops[i];
+		switch( op.Kind ) {
+		case MemberOp::K_BYTES:
+			::memcpy( to + op.Offset, from + op.Offset, op.Size );
+			break;
+		case MemberOp::K_VALUE:
+			AssignValue( *op.Type, to + op.Offset, from + op.Offset );
+			break;
+		case MemberOp::K_POINTER: {
+				void*& ptr = *reinterpret_cast< void** >( to + op.Offset );
+				ptr = _ClonePointer( *op.Type, ptr, *reinterpret_cast< void* const* >( from + op.Offset ) );
+			}
+			break;
+		case MemberOp::K_CONTAINER:
+			_CloneContainer( *op.Field, to + op.Offset, from + op.Offset );
+			break;
+		}
+	}
+}
+
+bool Type::Equals( const void* lhs, const void* rhs ) const
+{
+	if( lhs == rhs )
+		return true;
+
+	const Char* a = static_cast< const Char* >( lhs );
+	const Char* b = static_cast< const Char* >( rhs );
+	const MemberOps& ops = _GetMemberOps();
+
+	for( size_t i = 0; i < ops.size(); ++i ) {
+		const MemberOp& op = ops[i];
+		switch( op.Kind ) {
+		case MemberOp::K_BYTES:
+			if( ::memcmp( a + op.Offset, b + op.Offset, op.Size ) != 0 )
+				return false;
+			break;
+		case MemberOp::K_VALUE:
+			if( !EqualValue( *op.Type, a + op.Offset, b + op.Offset ) )
+				return false;
+			break;
+		case MemberOp::K_POINTER:
+			if( !_EqualPointer( *op.Type, *reinterpret_cast< void* const* >( a + op.Offset ), *reinterpret_cast< void* const* >( b + op.Offset ) ) )
+				return false;
+			break;
+		case MemberOp::K_CONTAINER:
+			if( !_EqualContainer( *op.Field, a + op.Offset, b + op.Offset ) )
+				return false;
+			break;
+		}
+	}
+	return true;
+}
+
+HashValue Type::HashContents( const void* obj ) const
+{
+	const Char* p = static_cast< const Char* >( obj );
+	const MemberOps& ops = _GetMemberOps();
+	HashValue hash = 0;
+
+	for( size_t i = 0; i < ops.size(); ++i ) {
+		const MemberOp& op = ops[i];
+		switch( op.Kind ) {
+		case MemberOp::K_BYTES:
+			hash = CombineHash( hash, HashBytes( p + op.Offset, op.Size ) );
+			break;
+		case MemberOp::K_VALUE:
+			// Plain data containers are assigned and compared whole, but hashed by their values.
+			hash = CombineHash( hash, op.Field ? _HashContainer( *op.Field, p + op.Offset ) : HashValueOf( *op.Type, p + op.Offset ) );
+			break;
+		case MemberOp::K_POINTER:
+			hash = CombineHash( hash, _HashPointer( *op.Type, *reinterpret_cast< void* const* >( p + op.Offset ) ) );
+			break;
+		case MemberOp::K_CONTAINER:
+			hash = CombineHash( hash, _HashContainer( *op.Field, p + op.Offset ) );
+			break;
+		}
+	}
+	return hash;
+}
+
+bool Type::Diff( const void* a, const void* b, Patch& patch ) const
+{
+	return patch._Diff( *this, a, b );
+}
+
+bool Type::Apply( void* obj, const Patch& patch ) const
+{
+	return patch._Apply( *this, obj );
+}
+
+bool Type::IsType( const Type& parent ) const
+{
+	if( &parent == this )
+		return true;
+
+	if( parent.DB == DB ) {
+		if( const TypeDB::Table* table = DB->mTable.load( std::memory_order_acquire ) ) {
+			// Types registered since the table was published are not numbered yet.
+			if( Index < table->Order.size() && parent.Index < table->Order.size() && table->Order[Index].first ) {
+				const std::pair< Uint32, Uint32 >& child = table->Order[Index];
+				const std::pair< Uint32, Uint32 >& base = table->Order[parent.Index];
+				return base.first <= child.first && child.second <= base.second;
+			}
+			for( const Type* p = BaseType; p; p = p->BaseType )
+				if( p == &parent )
+					return true;
+			return false;
+		}
+		DB->_ValidateHierarchy();
+		return parent.mPreOrder <= mPreOrder && mPostOrder <= parent.mPostOrder;
+	}
+	return IsType( parent.Name );
+}
+
+bool Type::IsType( const CName& parent ) const
+{
+	if( parent == Name )
+		return true;
+
+	const Type* type = DB->Get( parent );
+	if( type )
+		return IsType( *type );
+
+	// Not in this database; the base chain may still lead into another one.
+	for( const Type* p = BaseType; p; p = p->BaseType )
+		if( p->Name == parent )
+			return true;
+	return false;
+}
+
+void Type::_FieldsChanged( void )
+{
+	DB->_InvalidateFields();
+}
+
+void Type::_HierarchyChanged( void )
+{
+	DB->_InvalidateHierarchy();
+	// Frozen readers take the hierarchy from the published table, so publish a new one,
+	// unless a registration in progress will.
+	if( DB->IsFrozen() ) {
+		std::lock_guard< std::recursive_mutex > lock( DB->mRegisterLock );
+		if( DB->mRegisterDepth == 0 )
+			DB->_Publish();
+	}
+}
+
+const Type* Type::_GetByIndex( Uint16 index ) const
+{
+	return DB->GetByIndex( index );
+}
+
+const Type::EnumIndex& Type::_GetEnumIndex( void ) const
+{
+	if( !mEnumsIndexed.load( std::memory_order_acquire ) ) {
+		std::lock_guard< std::mutex > lock( DB->mLock );
+		_IndexEnums();
+	}
+	return mEnumIndex;
+}
+
+void Type::_IndexEnums( void ) const
+{
+	if( mEnumsIndexed.load( std::memory_order_relaxed ) )
+		return;
+
+	EnumIndex& index = mEnumIndex;
+	const Uint32 count = Uint32( mEnums.size() );
+	index.ByValue.resize( count );
+	for( Uint32 i = 0; i < count; ++i )
+		index.ByValue[i] = i;
+	// Stable, so the first declared of equal values is found first, as with a scan.
+	std::stable_sort( index.ByValue.begin(), index.ByValue.end(),
+		[this]( Uint32 lhs, Uint32 rhs ) { return mEnums[lhs].Value < mEnums[rhs].Value; } );
+
+	// Index values directly when the table would be at most about twice the constant count.
+	index.Dense.clear();
+	index.Min = count ? mEnums[index.ByValue.front()].Value : 0;
+	const Uint64 range = count ? Uint64( mEnums[index.ByValue.back()].Value ) - index.Min + 1 : 0;
+	if( count && range <= Uint64( count ) * 2 + 8 ) {
+		index.Dense.resize( size_t( range ), 0 );
+		for( Uint32 i = count; i-- > 0; )
+			index.Dense[mEnums[index.ByValue[i]].Value - index.Min] = index.ByValue[i] + 1;
+	}
+
+	memset( index.Bits, 0, sizeof( index.Bits ) );
+	index.ByName.clear();
+	for( Uint32 i = count; i-- > 0; ) {
+		const Uint32 value = mEnums[i].Value;
+		if( value != 0 && ( value & ( value - 1 ) ) == 0 )
+			index.Bits[Math::CountTrailingZeros32( value )] = i + 1;
+		index.ByName[mEnums[i].Name.Hash] = i;
+	}
+
+	mEnumsIndexed.store( true, std::memory_order_release );
+}
+
+const Type::MemberOps& Type::_GetMemberOps( void ) const
+{
+	const Uint32 version = DB->mFieldsVersion.load( std::memory_order_acquire );
+	if( const MemberOps* cached = mMemberOps.Get( version ) )
+		return *cached;
+
+	std::lock_guard< std::mutex > lock( DB->mLock );
+	if( const MemberOps* cached = mMemberOps.Get( version ) )
+		return *cached;
+
+	MemberOps ops;
+	_AppendMemberOps( ops, 0 );
+	std::stable_sort( ops.begin(), ops.end(),
+		[]( const MemberOp& lhs, const MemberOp& rhs ) { return lhs.Offset < rhs.Offset; } );
+
+	// Coalesce adjacent plain data into single memcpy/memcmp ranges.
+	MemberOps* merged = new MemberOps;
+	for( size_t i = 0; i < ops.size(); ++i ) {
+		if( ops[i].Kind == MemberOp::K_BYTES && !merged->empty() ) {
+			MemberOp& last = merged->back();
+			if( last.Kind == MemberOp::K_BYTES && last.Offset + last.Size == ops[i].Offset ) {
+				last.Size += ops[i].Size;
+				continue;
+			}
+		}
+		merged->push_back( ops[i] );
+	}
+	return mMemberOps.Publish( merged, version );
+}
+
+void Type::_AppendMemberOps( MemberOps& ops, size_t offset ) const
+{
+	if( !HasFields() ) {
+		MemberOp op = { IsTrivial ? MemberOp::K_BYTES : MemberOp::K_VALUE, offset, Size, this, NULL };
+		ops.push_back( op );
+		return;
+	}
+
+	// Nested objects are flattened into this list, so their plain data can be
+	// coalesced with the surrounding fields.
+	FieldTable fields;
+	_AppendFields( fields );
+	for( size_t i = 0; i < fields.size(); ++i ) {
+		const cbl::Field& field = *fields[i];
+		if( field.Attributes.Transient != 0 )
+			continue;
+
+		const size_t at = offset + field.Offset;
+		if( field.Container ) {
+			MemberOp op = { MemberOp::K_CONTAINER, at, field.Type->Size, field.Type, &field };
+			if( _IsPlainContainer( *field.Container ) ) {
+				if( field.Type->IsTrivial )
+					op.Kind = MemberOp::K_BYTES;
+				else if( field.Type->Assign && field.Type->Equal )
+					op.Kind = MemberOp::K_VALUE;
+			}
+			ops.push_back( op );
+		} else if( field.IsPointer ) {
+			MemberOp op = { MemberOp::K_POINTER, at, sizeof( void* ), field.Type, &field };
+			ops.push_back( op );
+		} else {
+			field.Type->_AppendMemberOps( ops, at );
+		}
 	}
-	return fieldStack;
+}
+
+bool Type::_IsPlainContainer( const FieldContainer& container )
+{
+	return !container.IsValuePointer && container.ValueType->IsPlain()
+		&& ( !container.KeyType || ( !container.IsKeyPointer && container.KeyType->IsPlain() ) );
+}
+
+bool FieldContainer::IsPlainBlock( void ) const
+{
+	return IsContiguous && !KeyType && !IsValuePointer && ValueType->IsPlain();
+}
+
+void* Type::_NewObject( void ) const
+{
+	return CBL_ENT.New( this );
+}
+
+const Type& Type::_GetObjectType( const void* obj ) const
+{
+	return IsEntity ? static_cast< const Entity* >( obj )->GetType() : *this;
+}
+
+void Type::_CloneContainer( const cbl::Field& field, void* dst, const void* src )
+{
+	const FieldContainer& container = *field.Container;
+	if( container.IsPlainBlock() ) {
+		const Uint32 count = container.GetCount( src );
+		if( container.Resize( dst, count ) ) {
+			if( count > 0 )
+				memcpy( container.GetData( dst ), container.GetData( src ), count * container.Stride );
+			return;
+		}
+	}
+
+	// Pointed to elements are owned by the container, so free them before clearing it.
+	if( container.IsKeyPointer || container.IsValuePointer ) {
+		FieldReadIterator* old = CBL_NEW_FIELD_READIT( field.Container, dst );
+		for( ; old->IsValid(); old->IncNext() ) {
+			if( container.IsKeyPointer )
+				_DeletePointer( *container.KeyType, *static_cast< void* const* >( old->GetKey() ) );
+			if( container.IsValuePointer )
+				_DeletePointer( *container.ValueType, *static_cast< void* const* >( old->GetValue() ) );
+		}
+		CBL_DEL_FIELD_IT( field.Container, old );
+	}
+
+	FieldReadIterator* from = CBL_NEW_FIELD_READIT( field.Container, src );
+	FieldWriteIterator* to = CBL_NEW_FIELD_WRITEIT( field.Container, dst );
+	to->Clear();
+
+	for( ; from->IsValid(); from->IncNext() ) {
+		void* key = NULL;
+		void* value = NULL;
+
+		// Copy into temporaries and add those, as deserialisation does.
+		if( container.KeyType ) {
+			if( container.IsKeyPointer )
+				key = _ClonePointer( *container.KeyType, NULL, *static_cast< void* const* >( from->GetKey() ) );
+			else if( ( key = container.KeyType->_NewObject() ) != NULL )
+				container.KeyType->Clone( key, from->GetKey() );
+		}
+		if( container.IsValuePointer )
+			value = _ClonePointer( *container.ValueType, NULL, *static_cast< void* const* >( from->GetValue() ) );
+		else if( ( value = container.ValueType->_NewObject() ) != NULL )
+			container.ValueType->Clone( value, from->GetValue() );
+
+		if( container.KeyType ) {
+			if( ( key || container.IsKeyPointer ) && ( value || container.IsValuePointer ) )
+				to->Add( container.IsKeyPointer ? (void*)( &key ) : key, container.IsValuePointer ? (void*)( &value ) : value );
+		} else if( value || container.IsValuePointer ) {
+			to->Add( container.IsValuePointer ? (void*)( &value ) : value );
+		}
+
+		if( key && !container.IsKeyPointer )
+			container.KeyType->Delete( key );
+		if( value && !container.IsValuePointer )
+			container.ValueType->Delete( value );
+	}
+
+	CBL_DEL_FIELD_IT( field.Container, to );
+	CBL_DEL_FIELD_IT( field.Container, from );
+}
+
+bool Type::_EqualContainer( const cbl::Field& field, const void* lhs, const void* rhs )
+{
+	const FieldContainer& container = *field.Container;
+	if( container.IsPlainBlock() ) {
+		const Uint32 count = container.GetCount( lhs );
+		return count == container.GetCount( rhs )
+			&& ( count == 0 || memcmp( container.GetData( lhs ), container.GetData( rhs ), count * container.Stride ) == 0 );
+	}
+
+	FieldReadIterator* a = CBL_NEW_FIELD_READIT( field.Container, lhs );
+	FieldReadIterator* b = CBL_NEW_FIELD_READIT( field.Container, rhs );
+	bool equal = a->Count() == b->Count();
+
+	for( ; equal && a->IsValid() && b->IsValid(); a->IncNext(), b->IncNext() ) {
+		if( container.KeyType ) {
+			equal = container.IsKeyPointer
+				? _EqualPointer( *container.KeyType, *static_cast< void* const* >( a->GetKey() ), *static_cast< void* const* >( b->GetKey() ) )
+				: container.KeyType->Equals( a->GetKey(), b->GetKey() );
+		}
+		if( equal ) {
+			equal = container.IsValuePointer
+				? _EqualPointer( *container.ValueType, *static_cast< void* const* >( a->GetValue() ), *static_cast< void* const* >( b->GetValue() ) )
+				: container.ValueType->Equals( a->GetValue(), b->GetValue() );
+		}
+	}
+
+	CBL_DEL_FIELD_IT( field.Container, b );
+	CBL_DEL_FIELD_IT( field.Container, a );
+	return equal;
+}
+
+HashValue Type::_HashContainer( const cbl::Field& field, const void* obj )
+{
+	const FieldContainer& container = *field.Container;
+	if( container.IsPlainBlock() ) {
+		const Uint32 count = container.GetCount( obj );
+		return count > 0 ? CombineHash( count, HashBytes( container.GetData( obj ), count * container.Stride ) ) : count;
+	}
+
+	FieldReadIterator* it = CBL_NEW_FIELD_READIT( field.Container, obj );
+	HashValue hash = it->Count();
+
+	for( ; it->IsValid(); it->IncNext() ) {
+		if( container.KeyType ) {
+			hash = CombineHash( hash, container.IsKeyPointer
+				? _HashPointer( *container.KeyType, *static_cast< void* const* >( it->GetKey() ) )
+				: container.KeyType->HashContents( it->GetKey() ) );
+		}
+		hash = CombineHash( hash, container.IsValuePointer
+			? _HashPointer( *container.ValueType, *static_cast< void* const* >( it->GetValue() ) )
+			: container.ValueType->HashContents( it->GetValue() ) );
+	}
+
+	CBL_DEL_FIELD_IT( field.Container, it );
+	return hash;
+}
+
+void* Type::_ClonePointer( const Type& type, void* dst, const void* src )
+{
+	// The existing object is only reused if it is of the same type; otherwise it is freed.
+	if( dst && ( !src || &type._GetObjectType( dst ) != &type._GetObjectType( src ) ) ) {
+		_DeletePointer( type, dst );
+		dst = NULL;
+	}
+	if( !src )
+		return NULL;
+
+	const Type& actual = type._GetObjectType( src );
+	if( !dst )
+		dst = actual._NewObject();
+	if( dst )
+		actual.Clone( dst, src );
+	return dst;
+}
+
+void Type::_DeletePointer( const Type& type, void* obj )
+{
+	if( obj )
+		type._GetObjectType( obj ).Delete( obj );
+}
+
+bool Type::_EqualPointer( const Type& type, const void* lhs, const void* rhs )
+{
+	if( lhs == rhs )
+		return true;
+	if( !lhs || !rhs )
+		return false;
+
+	const Type& actual = type._GetObjectType( lhs );
+	return &actual == &type._GetObjectType( rhs ) && actual.Equals( lhs, rhs );
+}
+
+HashValue Type::_HashPointer( const Type& type, const void* obj )
+{
+	if( !obj )
+		return 0;
+
+	const Type& actual = type._GetObjectType( obj );
+	return CombineHash( actual.Name.Hash, actual.HashContents( obj ) );
+}
+
+void Type::_AppendFields( FieldTable& table ) const
+{
+	if( BaseType )
+		BaseType->_AppendFields( table );
+	for( size_t i = 0; i < mFields.size(); ++i )
+		table.push_back( &mFields[i] );
 }
 
 void Stringifiers::ToStringEnum( String& str, const Type* type, const void* obj, const FieldAttr* attr )
 {
 	if( attr && attr->Hex != 0 ) {
-		std::ostringstream o;
-		o << std::hex << std::showbase << *(const Uint32*)obj;
-		str = o.str();
+		Char buf[CharConv::MaxChars];
+		str.assign( buf, CharConv::ToChars( buf, Uint64( *(const Uint32*)obj ), true ) );
 		return;
 	}
 
@@ -102,17 +647,37 @@ void Stringifiers::ToStringEnum( String& str, const Type* type, const void* obj,
 		return;
 	}
 
-	if( const EnumConst* e = type->GetEnum( (*(Uint32*)obj) ) )
+	const Uint32 value = *(const Uint32*)obj;
+	if( const EnumConst* e = type->GetEnum( value ) ) {
 		str = e->Name.Text;
-	else
-		str = "";
+		return;
+	}
+
+	str.clear();
+	if( !type->HasEnumFlags() )
+		return;
+
+	// Name each set bit, leaving bits without a name for a hex remainder.
+	Uint32 rest = value;
+	for( Uint32 bits = value; bits != 0; bits &= bits - 1 ) {
+		const Uint32 bit = Math::CountTrailingZeros32( bits );
+		if( const EnumConst* e = type->GetEnumBit( bit ) ) {
+			if( !str.empty() ) str += '|';
+			str += e->Name.Text;
+			rest &= ~( 1u << bit );
+		}
+	}
+	if( rest != 0 ) {
+		Char buf[CharConv::MaxChars];
+		if( !str.empty() ) str += '|';
+		str.append( buf, CharConv::ToChars( buf, Uint64( rest ), true ) );
+	}
 }
 
 void Stringifiers::FromStringEnum( const String& str, const Type* type, void* obj, const FieldAttr* attr )
 {
 	if( attr && attr->Hex != 0 ) {
-		std::istringstream i( str );
-		i >> std::hex >> (*(Uint32*)obj);
+		CharConv::Parse( str.c_str(), str.c_str() + str.length(), *(Uint32*)obj, true );
 		return;
 	}
 
@@ -121,8 +686,36 @@ void Stringifiers::FromStringEnum( const String& str, const Type* type, void* ob
 		return;
 	}
 
-	if( const EnumConst* e = type->GetEnum( CName(str.c_str()) ) )
-		*(Uint32*)obj = e->Value;
+	if( !type->HasEnumFlags() ) {
+		if( const EnumConst* e = type->GetEnum( CName(str.c_str()) ) )
+			*(Uint32*)obj = e->Value;
+		return;
+	}
+
+	// Or together names and numbers separated by '|'. Unknown names leave the value unchanged.
+	Uint32 value = 0;
+	const Char* p = str.c_str();
+	const Char* end = p + str.length();
+	while( p < end ) {
+		const Char* next = std::find( p, end, '|' );
+		const Char* last = next;
+		while( p < last && isspace( Uchar( *p ) ) ) ++p;
+		while( last > p && isspace( Uchar( last[-1] ) ) ) --last;
+
+		Uint32 bits = 0;
+		const bool hex = last - p > 2 && p[0] == '0' && ( p[1] == 'x' || p[1] == 'X' );
+		if( p < last && ( hex || isdigit( Uchar( *p ) ) ) ) {
+			if( CharConv::Parse( p, last, bits, hex ) != Uint32( last - p ) )
+				return;
+		} else if( const EnumConst* e = type->GetEnum( CName( Hash::Generate( p, Int32( last - p ) ) ) ) ) {
+			bits = e->Value;
+		} else if( p < last ) {
+			return;
+		}
+		value |= bits;
+		p = next + 1;
+	}
+	*(Uint32*)obj = value;
 }
 
 template<>
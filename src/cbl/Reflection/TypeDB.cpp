@@ -27,10 +27,39 @@
 
 // Chewable Headers //
 #include "cbl/Reflection/TypeDB.h"
+#include "cbl/Debug/Assert.h"
+#include "cbl/Util/Stopwatch.h"
 
 using namespace cbl;
 
-TypeDB::TypeDB()
+namespace
+{
+	std::mutex	sTypeIndexLock;						//!< Guards assigning type indices.
+	Uint16		sNextTypeIndex = InvalidTypeIndex;	//!< Last assigned type index.
+}
+
+Uint16 cbl::detail::AssignTypeIndex( std::atomic<Uint16>& slot )
+{
+	std::lock_guard< std::mutex > lock( sTypeIndexLock );
+	Uint16 index = slot.load( std::memory_order_relaxed );
+	if( index == InvalidTypeIndex ) {
+		CBL_ASSERT( sNextTypeIndex < 0xFFFF, "Out of type indices." );
+		index = ++sNextTypeIndex;
+		slot.store( index, std::memory_order_relaxed );
+	}
+	return index;
+}
+
+TypeDB::TypeDB( Allocator& allocator )
+: mTypes( 0, TypeMap::hasher(), TypeMap::key_equal(), allocator )
+, mTypeList( allocator )
+, mFieldsVersion( 1 )
+, mHierarchyValid( false )
+, mTable( NULL )
+, mRegisterDepth( 0 )
+, mModulesRun( 0 )
+, mModulesPending( false )
+, mModulesRunning( false )
 {
 	Create<Int8>().DefaultSerialisers<Int8>();
 	Create<Int16>().DefaultSerialisers<Int16>();
@@ -50,7 +79,158 @@ TypeDB::TypeDB()
 
 TypeDB::~TypeDB()
 {
+	mTable.store( NULL, std::memory_order_relaxed );
+	for( size_t i = 0; i < mTables.size(); ++i )
+		CBL_DELETE( mTables[i] );
+	mTables.clear();
+
+	// Types live in the storage arena, which frees their memory.
 	CBL_FOREACH( TypeMap, it, mTypes )
-		CBL_DELETE( it->second );
+		it->second->~Type();
 	mTypes.clear();
+	mTypeList.clear();
+}
+
+void TypeDB::Freeze( void )
+{
+	RegisterModules();
+	Finalise();
+	std::lock_guard< std::recursive_mutex > lock( mRegisterLock );
+	if( !IsFrozen() )
+		_Publish();
+}
+
+void TypeDB::_Publish( void )
+{
+	// Readers may still hold the previous table, so it is kept rather than freed.
+	Table* table = new Table;
+	table->ByIndex.assign( mTypeList.begin(), mTypeList.end() );
+	table->ByName.reserve( mTypes.size() );
+	CBL_FOREACH( TypeMap, it, mTypes )
+		table->ByName.insert( std::make_pair( it->first, it->second ) );
+	// Numbered here rather than on the types, which frozen readers never see change.
+	_NumberTypes( table->Order );
+
+	mTables.push_back( table );
+	mTable.store( table, std::memory_order_release );
+}
+
+void TypeDB::Finalise( void )
+{
+	// Keep late registration from changing mTypes while it is walked.
+	std::lock_guard< std::recursive_mutex > registerLock( mRegisterLock );
+	std::lock_guard< std::mutex > lock( mLock );
+	CBL_FOREACH( TypeMap, it, mTypes )
+		it->second->_IndexEnums();
+	// Once frozen, IsType reads the numbers in the published table instead.
+	if( IsFrozen() || mHierarchyValid.load( std::memory_order_relaxed ) )
+		return;
+
+	std::vector< std::pair< Uint32, Uint32 > > order;
+	_NumberTypes( order );
+	CBL_FOREACH( TypeMap, it, mTypes ) {
+		Type* type = it->second;
+		type->mPreOrder = order[type->Index].first;
+		type->mPostOrder = order[type->Index].second;
+	}
+
+	mHierarchyValid.store( true, std::memory_order_release );
+}
+
+void TypeDB::_NumberTypes( std::vector< std::pair< Uint32, Uint32 > >& order ) const
+{
+	std::unordered_multimap< const Type*, const Type* > children;
+	std::vector< const Type* > roots;
+	CBL_FOREACH_CONST( TypeMap, it, mTypes ) {
+		const Type* type = it->second;
+		if( type->BaseType && type->BaseType->DB == this )
+			children.insert( std::make_pair( type->BaseType, type ) );
+		else
+			roots.push_back( type );
+	}
+
+	// Each type's interval encloses the intervals of all of its derived types.
+	order.assign( mTypeList.size(), std::make_pair( Uint32( 0 ), Uint32( 0 ) ) );
+	Uint32 counter = 1;
+	for( size_t i = 0; i < roots.size(); ++i )
+		_Number( roots[i], children, counter, order );
+}
+
+void TypeDB::_Number( const Type* type, const std::unordered_multimap< const Type*, const Type* >& children,
+	Uint32& counter, std::vector< std::pair< Uint32, Uint32 > >& order ) const
+{
+	const Uint32 pre = counter++;
+	typedef std::unordered_multimap< const Type*, const Type* >::const_iterator ChildIterator;
+	std::pair< ChildIterator, ChildIterator > range = children.equal_range( type );
+	for( ChildIterator it = range.first; it != range.second; ++it )
+		_Number( it->second, children, counter, order );
+	if( type->Index < order.size() )
+		order[type->Index] = std::make_pair( pre, counter++ );
+}
+
+void TypeDB::_SetIndex( Uint16 index, Type* type )
+{
+	if( index >= mTypeList.size() )
+		mTypeList.resize( index + 1, NULL );
+	mTypeList[index] = type;
+}
+
+void TypeDB::AddModule( RegisterFunc func )
+{
+	std::lock_guard< std::recursive_mutex > lock( mRegisterLock );
+	if( std::find( mModules.begin(), mModules.end(), func ) != mModules.end() )
+		return;
+	mModules.push_back( func );
+	mModulesPending.store( true, std::memory_order_release );
+}
+
+void TypeDB::RegisterModules( void )
+{
+	std::lock_guard< std::recursive_mutex > lock( mRegisterLock );
+	// Modules create types, which land back here; only the outermost call runs them.
+	if( mModulesRunning || !mModulesPending.load( std::memory_order_acquire ) )
+		return;
+
+	Stopwatch timer;
+	timer.Start();
+	mModulesRunning = true;
+	++mRegisterDepth;
+	// A module may add further modules, which run in the same pass.
+	while( mModulesRun < mModules.size() )
+		mModules[mModulesRun++]( *this );
+	mModulesRunning = false;
+	timer.Stop();
+	mRegisterTime += timer.GetElapsedTime();
+
+	if( --mRegisterDepth == 0 && IsFrozen() )
+		_Publish();
+	// Only now, so lookups that miss meanwhile wait on the lock for the types.
+	mModulesPending.store( false, std::memory_order_release );
+}
+
+TypeDB::RegistrationStats TypeDB::GetRegistrationStats( void ) const
+{
+	std::lock_guard< std::recursive_mutex > lock( const_cast< TypeDB* >( this )->mRegisterLock );
+	RegistrationStats stats;
+	stats.Types			= Uint32( mTypes.size() );
+	stats.Fields		= 0;
+	CBL_FOREACH_CONST( TypeMap, it, mTypes )
+		stats.Fields	+= Uint32( it->second->GetFields().size() );
+	stats.Modules		= Uint32( mModulesRun );
+	stats.Tables		= Uint32( mTables.size() );
+	stats.StorageBytes	= mStorage.GetUsed();
+	stats.RegisterTime	= mRegisterTime;
+	return stats;
+}
+
+void* TypeDB::Storage::Allocate( size_t size, size_t align )
+{
+	std::lock_guard< std::mutex > lock( mLock );
+	return mArena.Allocate( size, align );
+}
+
+size_t TypeDB::Storage::GetUsed( void ) const
+{
+	std::lock_guard< std::mutex > lock( mLock );
+	return mArena.GetUsed();
 }
@@ -27,6 +27,9 @@
 // Chewable Headers //
 #include "cbl/Serialisation/BinaryDeserialiser.h"
 
+// External Dependencies //
+#include <limits>
+
 using namespace cbl;
 
 bool BinaryDeserialiser::IsStreamEnded( void ) const
@@ -135,6 +138,52 @@ BinaryDeserialiser::StreamPtr BinaryDeserialiser::OnValue( StreamPtr s, const Ty
 	return s;
 }
 
+BinaryDeserialiser::StreamPtr BinaryDeserialiser::OnValueBlock( StreamPtr s, const FieldContainer& container, void* obj, Uint32 count )
+{
+	// Streams written value by value start with the useStr byte instead.
+	std::istream& in = *(std::istream*)s;
+	if( !container.ValueType->FromString || in.peek() != BinarySerialiser::ValueBlockMarker )
+		return s;
+	in.get();
+
+	// Don't size the container for more values than the stream holds.
+	const std::streamsize size = container.ValueType->Size;
+	const std::streampos start = in.tellg();
+	if( start != std::streampos( -1 ) ) {
+		in.seekg( 0, std::ios_base::end );
+		const std::streamoff left = in.tellg() - start;
+		in.seekg( start );
+		if( std::streamoff( count ) * size > left ) {
+			in.setstate( std::ios_base::failbit );
+			return NULL;
+		}
+	}
+
+	// Fixed size containers are read from the front, others are appended to.
+	Uint32 offset = 0,
+		   fit = count;
+	if( container.IsFixedSize ) {
+		fit = std::min( count, container.GetCount( obj ) );
+	} else {
+		offset = container.GetCount( obj );
+		if( count > std::numeric_limits< Uint32 >::max() - offset || !container.Resize( obj, offset + count ) ) {
+			in.setstate( std::ios_base::failbit );
+			return NULL;
+		}
+	}
+
+	// A short read leaves the stream failed, so deserialisation stops.
+	in.read( (Char*)container.GetData( obj ) + offset * size, std::streamsize( fit ) * size );
+	if( in.gcount() != std::streamsize( fit ) * size ) {
+		if( !container.IsFixedSize )
+			container.Resize( obj, offset );
+		in.setstate( std::ios_base::failbit );
+		return NULL;
+	}
+	in.ignore( std::streamsize( count - fit ) * size );
+	return NULL;
+}
+
 void BinaryDeserialiser::OnStreamSet( void )
 {
 }
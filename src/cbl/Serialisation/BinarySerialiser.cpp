@@ -29,6 +29,8 @@
 
 using namespace cbl;
 
+const Uchar BinarySerialiser::ValueBlockMarker;
+
 BinarySerialiser::StreamPtr BinarySerialiser::Initialise( StreamPtr s, const Type*, const void* )
 {
 	return s;
@@ -86,6 +88,17 @@ BinarySerialiser::StreamPtr BinarySerialiser::OnValue( StreamPtr s, const Type*
 	return s;
 }
 
+BinarySerialiser::StreamPtr BinarySerialiser::OnValueBlock( StreamPtr s, const Type* type, const void* data, Uint32 count )
+{
+	// Values that can't be written on their own are left to the per value path.
+	if( !type->ToString )
+		return s;
+
+	(*(std::ostream*)s).write( (const Char*)(&ValueBlockMarker), sizeof( Uchar ) );
+	(*(std::ostream*)s).write( (const Char*)(data), std::streamsize( count ) * type->Size );
+	return NULL;
+}
+
 void BinarySerialiser::OnStreamSet( void )
 {
 }
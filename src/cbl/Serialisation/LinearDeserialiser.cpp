@@ -56,7 +56,7 @@ StreamPtr LinearDeserialiser::DoDeserialise( StreamPtr s, const Type* type, void
 		if( !t ) {
 			LOG_ERROR( "Unable to determine type for " << type->Name.Text << "." );
 			type = NULL;
-		} else if( !t->IsType( type->Name.Text ) ) {
+		} else if( !t->IsType( *type ) ) {
 			LOG_ERROR( t->Name.Text << " is not a type of " << type->Name.Text );
 			type = NULL;
 		} else {
@@ -81,76 +81,75 @@ StreamPtr LinearDeserialiser::DoDeserialise( StreamPtr s, const Type* type, void
 		return NULL;
 	current = next;
 
-	std::stack<const Type::Fields*> fieldStack = type->GetAllFields();
-
-	while( !fieldStack.empty() && ( opt != Entity::O_IGNORE_FIELDS ) )
-	{
-		for( size_t i = 0; i < fieldStack.top()->size(); ++i ) {
-			const Field& field = (*fieldStack.top())[i];
-			// Serialize container.
-			if( field.Attributes.Transient != 0 )
-				continue;
-
-			// Get a pointer to the data member.
-			void* dataPtr = field.IsPointer ? *((void**)field.GetPtr( obj )) : field.GetPtr( obj );
-
-			if( field.Container ) { // Try to serialize if container
-				const Type* keyType = field.Container->KeyType;
-				const Type* valType = field.Container->ValueType;
-				cbl::Uint32 size = 0;
-
-				if( cbl::FieldWriteIterator* it = CBL_NEW_FIELD_WRITEIT( field.Container, dataPtr ) ) {
-					next = OnContainer( current, size );
-					INCREMENT_STREAM_PTR;
-					bool keyInferType = field.Container->IsKeyPointer && keyType && keyType->IsEntity;
-					bool valInferType = field.Container->IsValuePointer && valType->IsEntity;
-
-					for( cbl::Uint32 j = 0; j < size; ++j ) {
-						void	*newKey = NULL,
-								*newVal = NULL;
-
-						if( keyType ) {
-							next = DoDeserialise( current, keyType, newKey, &field.Attributes, keyInferType );
-							INCREMENT_STREAM_PTR;
-						}
-						next = DoDeserialise( current, valType, newVal, &field.Attributes, valInferType );
+	const Type::FieldTable& fields = type->GetAllFields();
+
+	for( size_t i = 0; opt != Entity::O_IGNORE_FIELDS && i < fields.size(); ++i ) {
+		const Field& field = *fields[i];
+		// Serialize container.
+		if( field.Attributes.Transient != 0 )
+			continue;
+
+		// Get a pointer to the data member.
+		void* dataPtr = field.IsPointer ? *((void**)field.GetPtr( obj )) : field.GetPtr( obj );
+
+		if( field.Container ) { // Try to serialize if container
+			const Type* keyType = field.Container->KeyType;
+			const Type* valType = field.Container->ValueType;
+			cbl::Uint32 size = 0;
+
+			if( cbl::FieldWriteIterator* it = CBL_NEW_FIELD_WRITEIT( field.Container, dataPtr ) ) {
+				next = OnContainer( current, size );
+				INCREMENT_STREAM_PTR;
+				bool keyInferType = field.Container->IsKeyPointer && keyType && keyType->IsEntity;
+				bool valInferType = field.Container->IsValuePointer && valType->IsEntity;
+				// Plain data laid out in one block may be read in a single call.
+				bool read = size > 0 && field.Container->IsPlainBlock()
+					&& !OnValueBlock( current, *field.Container, dataPtr, size );
+
+				for( cbl::Uint32 j = 0; !read && j < size; ++j ) {
+					void	*newKey = NULL,
+							*newVal = NULL;
+
+					if( keyType ) {
+						next = DoDeserialise( current, keyType, newKey, &field.Attributes, keyInferType );
 						INCREMENT_STREAM_PTR;
-
-						if( newKey && newVal ) {
-							it->Add(
-								field.Container->IsKeyPointer ? (void*)(&newKey) : newKey,
-								field.Container->IsValuePointer ? (void*)(&newVal) : newVal
-								);
-						} else {
-							it->Add( field.Container->IsValuePointer ? (void*)(&newVal) : newVal );
-						}
-
-						if( newKey && !field.Container->IsKeyPointer ) {
-							if( keyType->IsEntity )	CBL_ENT.Delete( (EntityPtr)newKey );
-							else					keyType->Delete( newKey );
-						}
-						if( newVal && !field.Container->IsValuePointer ) {
-							if( valType->IsEntity )	CBL_ENT.Delete( (EntityPtr)newVal );
-							else					valType->Delete( newVal );
-						}
 					}
-					CBL_DEL_FIELD_IT( field.Container, it );
-				}
-			} else {
-				// Otherwise just deserialize as per normal.
-				if( field.IsPointer ) {
-					void* newObj = NULL;
-					next = DoDeserialise( current, field.Type, newObj, &field.Attributes, field.Type->IsEntity );
-					INCREMENT_STREAM_PTR;
-					*((void**)field.GetPtr( obj )) = newObj;
-				}
-				else {
-					next = DoDeserialise( current, field.Type, dataPtr, &field.Attributes, false );
+					next = DoDeserialise( current, valType, newVal, &field.Attributes, valInferType );
 					INCREMENT_STREAM_PTR;
+
+					if( newKey && newVal ) {
+						it->Add(
+							field.Container->IsKeyPointer ? (void*)(&newKey) : newKey,
+							field.Container->IsValuePointer ? (void*)(&newVal) : newVal
+							);
+					} else {
+						it->Add( field.Container->IsValuePointer ? (void*)(&newVal) : newVal );
+					}
+
+					if( newKey && !field.Container->IsKeyPointer ) {
+						if( keyType->IsEntity )	CBL_ENT.Delete( (EntityPtr)newKey );
+						else					keyType->Delete( newKey );
+					}
+					if( newVal && !field.Container->IsValuePointer ) {
+						if( valType->IsEntity )	CBL_ENT.Delete( (EntityPtr)newVal );
+						else					valType->Delete( newVal );
+					}
 				}
+				CBL_DEL_FIELD_IT( field.Container, it );
+			}
+		} else {
+			// Otherwise just deserialize as per normal.
+			if( field.IsPointer ) {
+				void* newObj = NULL;
+				next = DoDeserialise( current, field.Type, newObj, &field.Attributes, field.Type->IsEntity );
+				INCREMENT_STREAM_PTR;
+				*((void**)field.GetPtr( obj )) = newObj;
+			}
+			else {
+				next = DoDeserialise( current, field.Type, dataPtr, &field.Attributes, false );
+				INCREMENT_STREAM_PTR;
 			}
 		}
-		fieldStack.pop();
 	}
 
 	if( type->IsEntity )
@@ -58,65 +58,64 @@ StreamPtr LinearSerialiser::DoSerialise( StreamPtr s, const Type* type, const vo
 		return NULL;
 	mStream = next;
 
-	std::stack<const Type::Fields*> fieldStack = type->GetAllFields();
-
-	while( !fieldStack.empty() && ( opt != Entity::O_IGNORE_FIELDS ) )
-	{
-		for( size_t i = 0; i < fieldStack.top()->size(); ++i ) {
-			const Field& field = (*fieldStack.top())[i];
-			// Serialize container.
-			if( field.Attributes.Transient != 0 )
-				continue;
-
-			// Get a pointer to the data member.
-			const void* dataPtr = field.IsPointer ? *((const void**)field.GetPtr( obj )) : field.GetPtr( obj );
-
-			if( field.Container ) { // Try to serialize if container
-				const Type* keyType = field.Container->KeyType;
-				const Type* valType = field.Container->ValueType;
-
-				bool keyEntity = keyType ? keyType->IsEntity : false;
-				bool valEntity = valType->IsEntity;
-
-				const void
-					*keyPtr = NULL,
-					*valPtr = NULL;
-				const Type
-					*keyEntryType	= NULL,
-					*valEntryType	= NULL;
-
-				// Work on the container.
-				{
-					cbl::FieldReadIterator* it = CBL_NEW_FIELD_READIT( field.Container, dataPtr );
-					next = OnContainer( mStream, it->Count() );
-					INCREMENT_STREAM_PTR;
-					bool keyOutType = field.Container->IsKeyPointer && keyType && keyType->IsEntity;
-					bool valOutType = field.Container->IsValuePointer && valType->IsEntity;
-
-					for( ; it->IsValid(); it->IncNext() ) {
-						if( keyType ) {
-							keyPtr			= field.Container->IsKeyPointer ? *(const void**)it->GetKey() : it->GetKey();
-							keyEntryType	= keyEntity && &((EntityPtr)keyPtr)->GetType() ? &((EntityPtr)keyPtr)->GetType() : keyType;
-						}
-						valPtr			= field.Container->IsValuePointer ? *(const void**)it->GetValue() : it->GetValue();
-						valEntryType	= valEntity && &((EntityPtr)valPtr)->GetType() ? &((EntityPtr)valPtr)->GetType() : valType;
-
-						if( keyType ) {
-							next = DoSerialise( mStream, keyEntryType, keyPtr, &field.Attributes, keyOutType );
-							INCREMENT_STREAM_PTR;
-						}
-
-						next = DoSerialise( mStream, valEntryType, valPtr, &field.Attributes, valOutType );
+	const Type::FieldTable& fields = type->GetAllFields();
+
+	for( size_t i = 0; opt != Entity::O_IGNORE_FIELDS && i < fields.size(); ++i ) {
+		const Field& field = *fields[i];
+		// Serialize container.
+		if( field.Attributes.Transient != 0 )
+			continue;
+
+		// Get a pointer to the data member.
+		const void* dataPtr = field.IsPointer ? *((const void**)field.GetPtr( obj )) : field.GetPtr( obj );
+
+		if( field.Container ) { // Try to serialize if container
+			const Type* keyType = field.Container->KeyType;
+			const Type* valType = field.Container->ValueType;
+
+			bool keyEntity = keyType ? keyType->IsEntity : false;
+			bool valEntity = valType->IsEntity;
+
+			const void
+				*keyPtr = NULL,
+				*valPtr = NULL;
+			const Type
+				*keyEntryType	= NULL,
+				*valEntryType	= NULL;
+
+			// Work on the container.
+			{
+				cbl::FieldReadIterator* it = CBL_NEW_FIELD_READIT( field.Container, dataPtr );
+				next = OnContainer( mStream, it->Count() );
+				INCREMENT_STREAM_PTR;
+				bool keyOutType = field.Container->IsKeyPointer && keyType && keyType->IsEntity;
+				bool valOutType = field.Container->IsValuePointer && valType->IsEntity;
+				// Plain data laid out in one block may be written in a single call.
+				bool written = it->IsValid() && field.Container->IsPlainBlock()
+					&& !OnValueBlock( mStream, valType, field.Container->GetData( dataPtr ), it->Count() );
+
+				for( ; !written && it->IsValid(); it->IncNext() ) {
+					if( keyType ) {
+						keyPtr			= field.Container->IsKeyPointer ? *(const void**)it->GetKey() : it->GetKey();
+						keyEntryType	= keyEntity && &((EntityPtr)keyPtr)->GetType() ? &((EntityPtr)keyPtr)->GetType() : keyType;
+					}
+					valPtr			= field.Container->IsValuePointer ? *(const void**)it->GetValue() : it->GetValue();
+					valEntryType	= valEntity && &((EntityPtr)valPtr)->GetType() ? &((EntityPtr)valPtr)->GetType() : valType;
+
+					if( keyType ) {
+						next = DoSerialise( mStream, keyEntryType, keyPtr, &field.Attributes, keyOutType );
 						INCREMENT_STREAM_PTR;
+					}
+
+					next = DoSerialise( mStream, valEntryType, valPtr, &field.Attributes, valOutType );
+					INCREMENT_STREAM_PTR;
 
-					} CBL_DEL_FIELD_IT( field.Container, it );
-				} 
-			} else {
-				const Type* ftype = field.Type->IsEntity && &((EntityPtr)dataPtr)->GetType() ? &((EntityPtr)dataPtr)->GetType() : field.Type;
-				next = DoSerialise( mStream, ftype, dataPtr, &field.Attributes, field.IsPointer && field.Type->IsEntity );
-			}
+				} CBL_DEL_FIELD_IT( field.Container, it );
+			} 
+		} else {
+			const Type* ftype = field.Type->IsEntity && &((EntityPtr)dataPtr)->GetType() ? &((EntityPtr)dataPtr)->GetType() : field.Type;
+			next = DoSerialise( mStream, ftype, dataPtr, &field.Attributes, field.IsPointer && field.Type->IsEntity );
 		}
-		fieldStack.pop();
 	}
 
 	if( type->IsEntity )
@@ -48,7 +48,7 @@ TreeDeserialiser::StreamPtr TreeDeserialiser::DoDeserialise( StreamPtr s, const
 				if( !t ) {
 					LOG_ERROR( typeStr << " is not a valid type" );
 					type = NULL;
-				} else if( !t->IsType( type->Name.Text ) ) {
+				} else if( !t->IsType( *type ) ) {
 					LOG_ERROR( t->Name.Text << " is not a type of " << type->Name.Text );
 					type = NULL;
 				} else {
@@ -76,101 +76,97 @@ TreeDeserialiser::StreamPtr TreeDeserialiser::DoDeserialise( StreamPtr s, const
 	if( !b_val )
 		return s;
 
-	std::stack<const Type::Fields*> fieldStack = type->GetAllFields();
+	const Type::FieldTable& fields = type->GetAllFields();
 
-	if( !fieldStack.empty() && ( opt != Entity::O_IGNORE_FIELDS ) ) {
+	if( !fields.empty() && ( opt != Entity::O_IGNORE_FIELDS ) ) {
 		// Begin field serialisation.
 		StreamPtr b_fields = BeginFields( b_val );
-		while( !fieldStack.empty() )
-		{
-			for( size_t i = 0; i < fieldStack.top()->size(); ++i ) {
-				const Field& field = (*fieldStack.top())[i];
-				// Serialize container.
-				if( field.Attributes.Transient != 0 )
-					continue;
-
-				StreamPtr b_field = BeginField( b_fields, &field );
-				// Check if the field is in there.
-				if( !b_field )
-					continue;
-
-				// Get a pointer to the data member.
-				void* dataPtr = field.IsPointer ? *((void**)field.GetPtr( obj )) : field.GetPtr( obj );
-
-				if( field.Container ) { // Try to serialize if container
-					const Type* keyType = field.Container->KeyType;
-					const Type* valType = field.Container->ValueType;
-
-					String keyStr, valStr;
-
-					if( cbl::FieldWriteIterator* it = CBL_NEW_FIELD_WRITEIT( field.Container, dataPtr ) ) {
-						while( StreamPtr b_cont_entry = BeginContainerEntry( b_field, keyType, valType ) ) {
-							void *newKey = NULL,
-								 *newVal = NULL;
-
-							StreamPtr	key_stream = keyType ? GetContainerKeyStream( b_cont_entry ) : NULL,
-										val_stream = GetContainerValueStream( b_cont_entry, keyType != NULL );
-
-							const Type* actualKey = NULL;
-							const Type* actualVal = NULL;
-
-							if( key_stream )
-								actualKey = GetValueType( key_stream, keyStr ) && keyStr.length() > 0 ? CBL_ENT.Types.Get( CName( keyStr.c_str() ) ) : keyType;
-							actualVal = GetValueType( val_stream, valStr ) && valStr.length() > 0 ? CBL_ENT.Types.Get( CName( valStr.c_str() ) ) : valType;
-
-							if( !actualVal ) {
-								LOG_ERROR( valStr << " is not a valid type" );
-							} else if( !actualVal->IsType( valType->Name ) ) {
-								LOG( LogLevel::Warning << actualVal->Name.Text << " is not a type of " << valType->Name.Text );
-							} else {
-								if( keyType ) {
-									if( !actualKey ) {
-										LOG_ERROR( keyStr << " is not a valid type" );
-									} else if( !actualKey->IsType( keyType->Name ) ) {
-										LOG( LogLevel::Warning << actualKey->Name.Text << " is not a type of " << keyType->Name.Text );
-									} else {
-										DoDeserialise( key_stream, actualKey, newKey, &field.Attributes, false );
-										DoDeserialise( val_stream, actualVal, newVal, &field.Attributes, false );
-										if( newKey && newVal ) {
-											it->Add(
-												field.Container->IsKeyPointer ? (void*)(&newKey) : newKey,
-												field.Container->IsValuePointer ? (void*)(&newVal) : newVal
-												);
-										}
-									}
+		for( size_t i = 0; i < fields.size(); ++i ) {
+			const Field& field = *fields[i];
+			// Serialize container.
+			if( field.Attributes.Transient != 0 )
+				continue;
+
+			StreamPtr b_field = BeginField( b_fields, &field );
+			// Check if the field is in there.
+			if( !b_field )
+				continue;
+
+			// Get a pointer to the data member.
+			void* dataPtr = field.IsPointer ? *((void**)field.GetPtr( obj )) : field.GetPtr( obj );
+
+			if( field.Container ) { // Try to serialize if container
+				const Type* keyType = field.Container->KeyType;
+				const Type* valType = field.Container->ValueType;
+
+				String keyStr, valStr;
+
+				if( cbl::FieldWriteIterator* it = CBL_NEW_FIELD_WRITEIT( field.Container, dataPtr ) ) {
+					while( StreamPtr b_cont_entry = BeginContainerEntry( b_field, keyType, valType ) ) {
+						void *newKey = NULL,
+							 *newVal = NULL;
+
+						StreamPtr	key_stream = keyType ? GetContainerKeyStream( b_cont_entry ) : NULL,
+									val_stream = GetContainerValueStream( b_cont_entry, keyType != NULL );
+
+						const Type* actualKey = NULL;
+						const Type* actualVal = NULL;
+
+						if( key_stream )
+							actualKey = GetValueType( key_stream, keyStr ) && keyStr.length() > 0 ? CBL_ENT.Types.Get( CName( keyStr.c_str() ) ) : keyType;
+						actualVal = GetValueType( val_stream, valStr ) && valStr.length() > 0 ? CBL_ENT.Types.Get( CName( valStr.c_str() ) ) : valType;
+
+						if( !actualVal ) {
+							LOG_ERROR( valStr << " is not a valid type" );
+						} else if( !actualVal->IsType( *valType ) ) {
+							LOG( LogLevel::Warning << actualVal->Name.Text << " is not a type of " << valType->Name.Text );
+						} else {
+							if( keyType ) {
+								if( !actualKey ) {
+									LOG_ERROR( keyStr << " is not a valid type" );
+								} else if( !actualKey->IsType( *keyType ) ) {
+									LOG( LogLevel::Warning << actualKey->Name.Text << " is not a type of " << keyType->Name.Text );
 								} else {
+									DoDeserialise( key_stream, actualKey, newKey, &field.Attributes, false );
 									DoDeserialise( val_stream, actualVal, newVal, &field.Attributes, false );
-									if( newVal )
-										it->Add( field.Container->IsValuePointer ? (void*)(&newVal) : newVal );
+									if( newKey && newVal ) {
+										it->Add(
+											field.Container->IsKeyPointer ? (void*)(&newKey) : newKey,
+											field.Container->IsValuePointer ? (void*)(&newVal) : newVal
+											);
+									}
 								}
+							} else {
+								DoDeserialise( val_stream, actualVal, newVal, &field.Attributes, false );
+								if( newVal )
+									it->Add( field.Container->IsValuePointer ? (void*)(&newVal) : newVal );
 							}
+						}
 
-							if( newKey && !field.Container->IsKeyPointer ) {
-								if( actualKey->IsEntity )	CBL_ENT.Delete( (EntityPtr)newKey );
-								else						actualKey->Delete( newKey );
-							}
-							if( newVal && !field.Container->IsValuePointer ) {
-								if( actualVal->IsEntity )	CBL_ENT.Delete( (EntityPtr)newVal );
-								else						actualVal->Delete( newVal );
-							}
-							EndContainerEntry( b_field, keyType, valType );
+						if( newKey && !field.Container->IsKeyPointer ) {
+							if( actualKey->IsEntity )	CBL_ENT.Delete( (EntityPtr)newKey );
+							else						actualKey->Delete( newKey );
 						}
-						CBL_DEL_FIELD_IT( field.Container, it );
-					}
-				} else { // Otherwise just deserialize as per normal.
-					if( field.IsPointer ) {
-						void* newObj = NULL;
-						DoDeserialise( b_field, field.Type, newObj, &field.Attributes, true );
-						*((void**)field.GetPtr( obj )) = newObj;
-					}
-					else {
-						DoDeserialise( b_field, field.Type, dataPtr, &field.Attributes, false );
+						if( newVal && !field.Container->IsValuePointer ) {
+							if( actualVal->IsEntity )	CBL_ENT.Delete( (EntityPtr)newVal );
+							else						actualVal->Delete( newVal );
+						}
+						EndContainerEntry( b_field, keyType, valType );
 					}
+					CBL_DEL_FIELD_IT( field.Container, it );
+				}
+			} else { // Otherwise just deserialize as per normal.
+				if( field.IsPointer ) {
+					void* newObj = NULL;
+					DoDeserialise( b_field, field.Type, newObj, &field.Attributes, true );
+					*((void**)field.GetPtr( obj )) = newObj;
+				}
+				else {
+					DoDeserialise( b_field, field.Type, dataPtr, &field.Attributes, false );
 				}
-
-				EndField( b_fields, &field );
 			}
-			fieldStack.pop();
+
+			EndField( b_fields, &field );
 		}
 
 		EndFields( b_val );
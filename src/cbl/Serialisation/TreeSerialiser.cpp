@@ -48,74 +48,70 @@ TreeSerialiser::StreamPtr TreeSerialiser::DoSerialise( StreamPtr s, const Type*
 	// Serialise the object.
 	StreamPtr b_val = BeginValue( s, type, obj, attr, opt, outputType );
 
-	std::stack<const Type::Fields*> fieldStack = type->GetAllFields();
+	const Type::FieldTable& fields = type->GetAllFields();
 
-	if( b_val && !fieldStack.empty() && ( opt != Entity::O_IGNORE_FIELDS ) ) {
+	if( b_val && !fields.empty() && ( opt != Entity::O_IGNORE_FIELDS ) ) {
 		// Begin field serialisation.
 		if( StreamPtr b_fields = BeginFields( b_val ) ) {
-			while( !fieldStack.empty() )
-			{
-				for( size_t i = 0; i < fieldStack.top()->size(); ++i ) {
-					const Field& field = (*fieldStack.top())[i];
-					// Don't serialise if transient.
-					if( field.Attributes.Transient != 0 )
-						continue;
-			
-					if( StreamPtr b_field = BeginField( b_fields, &field ) ) {
-						// Get a pointer to the data member.
-						const void* dataPtr = field.IsPointer ? *((const void**)field.GetPtr( obj )) : field.GetPtr( obj );
-
-						if( field.Container ) { // Try to serialize if container
-							const Type* keyType = field.Container->KeyType;
-							const Type* valType = field.Container->ValueType;
-
-							bool keyEntity = keyType ? keyType->IsEntity : false;
-							bool valEntity = valType->IsEntity;
-
-							const void
-								*keyPtr = NULL,
-								*valPtr = NULL;
-							const Type
-								*keyEntryType	= NULL,
-								*valEntryType	= NULL;
-							bool keyDerived = false,
-								valDerived = false;
-
-							CBL_FOREACH_READ_FIELD_BEGIN( field.Container, it, dataPtr ) {
-								if( keyType ) {
-									keyPtr			= field.Container->IsKeyPointer ? *(const void**)it->GetKey() : it->GetKey();
-									keyEntryType	= keyEntity && &((EntityPtr)keyPtr)->GetType() ? &((EntityPtr)keyPtr)->GetType() : keyType;
-									keyDerived		= field.Container->IsKeyPointer && keyEntryType != keyType;
-								}
-								valPtr			= field.Container->IsValuePointer ? *(const void**)it->GetValue() : it->GetValue();
-								valEntryType	= valEntity && &((EntityPtr)valPtr)->GetType() ? &((EntityPtr)valPtr)->GetType() : valType;
-								valDerived		= field.Container->IsValuePointer && valEntryType != valType;
-
-								StreamPtr b_cont_entry = BeginContainerEntry( b_field, keyEntryType, valEntryType );
-
-								if( keyType ) {
-									DoSerialise(
-										BeginContainerKey( b_cont_entry, keyEntryType ), keyEntryType, keyPtr, &field.Attributes, keyDerived
-									);
-									EndContainerKey( b_cont_entry, keyEntryType );
-								}
-
+			for( size_t i = 0; i < fields.size(); ++i ) {
+				const Field& field = *fields[i];
+				// Don't serialise if transient.
+				if( field.Attributes.Transient != 0 )
+					continue;
+		
+				if( StreamPtr b_field = BeginField( b_fields, &field ) ) {
+					// Get a pointer to the data member.
+					const void* dataPtr = field.IsPointer ? *((const void**)field.GetPtr( obj )) : field.GetPtr( obj );
+
+					if( field.Container ) { // Try to serialize if container
+						const Type* keyType = field.Container->KeyType;
+						const Type* valType = field.Container->ValueType;
+
+						bool keyEntity = keyType ? keyType->IsEntity : false;
+						bool valEntity = valType->IsEntity;
+
+						const void
+							*keyPtr = NULL,
+							*valPtr = NULL;
+						const Type
+							*keyEntryType	= NULL,
+							*valEntryType	= NULL;
+						bool keyDerived = false,
+							valDerived = false;
+
+						CBL_FOREACH_READ_FIELD_BEGIN( field.Container, it, dataPtr ) {
+							if( keyType ) {
+								keyPtr			= field.Container->IsKeyPointer ? *(const void**)it->GetKey() : it->GetKey();
+								keyEntryType	= keyEntity && &((EntityPtr)keyPtr)->GetType() ? &((EntityPtr)keyPtr)->GetType() : keyType;
+								keyDerived		= field.Container->IsKeyPointer && keyEntryType != keyType;
+							}
+							valPtr			= field.Container->IsValuePointer ? *(const void**)it->GetValue() : it->GetValue();
+							valEntryType	= valEntity && &((EntityPtr)valPtr)->GetType() ? &((EntityPtr)valPtr)->GetType() : valType;
+							valDerived		= field.Container->IsValuePointer && valEntryType != valType;
+
+							StreamPtr b_cont_entry = BeginContainerEntry( b_field, keyEntryType, valEntryType );
+
+							if( keyType ) {
 								DoSerialise(
-									BeginContainerValue( b_cont_entry, keyEntryType, valEntryType ), valEntryType, valPtr, &field.Attributes, valDerived
+									BeginContainerKey( b_cont_entry, keyEntryType ), keyEntryType, keyPtr, &field.Attributes, keyDerived
 								);
-								EndContainerValue( b_cont_entry, keyEntryType, valEntryType );
+								EndContainerKey( b_cont_entry, keyEntryType );
+							}
+
+							DoSerialise(
+								BeginContainerValue( b_cont_entry, keyEntryType, valEntryType ), valEntryType, valPtr, &field.Attributes, valDerived
+							);
+							EndContainerValue( b_cont_entry, keyEntryType, valEntryType );
 
-								EndContainerEntry( b_field, keyEntryType, valEntryType );
+							EndContainerEntry( b_field, keyEntryType, valEntryType );
 
-							} CBL_FOREACH_FIELD_END( field.Container, it );
+						} CBL_FOREACH_FIELD_END( field.Container, it );
 
-						} else { // Otherwise just serialize as per normal.
-							const Type* ftype = field.Type->IsEntity && &((EntityPtr)dataPtr)->GetType() ? &((EntityPtr)dataPtr)->GetType() : field.Type;
-							DoSerialise( b_field, ftype, dataPtr, &field.Attributes, field.IsPointer && field.Type != ftype );
-						}
-					} EndField( b_fields, &field );
-				}
-				fieldStack.pop();
+					} else { // Otherwise just serialize as per normal.
+						const Type* ftype = field.Type->IsEntity && &((EntityPtr)dataPtr)->GetType() ? &((EntityPtr)dataPtr)->GetType() : field.Type;
+						DoSerialise( b_field, ftype, dataPtr, &field.Attributes, field.IsPointer && field.Type != ftype );
+					}
+				} EndField( b_fields, &field );
 			}
 		} EndFields( b_val );
 	}
@@ -0,0 +1,136 @@
+/* This source file is part of the Chewable Framework.
+ * For the latest info, please visit http://chewable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file WorkerPool.cpp
+ * @brief Fixed-size pool of worker threads for fork-join style jobs.
+ */
+
+// Precompiled Headers //
+#include "cbl/StdAfx.h"
+
+// Chewable Headers //
+#include "cbl/Thread/WorkerPool.h"
+
+using namespace cbl;
+
+namespace
+{
+	//! Set while the current thread is running a job batch.
+	thread_local bool sInJob = false;
+}
+
+WorkerPool::WorkerPool()
+: mFunc( NULL )
+, mContext( NULL )
+, mCount( 0 )
+, mBatchSize( 1 )
+, mNext( 0 )
+, mGeneration( 0 )
+, mActive( 0 )
+, mShutdown( false )
+{
+	// The calling thread always takes part in a job, so leave one core for it.
+	Uint32 cores = std::thread::hardware_concurrency();
+	Uint32 workers = cores > 1 ? cores - 1 : 0;
+
+	mWorkers.reserve( workers );
+	for( Uint32 i = 0; i < workers; ++i )
+		mWorkers.push_back( std::thread( &WorkerPool::WorkerMain, this ) );
+}
+
+WorkerPool::~WorkerPool()
+{
+	{
+		std::lock_guard< std::mutex > lock( mLock );
+		mShutdown = true;
+	}
+	mWake.notify_all();
+
+	CBL_FOREACH( ThreadList, it, mWorkers )
+		if( it->joinable() )
+			it->join();
+}
+
+void WorkerPool::ParallelFor( Uint32 count, Uint32 batchSize, RangeFunc func, void* context )
+{
+	if( count == 0 )
+		return;
+	if( batchSize == 0 )
+		batchSize = 1;
+
+	// Not worth waking anyone, or we're already inside a job.
+	if( mWorkers.empty() || count <= batchSize || sInJob ) {
+		func( context, 0, count );
+		return;
+	}
+
+	std::lock_guard< std::mutex > jobLock( mJobLock );
+	{
+		std::lock_guard< std::mutex > lock( mLock );
+		mFunc		= func;
+		mContext	= context;
+		mCount		= count;
+		mBatchSize	= batchSize;
+		mNext		= 0;
+		mActive		= Uint32( mWorkers.size() );
+		++mGeneration;
+	}
+	mWake.notify_all();
+
+	sInJob = true;
+	RunBatches();
+	sInJob = false;
+
+	// Join: every worker must have left the job before its state is replaced.
+	std::unique_lock< std::mutex > lock( mLock );
+	mDone.wait( lock, [this] { return mActive == 0; } );
+}
+
+void WorkerPool::WorkerMain( void )
+{
+	Uint32 generation = 0;
+	for( ;; ) {
+		{
+			std::unique_lock< std::mutex > lock( mLock );
+			mWake.wait( lock, [&] { return mShutdown || mGeneration != generation; } );
+			if( mShutdown )
+				return;
+			generation = mGeneration;
+		}
+
+		sInJob = true;
+		RunBatches();
+		sInJob = false;
+
+		std::lock_guard< std::mutex > lock( mLock );
+		if( --mActive == 0 )
+			mDone.notify_one();
+	}
+}
+
+void WorkerPool::RunBatches( void )
+{
+	for( ;; ) {
+		Uint32 begin = mNext.fetch_add( mBatchSize );
+		if( begin >= mCount )
+			break;
+		Uint32 end = begin + mBatchSize < mCount ? begin + mBatchSize : mCount;
+		mFunc( mContext, begin, end );
+	}
+}
@@ -28,45 +28,65 @@
 #include "cbl/Util/ByteStream.h"
 #include "cbl/Debug/Assert.h"
 #include "cbl/Debug/Logging.h"
+#include "cbl/Memory/MemBudget.h"
 
 using namespace cbl;
 
+namespace
+{
+	const Uint32 sMinSize = 4096;	//!< Initial buffer size.
+
+	//! Get the allocator for stream buffers.
+	inline Allocator& GetBudget( void )
+	{
+		return MemBudget::Get( MemCategory::Serialisation );
+	}
+}
+
 ByteStream::ByteStream()
 : mBytes( NULL )
 , mSize( 0 )
-, mMaxSize( 4096 )
+, mMaxSize( 0 )
 , mStartMarker( 0 )
+, mFailed( false )
 {
-	mBytes = new Char[ mMaxSize ];
+	Reallocate( sMinSize );
 }
 
 ByteStream::~ByteStream()
 {
-	CBL_DELETE_ARRAY( mBytes );
+	GetBudget().Deallocate( mBytes, mMaxSize, 1 );
 }
 
 ByteStream::ByteStream( const Char * buffer, Int32 size )
 	: mBytes( NULL ),
-	mSize( size ),
-	mMaxSize( 4096 ),
-	mStartMarker( 0 )
+	mSize( 0 ),
+	mMaxSize( 0 ),
+	mStartMarker( 0 ),
+	mFailed( false )
 {
-	while( mMaxSize < mSize )
-		mMaxSize *= 2;
+	Uint32 maxSize = sMinSize;
+	while( maxSize < Uint32( size ) )
+		maxSize *= 2;
 
-	mBytes = new Char[ mMaxSize ];
-	memcpy( mBytes, buffer, size );
+	if( Reallocate( maxSize ) ) {
+		memcpy( mBytes, buffer, size );
+		mSize = size;
+	}
 }
 
 ByteStream::ByteStream( const ByteStream & rhs )
 	: mBytes( NULL ),
-	mSize( rhs.mSize ),
-	mMaxSize( rhs.mMaxSize ),
-	mStartMarker( 0 )
+	mSize( 0 ),
+	mMaxSize( 0 ),
+	mStartMarker( 0 ),
+	mFailed( false )
 {
-	mBytes = new Char[ mMaxSize ];
-	memset( mBytes, 0, mMaxSize );
-	memcpy( mBytes, rhs.mBytes + rhs.mStartMarker, mSize );
+	if( Reallocate( rhs.mMaxSize > 0 ? rhs.mMaxSize : sMinSize ) ) {
+		memset( mBytes, 0, mMaxSize );
+		memcpy( mBytes, rhs.mBytes + rhs.mStartMarker, rhs.mSize );
+		mSize = rhs.mSize;
+	}
 }
 
 const Char * ByteStream::GetBytes() const
@@ -79,8 +99,13 @@ void ByteStream::Write( const Char * src, Uint32 size )
 	Uint32 newSize = mSize + size;
 	if( mStartMarker + newSize > mMaxSize )
 		Compress();
-	if( newSize > mMaxSize )
-		Reallocate( mMaxSize * 2 );
+	if( newSize > mMaxSize ) {
+		Uint32 maxSize = mMaxSize > 0 ? mMaxSize * 2 : sMinSize;
+		while( maxSize < newSize )
+			maxSize *= 2;
+		if( !Reallocate( maxSize ) )
+			return;
+	}
 
 	memcpy( mBytes + mStartMarker + mSize, src, size );
 	mSize = newSize;
@@ -118,6 +143,7 @@ void ByteStream::Clear( void )
 {
 	mStartMarker = 0;
 	mSize = 0;
+	mFailed = false;
 }
 
 ByteStream & ByteStream::operator = ( const ByteStream & rhs )
@@ -141,14 +167,19 @@ void ByteStream::Compress( void )
 	mStartMarker = 0;
 }
 
-void ByteStream::Reallocate( Uint32 size )
+bool ByteStream::Reallocate( Uint32 size )
 {
-	mMaxSize = size;
-	Char * tmp = new Char[ mMaxSize ];
-	memcpy( tmp, mBytes, mSize );
+	Char * tmp = static_cast< Char* >( GetBudget().Allocate( size, 1 ) );
+	if( !tmp ) {
+		mFailed = true;
+		return false;
+	}
 
-	CBL_DELETE_ARRAY( mBytes );
+	if( mBytes ) memcpy( tmp, mBytes, mSize );
+	GetBudget().Deallocate( mBytes, mMaxSize, 1 );
 	mBytes = tmp;
+	mMaxSize = size;
+	return true;
 }
 
 template<>
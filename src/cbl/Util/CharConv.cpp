@@ -0,0 +1,211 @@
+/* This source file is part of the Chewable Framework.
+ * For the latest info, please visit http://chewable.googlecode.com/
+ *
+ * Copyright (c) 2009-2012 Ryan Chew
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file CharConv.cpp
+ * @brief Locale independent number to text conversion into caller buffers.
+ */
+
+// Precompiled Headers //
+#include "cbl/StdAfx.h"
+
+// Chewable Headers //
+#include "cbl/Util/CharConv.h"
+
+// External Dependencies //
+#include <clocale>
+
+using namespace cbl;
+
+namespace
+{
+	//! Longest float text FromChars accepts.
+	static const Uint32 MaxFloatChars = 128;
+
+	//! Decimal point of the C locale used by snprintf and strtod.
+	inline Char LocalePoint( void )
+	{
+		return *localeconv()->decimal_point;
+	}
+
+	inline const Char* SkipSpace( const Char* first, const Char* last )
+	{
+		while( first != last && isspace( Uchar( *first ) ) ) ++first;
+		return first;
+	}
+
+	//! Read digits into a magnitude.
+	//! @return		End of the digits, or first if there were none or they overflowed.
+	const Char* ReadDigits( const Char* first, const Char* last, Uint64& value, bool hex )
+	{
+		const Uint64 base = hex ? 16 : 10;
+		Uint64 v = 0;
+		const Char* p = first;
+		for( ; p != last; ++p ) {
+			Uint32 digit;
+			if( *p >= '0' && *p <= '9' )				digit = *p - '0';
+			else if( hex && *p >= 'a' && *p <= 'f' )	digit = *p - 'a' + 10;
+			else if( hex && *p >= 'A' && *p <= 'F' )	digit = *p - 'A' + 10;
+			else										break;
+
+			if( v > ( ULLONG_MAX - digit ) / base )
+				return first;
+			v = v * base + digit;
+		}
+		value = v;
+		return p;
+	}
+
+	inline Char* StrToFloat( const Char* str, Float32& value )
+	{
+		Char* end = NULL;
+		value = strtof( str, &end );
+		return end;
+	}
+
+	inline Char* StrToFloat( const Char* str, Float64& value )
+	{
+		Char* end = NULL;
+		value = strtod( str, &end );
+		return end;
+	}
+
+	template< typename FLOAT >
+	Uint32 ParseFloat( const Char* first, const Char* last, FLOAT& value )
+	{
+		const Char* p = SkipSpace( first, last );
+		const Uint32 length = Uint32( last - p );
+		if( length == 0 || length >= MaxFloatChars )
+			return 0;
+
+		// Copy into a terminated buffer, using the decimal point strtod expects.
+		Char buf[MaxFloatChars];
+		const Char point = LocalePoint();
+		for( Uint32 i = 0; i < length; ++i )
+			buf[i] = p[i] == '.' ? point : p[i];
+		buf[length] = '\0';
+
+		FLOAT v = 0;
+		const Char* end = StrToFloat( buf, v );
+		if( end == buf )
+			return 0;
+		value = v;
+		return Uint32( ( p - first ) + ( end - buf ) );
+	}
+
+	//! Interim shortest round-trip formatting through the C library, see ToChars.
+	template< typename FLOAT >
+	Uint32 FormatFloat( Char* buf, FLOAT value, int minDigits, int maxDigits )
+	{
+		// Try the short forms first; most values read back from them.
+		int length = 0;
+		for( int digits = minDigits; digits <= maxDigits; ++digits ) {
+			length = snprintf( buf, CharConv::MaxChars, "%.*g", digits, Float64( value ) );
+			FLOAT back = 0;
+			StrToFloat( buf, back );
+			if( digits == maxDigits || back == value )
+				break;
+		}
+
+		const Char point = LocalePoint();
+		if( point != '.' ) {
+			for( int i = 0; i < length; ++i )
+				if( buf[i] == point ) buf[i] = '.';
+		}
+		return Uint32( length );
+	}
+}
+
+Uint32 CharConv::ToChars( Char* buf, Uint64 value, bool hex )
+{
+	if( value == 0 ) {
+		buf[0] = '0';
+		return 1;
+	}
+
+	// Write the digits backwards, then move them into place.
+	static const Char digits[] = "0123456789abcdef";
+	Char tmp[MaxChars];
+	Char* p = tmp + MaxChars;
+	const Uint64 base = hex ? 16 : 10;
+	for( ; value != 0; value /= base )
+		*--p = digits[value % base];
+	if( hex ) {
+		*--p = 'x';
+		*--p = '0';
+	}
+
+	const Uint32 length = Uint32( tmp + MaxChars - p );
+	memcpy( buf, p, length );
+	return length;
+}
+
+Uint32 CharConv::ToChars( Char* buf, Int64 value )
+{
+	if( value >= 0 )
+		return ToChars( buf, Uint64( value ) );
+
+	buf[0] = '-';
+	return 1 + ToChars( buf + 1, Uint64( 0 ) - Uint64( value ) );
+}
+
+Uint32 CharConv::ToChars( Char* buf, Float32 value )
+{
+	return FormatFloat( buf, value, 6, 9 );
+}
+
+Uint32 CharConv::ToChars( Char* buf, Float64 value )
+{
+	return FormatFloat( buf, value, 15, 17 );
+}
+
+Uint32 CharConv::FromChars( const Char* first, const Char* last, Uint64& value, bool hex )
+{
+	const Char* p = SkipSpace( first, last );
+	if( hex && last - p > 2 && p[0] == '0' && ( p[1] == 'x' || p[1] == 'X' ) )
+		p += 2;
+
+	const Char* end = ReadDigits( p, last, value, hex );
+	return end == p ? 0 : Uint32( end - first );
+}
+
+Uint32 CharConv::FromChars( const Char* first, const Char* last, Int64& value )
+{
+	const Char* p = SkipSpace( first, last );
+	const bool negative = p != last && *p == '-';
+	if( p != last && ( *p == '-' || *p == '+' ) )
+		++p;
+
+	Uint64 magnitude = 0;
+	const Char* end = ReadDigits( p, last, magnitude, false );
+	if( end == p || magnitude > Uint64( LLONG_MAX ) + ( negative ? 1 : 0 ) )
+		return 0;
+
+	value = negative ? Int64( Uint64( 0 ) - magnitude ) : Int64( magnitude );
+	return Uint32( end - first );
+}
+
+Uint32 CharConv::FromChars( const Char* first, const Char* last, Float32& value )
+{
+	return ParseFloat( first, last, value );
+}
+
+Uint32 CharConv::FromChars( const Char* first, const Char* last, Float64& value )
+{
+	return ParseFloat( first, last, value );
+}